@@ -3,6 +3,8 @@
 #include "print.hpp"
 #include "system.hpp"
 #include "symbol.hpp"
+#include "math.hpp"
+#include "charconv.hpp"
 
 #include <tuple>
 #include <limits>
@@ -35,7 +37,7 @@ namespace eosio {
        */
       static constexpr int64_t max_amount    = (1LL << 62) - 1;
 
-      asset() {}
+      constexpr asset() {}
 
       /**
        * Construct a new asset given the symbol name and the amount
@@ -43,11 +45,70 @@ namespace eosio {
        * @param a - The amount of the asset
        * @param s - The name of the symbol
        */
-      asset( int64_t a, class symbol s )
+      constexpr asset( int64_t a, class symbol s )
       :amount(a),symbol{s}
       {
-         eosio::check( is_amount_within_range(), "magnitude of asset amount must be less than 2^62" );
-         eosio::check( symbol.is_valid(),        "invalid symbol name" );
+         if( !is_amount_within_range() ) {
+            eosio::check( false, "magnitude of asset amount must be less than 2^62" );
+         }
+         if( !symbol.is_valid() ) {
+            eosio::check( false, "invalid symbol name" );
+         }
+      }
+
+      /**
+       * Construct a new asset from its string representation, e.g. "1.0000 EOS"
+       *
+       * @details The precision of the symbol is the number of digits after the decimal point.
+       * Usable in constant expressions, where a malformed string is a compile error.
+       * @param str - The amount and the symbol code separated by a single space
+       */
+      constexpr explicit asset( std::string_view str )
+      {
+         const auto space = str.find( ' ' );
+         if( space == std::string_view::npos ) {
+            eosio::check( false, "asset string must contain an amount and a symbol code" );
+         }
+         auto digits = str.substr( 0, space );
+         const bool negative = !digits.empty() && digits[0] == '-';
+         if( negative ) {
+            digits.remove_prefix( 1 );
+         }
+         if( digits.empty() || digits[0] == '.' ) {
+            eosio::check( false, "asset amount is missing" );
+         }
+
+         uint64_t magnitude = 0;
+         uint8_t  precision = 0;
+         bool     fraction  = false;
+         for( char c : digits ) {
+            if( c == '.' ) {
+               if( fraction ) {
+                  eosio::check( false, "asset amount has more than one decimal point" );
+               }
+               fraction = true;
+               continue;
+            }
+            if( c < '0' || c > '9' ) {
+               eosio::check( false, "invalid character in asset amount" );
+            }
+            if( fraction && ++precision > symbol::max_precision ) {
+               eosio::check( false, "asset precision must be at most 18" );
+            }
+            if( magnitude > (uint64_t(max_amount) - (c - '0')) / 10 ) {
+               eosio::check( false, "magnitude of asset amount must be less than 2^62" );
+            }
+            magnitude = magnitude * 10 + (c - '0');
+         }
+         if( fraction && precision == 0 ) {
+            eosio::check( false, "missing decimal fraction after decimal point" );
+         }
+
+         amount = negative ? -int64_t(magnitude) : int64_t(magnitude);
+         symbol = eosio::symbol{ symbol_code{ str.substr(space + 1) }, precision };
+         if( !symbol.is_valid() ) {
+            eosio::check( false, "invalid symbol name" );
+         }
       }
 
       /**
@@ -56,7 +117,7 @@ namespace eosio {
        * @return true - if the amount doesn't exceed the max amount
        * @return false - otherwise
        */
-      bool is_amount_within_range()const { return -max_amount <= amount && amount <= max_amount; }
+      constexpr bool is_amount_within_range()const { return -max_amount <= amount && amount <= max_amount; }
 
       /**
        * Check if the asset is valid. %A valid asset has its amount <= max_amount and its symbol name valid
@@ -152,10 +213,14 @@ namespace eosio {
        * @post The amount of this asset is multiplied by a
        */
       asset& operator*=( int64_t a ) {
-         int128_t tmp = (int128_t)amount * (int128_t)a;
-         eosio::check( tmp <= max_amount, "multiplication overflow" );
-         eosio::check( tmp >= -max_amount, "multiplication underflow" );
-         amount = (int64_t)tmp;
+         const bool negative = (amount < 0) != (a < 0);
+         uint64_t hi = 0;
+         uint64_t lo = 0;
+         detail::umul64( detail::magnitude(amount), detail::magnitude(a), hi, lo );
+         const bool in_range = hi == 0 && lo <= uint64_t(max_amount);
+         eosio::check( in_range || negative, "multiplication overflow" );
+         eosio::check( in_range || !negative, "multiplication underflow" );
+         amount = negative ? -int64_t(lo) : int64_t(lo);
          return *this;
       }
 
@@ -215,6 +280,54 @@ namespace eosio {
          return result;
       }
 
+      /**
+       * Multiply the amount by a ratio, computing `amount * numerator / denominator` exactly
+       *
+       * @details The intermediate product is never truncated, so fees and exchange rates can be applied
+       * without a `uint128_t` round trip. See eosio::mul_div.
+       * @param numerator - The numerator of the ratio
+       * @param denominator - The denominator of the ratio
+       * @param mode - Rounding applied to an inexact result
+       * @return asset - New asset with the same symbol holding the scaled amount
+       * @pre The result must be within the range of max_amount
+       *
+       * Example:
+       * @code
+       * asset fee = quantity.mul_div( 30, 10000, rounding::up ); // 0.3% fee, rounded in favor of the contract
+       * @endcode
+       */
+      asset mul_div( int64_t numerator, int64_t denominator, rounding mode = rounding::toward_zero )const {
+         asset result = *this;
+         result.amount = eosio::mul_div( amount, numerator, denominator, mode );
+         eosio::check( result.is_amount_within_range(), "mul_div result out of range" );
+         return result;
+      }
+
+      /**
+       * Scale an asset by the ratio of two other assets, computing `a * b / c` exactly
+       *
+       * @details Typical use is an exchange rate: converting `a` using a pair of reserves where `c` is
+       * denominated like `a` and `b` is denominated in the output symbol.
+       * @param a - The asset to scale
+       * @param b - The numerator, its symbol becomes the symbol of the result
+       * @param c - The denominator
+       * @param mode - Rounding applied to an inexact result
+       * @return asset - New asset with the symbol of b
+       * @pre a and c must have the same symbol
+       *
+       * Example:
+       * @code
+       * asset out = mul_div( in, reserve_out, reserve_in );
+       * @endcode
+       */
+      friend asset mul_div( const asset& a, const asset& b, const asset& c, rounding mode = rounding::toward_zero ) {
+         eosio::check( a.symbol == c.symbol, "attempt to divide assets with different symbols" );
+         asset result = b;
+         result.amount = eosio::mul_div( a.amount, b.amount, c.amount, mode );
+         eosio::check( result.is_amount_within_range(), "mul_div result out of range" );
+         return result;
+      }
+
       /**
        * Division operator, with another asset
        *
@@ -312,41 +425,63 @@ namespace eosio {
          return a.amount >= b.amount;
       }
 
+      /**
+       *  Writes the asset as a string to the provided char buffer
+       *
+       *  @brief Writes the asset as a string to the provided char buffer, without allocating
+       *  @pre The range [begin, end) must be a valid range of memory to write to
+       *  @param begin - The start of the char buffer
+       *  @param end - Just past the end of the char buffer
+       *  @return char* - Just past the end of the last character written (returns begin if the buffer is too small)
+       *  @post On success the range [begin, returned pointer) contains e.g. "-1.0000 EOS", at most max_string_size characters
+       */
+      char* write_as_string( char* begin, char* end )const {
+         const uint8_t precision = symbol.precision();
+         eosio::check( precision <= symbol::max_precision, "asset precision must be at most 18" );
+
+         const uint64_t p10       = pow10( precision );
+         const uint64_t magnitude = detail::magnitude( amount );
+         const uint64_t whole     = magnitude / p10;
+         const uint64_t fraction  = magnitude - whole * p10;
+
+         const uint32_t whole_digits = detail::count_digits( whole );
+
+         char code[7];
+         const auto code_end = symbol.code().write_as_string( code, code + sizeof(code) );
+         const size_t size = (amount < 0) + whole_digits + (precision ? precision + 1 : 0) + 1 + (code_end - code);
+         if( size_t(end - begin) < size )
+            return begin;
+
+         char* out = begin;
+         if( amount < 0 )
+            *out++ = '-';
+         out += whole_digits;
+         detail::write_digits( out, whole, whole_digits );
+         if( precision ) {
+            *out++ = '.';
+            out += precision;
+            detail::write_digits( out, fraction, precision );
+         }
+         *out++ = ' ';
+         for( const char* c = code; c != code_end; ++c )
+            *out++ = *c;
+         return out;
+      }
+
+      /**
+       * Upper bound on the number of characters written by write_as_string()
+       */
+      static constexpr size_t max_string_size = 1 + 19 + 1 + symbol::max_precision + 1 + 7;
+
       /**
        * %asset to std::string
        *
        * @brief %asset to std::string
        */
       std::string to_string()const {
-         int64_t p = (int64_t)symbol.precision();
-         int64_t p10 = 1;
-         bool negative = false;
-         int64_t invert = 1;
-
-         while( p > 0  ) {
-            p10 *= 10; --p;
-         }
-         p = (int64_t)symbol.precision();
-
-         char fraction[p+1];
-         fraction[p] = '\0';
-
-         if (amount < 0) {
-            invert = -1;
-            negative = true;
-         }
-
-         auto change = (amount % p10) * invert;
-
-         for( int64_t i = p -1; i >= 0; --i ) {
-            fraction[i] = (change % 10) + '0';
-            change /= 10;
-         }
-         char str[p+32];
-         const char* fmt = negative ? "-%lld.%s %s" : "%lld.%s %s";
-         snprintf(str, sizeof(str), fmt,
-               (int64_t)(amount/p10), fraction, symbol.code().to_string().c_str());
-         return {str};
+         char buffer[max_string_size];
+         auto end = write_as_string( buffer, buffer + sizeof(buffer) );
+         return {buffer, end};
       }
 
       /**
@@ -355,7 +490,9 @@ namespace eosio {
        * @brief %Print the asset
        */
       void print()const {
-         eosio::print(to_string());
+         char buffer[max_string_size];
+         auto end = write_as_string( buffer, buffer + sizeof(buffer) );
+         prints_l( buffer, (end-buffer) );
       }
 
       EOSLIB_SERIALIZE( asset, (amount)(symbol) )
@@ -490,3 +627,17 @@ namespace eosio {
 
 /// @} asset type
 }
+
+/**
+ * %asset literal operator
+ *
+ * @brief "1.0000 EOS"_a is a shortcut for asset{"1.0000 EOS"}, evaluated at compile time
+ */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+template <typename T, T... Str>
+inline constexpr eosio::asset operator""_a() {
+   constexpr auto x = eosio::asset{std::string_view{eosio::detail::to_const_char_arr<Str...>::value, sizeof...(Str)}};
+   return x;
+}
+#pragma clang diagnostic pop
@@ -0,0 +1,146 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+#include "math.hpp"
+
+namespace eosio {
+
+   /**
+    *  @addtogroup charconv Integer Formatting C++ API
+    *  @ingroup cpp_api
+    *  @brief Allocation free decimal formatting of 8 to 128 bit integers
+    *
+    *  @details Digits are produced two at a time from a 200 byte table, so a 64-bit value needs at most ten
+    *  divisions by 100. 128-bit values are split into 10^19 chunks with the 64-bit only division of math.hpp,
+    *  which keeps `__udivti3` out of the binary.
+    *  @{
+    */
+
+   namespace detail {
+      static constexpr char digit_pairs[201] =
+         "00010203040506070809"
+         "10111213141516171819"
+         "20212223242526272829"
+         "30313233343536373839"
+         "40414243444546474849"
+         "50515253545556575859"
+         "60616263646566676869"
+         "70717273747576777879"
+         "80818283848586878889"
+         "90919293949596979899";
+
+      /**
+       * Number of decimal digits of v, at least 1
+       */
+      constexpr uint32_t count_digits( uint64_t v ) {
+         uint32_t n = 1;
+         while( n < 20 && v >= pow10_table[n] )
+            ++n;
+         return n;
+      }
+
+      /**
+       * Write the lowest `count` decimal digits of v so that they end just before `end`, zero padded
+       */
+      inline void write_digits( char* end, uint64_t v, uint32_t count ) {
+         char* out = end;
+         while( count >= 2 ) {
+            const uint64_t pair = (v % 100) * 2;
+            v /= 100;
+            out -= 2;
+            out[0] = digit_pairs[pair];
+            out[1] = digit_pairs[pair + 1];
+            count -= 2;
+         }
+         if( count )
+            *--out = '0' + (v % 10);
+      }
+
+      inline char* write_unsigned( char* begin, char* end, uint64_t v, bool negative ) {
+         const uint32_t digits = count_digits( v );
+         if( size_t(end - begin) < digits + negative )
+            return begin;
+         if( negative )
+            *begin++ = '-';
+         write_digits( begin + digits, v, digits );
+         return begin + digits;
+      }
+
+      inline char* write_unsigned( char* begin, char* end, uint128_t v, bool negative ) {
+         if( (v >> 64) == 0 )
+            return write_unsigned( begin, end, uint64_t(v), negative );
+
+         // split into base 10^19 chunks, at most three for 39 digits
+         constexpr uint64_t base = 10000000000000000000ull;
+         uint64_t chunks[3] = {};
+         uint32_t count = 0;
+         while( (v >> 64) != 0 ) {
+            const uint64_t hi = uint64_t(v >> 64);
+            uint64_t rem = 0;
+            const uint64_t q_hi = hi / base;
+            const uint64_t q_lo = udiv128by64( hi - q_hi * base, uint64_t(v), base, rem );
+            chunks[count++] = rem;
+            v = (uint128_t(q_hi) << 64) | q_lo;
+         }
+         chunks[count++] = uint64_t(v);
+
+         const uint32_t lead = count_digits( chunks[count - 1] );
+         const uint32_t digits = lead + 19 * (count - 1);
+         if( size_t(end - begin) < digits + negative )
+            return begin;
+         if( negative )
+            *begin++ = '-';
+         char* out = begin + lead;
+         write_digits( out, chunks[count - 1], lead );
+         for( uint32_t i = count - 1; i-- > 0; ) {
+            out += 19;
+            write_digits( out, chunks[i], 19 );
+         }
+         return out;
+      }
+
+      /// strict -std=c++17 libstdc++ does not count the 128-bit types as integral
+      template <typename T>
+      constexpr bool is_to_chars_integer = (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+                                           || std::is_same<T, int128_t>::value || std::is_same<T, uint128_t>::value;
+   } /// namespace detail
+
+   /**
+    * Largest number of characters written by to_chars() for any supported integer, "-" plus 39 digits
+    */
+   static constexpr size_t max_integer_chars = 40;
+
+   /**
+    *  Writes the decimal representation of an integer to the provided char buffer
+    *
+    *  @brief Writes the decimal representation of an integer to the provided char buffer
+    *  @pre The range [begin, end) must be a valid range of memory to write to
+    *  @param begin - The start of the char buffer
+    *  @param end - Just past the end of the char buffer
+    *  @param value - Signed or unsigned integer of up to 128 bits
+    *  @return char* - Just past the end of the last character written (returns begin if the buffer is too small)
+    *
+    *  Example:
+    *  @code
+    *  char buffer[eosio::max_integer_chars];
+    *  auto end = eosio::to_chars( buffer, buffer + sizeof(buffer), total_supply );
+    *  prints_l( buffer, end - buffer );
+    *  @endcode
+    */
+   template <typename T, std::enable_if_t<detail::is_to_chars_integer<T>, int> = 0>
+   inline char* to_chars( char* begin, char* end, T value ) {
+      if constexpr( sizeof(T) > 8 ) {
+         const bool negative = std::is_same<T, int128_t>::value && value < T(0);
+         const uint128_t magnitude = negative ? uint128_t(0) - uint128_t(value) : uint128_t(value);
+         return detail::write_unsigned( begin, end, magnitude, negative );
+      } else if constexpr( std::is_signed<T>::value ) {
+         return detail::write_unsigned( begin, end, detail::magnitude( value ), value < 0 );
+      } else {
+         return detail::write_unsigned( begin, end, uint64_t(value), false );
+      }
+   }
+
+   /// @} charconv
+}
@@ -9,23 +9,27 @@
 namespace eosio {
 
    void assert_sha256( const char* data, uint32_t length, const eosio::checksum256& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_sha256( data, length, reinterpret_cast<const ::capi_checksum256*>(hash_data.data()) );
+      ::capi_checksum256 hash_data;
+      hash.write_as_bytes( hash_data.hash );
+      ::assert_sha256( data, length, &hash_data );
    }
 
    void assert_sha1( const char* data, uint32_t length, const eosio::checksum160& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_sha1( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
+      ::capi_checksum160 hash_data;
+      hash.write_as_bytes( hash_data.hash );
+      ::assert_sha1( data, length, &hash_data );
    }
 
    void assert_sha512( const char* data, uint32_t length, const eosio::checksum512& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_sha512( data, length, reinterpret_cast<const ::capi_checksum512*>(hash_data.data()) );
+      ::capi_checksum512 hash_data;
+      hash.write_as_bytes( hash_data.hash );
+      ::assert_sha512( data, length, &hash_data );
    }
 
    void assert_ripemd160( const char* data, uint32_t length, const eosio::checksum160& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_ripemd160( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
+      ::capi_checksum160 hash_data;
+      hash.write_as_bytes( hash_data.hash );
+      ::assert_ripemd160( data, length, &hash_data );
    }
 
    eosio::checksum256 sha256( const char* data, uint32_t length ) {
@@ -53,7 +57,8 @@ namespace eosio {
    }
 
    eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig ) {
-      auto digest_data = digest.extract_as_byte_array();
+      ::capi_checksum256 digest_data;
+      digest.write_as_bytes( digest_data.hash );
 
       char sig_data[70];
       eosio::datastream<char*> sig_ds( sig_data, sizeof(sig_data) );
@@ -61,7 +66,7 @@ namespace eosio {
       sig_ds << sig;
 
       char pubkey_data[38];
-      size_t pubkey_size = ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
+      size_t pubkey_size = ::recover_key( &digest_data,
                                           sig_begin, (sig_ds.pos() - sig_begin),
                                           pubkey_data, sizeof(pubkey_data) );
       eosio::datastream<char*> pubkey_ds( pubkey_data, pubkey_size );
@@ -71,7 +76,8 @@ namespace eosio {
    }
 
    void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey ) {
-      auto digest_data = digest.extract_as_byte_array();
+      ::capi_checksum256 digest_data;
+      digest.write_as_bytes( digest_data.hash );
 
       char sig_data[70];
       eosio::datastream<char*> sig_ds( sig_data, sizeof(sig_data) );
@@ -83,7 +89,7 @@ namespace eosio {
       auto pubkey_begin = pubkey_ds.pos();
       pubkey_ds << pubkey;
 
-      ::assert_recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
+      ::assert_recover_key( &digest_data,
                             sig_begin, (sig_ds.pos() - sig_begin),
                             pubkey_begin, (pubkey_ds.pos() - pubkey_begin) );
    }
@@ -197,5 +197,31 @@ namespace eosio {
     */
    void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey );
 
+   /**
+    *  Hash algorithms usable with hash_packed()
+    *  @brief Hash algorithms usable with hash_packed()
+    */
+   namespace hash_algo {
+      struct sha1 {
+         using checksum_type = eosio::checksum160;
+         static checksum_type hash( const char* data, uint32_t length ) { return eosio::sha1( data, length ); }
+      };
+
+      struct sha256 {
+         using checksum_type = eosio::checksum256;
+         static checksum_type hash( const char* data, uint32_t length ) { return eosio::sha256( data, length ); }
+      };
+
+      struct sha512 {
+         using checksum_type = eosio::checksum512;
+         static checksum_type hash( const char* data, uint32_t length ) { return eosio::sha512( data, length ); }
+      };
+
+      struct ripemd160 {
+         using checksum_type = eosio::checksum160;
+         static checksum_type hash( const char* data, uint32_t length ) { return eosio::ripemd160( data, length ); }
+      };
+   }
+
    /// }@cryptoapi
 }
@@ -1446,6 +1446,49 @@ std::vector<char> pack( const T& value ) {
   return result;
 }
 
+namespace _datastream_detail {
+   /**
+    * Scratch buffer shared by hash_packed() for objects that do not fit on the stack, only ever grows
+    */
+   inline std::vector<char>& hash_scratch() {
+      static std::vector<char> buffer;
+      return buffer;
+   }
+}
+
+/**
+ * Hash the packed representation of an object without allocating a new buffer per call
+ *
+ * @brief Hash the packed representation of an object
+ * @details Equivalent to `Algo::hash( pack(value).data(), pack_size(value) )`. Small objects are serialized on
+ * the stack, larger ones into a scratch buffer that is reused across calls.
+ * @tparam Algo - One of the eosio::hash_algo selectors
+ * @tparam T - Type of the object to hash
+ * @param value - Object to hash
+ * @return typename Algo::checksum_type - The digest
+ *
+ * Example:
+ * @code
+ * eosio::checksum256 commitment = eosio::hash_packed<eosio::hash_algo::sha256>( std::make_tuple(owner, nonce, amount) );
+ * @endcode
+ */
+template<typename Algo, typename T>
+typename Algo::checksum_type hash_packed( const T& value ) {
+  const size_t size = pack_size( value );
+  char small_buffer[128];
+  char* buffer = small_buffer;
+  if( size > sizeof(small_buffer) ) {
+     auto& scratch = _datastream_detail::hash_scratch();
+     if( scratch.size() < size )
+        scratch.resize( size );
+     buffer = scratch.data();
+  }
+
+  datastream<char*> ds( buffer, size );
+  ds << value;
+  return Algo::hash( buffer, size );
+}
+
 ///@}
 
 /**
@@ -8,6 +8,8 @@
 
 #include <array>
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <type_traits>
 
 namespace eosio {
@@ -82,7 +84,7 @@ namespace eosio {
             }
             if( sub_words_left != num_sub_words ) {
                if( sub_words_left > 1 )
-                  temp_word <<= 8 * (sub_words_left-1);
+                  temp_word <<= sub_word_shift * (sub_words_left-1);
                *itr = temp_word;
             }
          }
@@ -141,7 +143,10 @@ namespace eosio {
                            "size of the backing word size is not divisible by the size of the array element" );
             static_assert( sizeof(Word) * NumWords <= Size, "too many words supplied to fixed_bytes constructor" );
 
-            set_from_word_sequence<Word, NumWords>(arr.data(), arr.data() + arr.size(), *this);
+            if constexpr( sizeof(Word) == 1 )
+               set_from_bytes( reinterpret_cast<const uint8_t*>(arr.data()), NumWords );
+            else
+               set_from_word_sequence<Word, NumWords>(arr.data(), arr.data() + arr.size(), *this);
          }
 
          /**
@@ -160,7 +165,10 @@ namespace eosio {
                            "size of the backing word size is not divisible by the size of the array element" );
             static_assert( sizeof(Word) * NumWords <= Size, "too many words supplied to fixed_bytes constructor" );
 
-            set_from_word_sequence<Word, NumWords>(arr, arr + NumWords, *this);
+            if constexpr( sizeof(Word) == 1 )
+               set_from_bytes( reinterpret_cast<const uint8_t*>(arr), NumWords );
+            else
+               set_from_word_sequence<Word, NumWords>(arr, arr + NumWords, *this);
          }
 
          /**
@@ -224,28 +232,43 @@ namespace eosio {
           */
          std::array<uint8_t, Size> extract_as_byte_array()const {
             std::array<uint8_t, Size> arr;
+            write_as_bytes( arr.data() );
+            return arr;
+         }
 
-            const size_t num_sub_words = sizeof(word_t);
-
-            auto arr_itr  = arr.begin();
-            auto data_itr = _data.begin();
-
-            for( size_t counter = _data.size(); counter > 0; --counter, ++data_itr ) {
-               size_t sub_words_left = num_sub_words;
-
-               auto temp_word = *data_itr;
-               if( counter == 1 ) { // If last word in _data array...
-                  sub_words_left -= padded_bytes();
-                  temp_word >>= 8*padded_bytes();
-               }
-               for( ; sub_words_left > 0; --sub_words_left ) {
-                  *(arr_itr + sub_words_left - 1) = static_cast<uint8_t>(temp_word & 0xFF);
-                  temp_word >>= 8;
-               }
-               arr_itr += num_sub_words;
+         /**
+          * Write the contained data into a caller supplied buffer of `Size` bytes
+          * @brief Write the contained data into a caller supplied buffer
+          *
+          * @details Produces the same bytes as extract_as_byte_array() without going through a temporary array,
+          * so a digest can be written straight into the `capi_checksum*` struct handed to an intrinsic
+          * @param out - Destination buffer, must hold at least `Size` bytes
+          */
+         void write_as_bytes( uint8_t* out )const {
+            for( size_t i = 0; i < _data.size(); ++i ) {
+               const size_t offset = i * sizeof(word_t);
+               store_word( _data[i], out + offset, std::min( Size - offset, sizeof(word_t) ) );
             }
+         }
 
-            return arr;
+         /**
+          * Cheap 64-bit hash of the contained data
+          * @brief Cheap 64-bit hash of the contained data
+          *
+          * @details Folds the words with a multiply-xor step and a final avalanche. Not cryptographic; meant for
+          * hash tables and for quick inequality checks on digests.
+          * @return uint64_t - The fingerprint
+          */
+         uint64_t fingerprint()const {
+            uint64_t h = Size;
+            for( const auto& word : _data ) {
+               h = (h ^ static_cast<uint64_t>(word >> 64)) * 0x9e3779b97f4a7c15ull;
+               h = (h ^ static_cast<uint64_t>(word)) * 0x9e3779b97f4a7c15ull;
+            }
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
          }
 
          // Comparison operators
@@ -263,6 +286,66 @@ namespace eosio {
 
       private:
 
+         /**
+          * Load up to 16 bytes in big-endian order into a word, missing trailing bytes are zero
+          */
+         static word_t load_word( const uint8_t* bytes, size_t count ) {
+            uint8_t buffer[16] = {};
+            memcpy( buffer, bytes, count );
+            uint64_t hi = 0;
+            uint64_t lo = 0;
+            memcpy( &hi, buffer, 8 );
+            memcpy( &lo, buffer + 8, 8 );
+            return (static_cast<word_t>(__builtin_bswap64(hi)) << 64) | __builtin_bswap64(lo);
+         }
+
+         /**
+          * Store the first `count` bytes of a word in big-endian order
+          */
+         static void store_word( word_t word, uint8_t* bytes, size_t count ) {
+            uint8_t buffer[16];
+            const uint64_t hi = __builtin_bswap64( static_cast<uint64_t>(word >> 64) );
+            const uint64_t lo = __builtin_bswap64( static_cast<uint64_t>(word) );
+            memcpy( buffer, &hi, 8 );
+            memcpy( buffer + 8, &lo, 8 );
+            memcpy( bytes, buffer, count );
+         }
+
+         /**
+          * Fill the words from a byte sequence of at most Size bytes, 8 bytes at a time
+          */
+         void set_from_bytes( const uint8_t* bytes, size_t count ) {
+            for( size_t i = 0; i < _data.size(); ++i ) {
+               const size_t offset = i * sizeof(word_t);
+               const size_t chunk  = offset >= count ? 0 : std::min( count - offset, sizeof(word_t) );
+               _data[i] = load_word( bytes + offset, chunk );
+            }
+         }
+
+         /**
+          * Three-way lexicographic comparison, word by word
+          *
+          * @details Bytes are stored big-endian inside each word and the padding is zero, so comparing the
+          * words as unsigned integers orders the byte strings lexicographically
+          */
+         static int compare_words( const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2 ) {
+            for( size_t i = 0; i < c1._data.size(); ++i ) {
+               if( c1._data[i] != c2._data[i] )
+                  return c1._data[i] < c2._data[i] ? -1 : 1;
+            }
+            return 0;
+         }
+
+         /**
+          * Equality without early exit or memcmp, differences of all words are or-ed together
+          */
+         static bool equal_words( const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2 ) {
+            word_t diff = 0;
+            for( size_t i = 0; i < c1._data.size(); ++i )
+               diff |= c1._data[i] ^ c2._data[i];
+            return diff == 0;
+         }
+
          std::array<word_t, num_words()> _data;
     };
 
@@ -276,7 +359,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator ==(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data == c2._data;
+      return fixed_bytes<Size>::equal_words(c1, c2);
    }
 
    /**
@@ -289,7 +372,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator !=(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data != c2._data;
+      return !fixed_bytes<Size>::equal_words(c1, c2);
    }
 
    /**
@@ -302,7 +385,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator >(const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2) {
-      return c1._data > c2._data;
+      return fixed_bytes<Size>::compare_words(c1, c2) > 0;
    }
 
    /**
@@ -315,7 +398,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator <(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data < c2._data;
+      return fixed_bytes<Size>::compare_words(c1, c2) < 0;
    }
 
    /**
@@ -328,7 +411,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator >=(const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2) {
-      return c1._data >= c2._data;
+      return fixed_bytes<Size>::compare_words(c1, c2) >= 0;
    }
 
    /**
@@ -341,7 +424,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator <=(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data <= c2._data;
+      return fixed_bytes<Size>::compare_words(c1, c2) <= 0;
    }
 
    /// @} fixed_bytes
@@ -350,3 +433,15 @@ namespace eosio {
    using checksum256 = fixed_bytes<32>;
    using checksum512 = fixed_bytes<64>;
 }
+
+namespace std {
+   /**
+    * Hash specialization so fixed_bytes can key unordered containers, based on fixed_bytes::fingerprint()
+    */
+   template<size_t Size>
+   struct hash<eosio::fixed_bytes<Size>> {
+      size_t operator()( const eosio::fixed_bytes<Size>& key )const {
+         return static_cast<size_t>( key.fingerprint() );
+      }
+   };
+}
@@ -0,0 +1,346 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+#include "fixedpoint.hpp"
+#include "math.hpp"
+
+namespace eosio {
+
+   /**
+    *  @addtogroup fixed_math Fixed Point Math
+    *  @ingroup fixed_point
+    *  @brief Deterministic integer implementations of sqrt, exp2, log2, exp, ln and pow
+    *
+    *  @details Pricing curves written against `double` go through musl's libm on top of softfloat, which is
+    *  slow in WASM. The functions in this group operate on 64.64 fixed point values held in a
+    *  `fixed_point128<64>` and only use 64-bit multiplications and divisions, so they cost a small fraction of
+    *  the softfloat path and give bit-identical results everywhere.
+    *
+    *  exp2 and log2 split their argument on the top 6 fractional bits, look up a 64 entry constexpr table and
+    *  evaluate a short polynomial on the remainder, which keeps the error within a few units of 2^-64.
+    *  @{
+    */
+
+   namespace detail {
+      /// 2^(k/64) in Q1.63, rounded to nearest
+      static constexpr uint64_t exp2_table[64] = {
+         0x8000000000000000ull, 0x8164d1f3bc030773ull, 0x82cd8698ac2ba1d7ull, 0x843a28c3acde4046ull,
+         0x85aac367cc487b15ull, 0x871f61969e8d1010ull, 0x88980e8092da8527ull, 0x8a14d575496efd9aull,
+         0x8b95c1e3ea8bd6e7ull, 0x8d1adf5b7e5ba9e6ull, 0x8ea4398b45cd53c0ull, 0x9031dc431466b1dcull,
+         0x91c3d373ab11c336ull, 0x935a2b2f13e6e92cull, 0x94f4efa8fef70961ull, 0x96942d3720185a00ull,
+         0x9837f0518db8a96full, 0x99e0459320b7fa65ull, 0x9b8d39b9d54e5539ull, 0x9d3ed9a72cffb751ull,
+         0x9ef5326091a111aeull, 0xa0b0510fb9714fc2ull, 0xa27043030c496819ull, 0xa43515ae09e6809eull,
+         0xa5fed6a9b15138eaull, 0xa7cd93b4e965356aull, 0xa9a15ab4ea7c0ef8ull, 0xab7a39b5a93ed337ull,
+         0xad583eea42a14ac6ull, 0xaf3b78ad690a4375ull, 0xb123f581d2ac2590ull, 0xb311c412a9112489ull,
+         0xb504f333f9de6484ull, 0xb6fd91e328d17791ull, 0xb8fbaf4762fb9ee9ull, 0xbaff5ab2133e45fbull,
+         0xbd08a39f580c36bfull, 0xbf1799b67a731083ull, 0xc12c4cca66709456ull, 0xc346ccda24976407ull,
+         0xc5672a115506daddull, 0xc78d74c8abb9b15dull, 0xc9b9bd866e2f27a3ull, 0xcbec14fef2727c5dull,
+         0xce248c151f8480e4ull, 0xd06333daef2b2595ull, 0xd2a81d91f12ae45aull, 0xd4f35aabcfedfa1full,
+         0xd744fccad69d6af4ull, 0xd99d15c278afd7b6ull, 0xdbfbb797daf23755ull, 0xde60f4825e0e9124ull,
+         0xe0ccdeec2a94e111ull, 0xe33f8972be8a5a51ull, 0xe5b906e77c8348a8ull, 0xe8396a503c4bdc68ull,
+         0xeac0c6e7dd24392full, 0xed4f301ed9942b84ull, 0xefe4b99bdcdaf5cbull, 0xf281773c59ffb13aull,
+         0xf5257d152486cc2cull, 0xf7d0df730ad13bb9ull, 0xfa83b2db722a033aull, 0xfd3e0c0cf486c175ull
+      };
+
+      /// ceil(2^63 / (1 + k/64)), the reciprocals used to reduce the log2 argument
+      static constexpr uint64_t log2_recip_table[64] = {
+         0x8000000000000000ull, 0x7e07e07e07e07e08ull, 0x7c1f07c1f07c1f08ull, 0x7a44c6afc2dd9ca9ull,
+         0x7878787878787879ull, 0x76b981dae6076b99ull, 0x7507507507507508ull, 0x73615a240e6c2b45ull,
+         0x71c71c71c71c71c8ull, 0x70381c0e070381c1ull, 0x6eb3e45306eb3e46ull, 0x6d3a06d3a06d3a07ull,
+         0x6bca1af286bca1b0ull, 0x6a63bd81a98ef607ull, 0x6906906906906907ull, 0x67b23a5440cf6475ull,
+         0x6666666666666667ull, 0x6522c3f35ba78195ull, 0x63e7063e7063e707ull, 0x62b2e43dafcea68eull,
+         0x6186186186186187ull, 0x6060606060606061ull, 0x5f417d05f417d060ull, 0x5e293205e293205full,
+         0x5d1745d1745d1746ull, 0x5c0b81702e05c0b9ull, 0x5b05b05b05b05b06ull, 0x5a05a05a05a05a06ull,
+         0x590b21642c8590b3ull, 0x5816058160581606ull, 0x572620ae4c415c99ull, 0x563b48c20563b48dull,
+         0x5555555555555556ull, 0x54741fab8be05475ull, 0x5397829cbc14e5e1ull, 0x52bf5a814afd6a06ull,
+         0x51eb851eb851eb86ull, 0x511be1958b67ebbaull, 0x5050505050505051ull, 0x4f88b2f392a409f2ull,
+         0x4ec4ec4ec4ec4ec5ull, 0x4e04e04e04e04e05ull, 0x4d4873ecade304d5ull, 0x4c8f8d28ac42fd9cull,
+         0x4bda12f684bda130ull, 0x4b27ed3604b27ed4ull, 0x4a7904a7904a7905ull, 0x49cd42e2049cd42full,
+         0x4924924924924925ull, 0x487ede0487ede049ull, 0x47dc11f7047dc120ull, 0x473c1ab68a0473c2ull,
+         0x469ee58469ee5847ull, 0x4604604604604605ull, 0x456c797dd49c3412ull, 0x44d72044d72044d8ull,
+         0x4444444444444445ull, 0x43b3d5af9a723f79ull, 0x4325c53ef368eb05ull, 0x429a0429a0429a05ull,
+         0x4210842108421085ull, 0x4189374bc6a7ef9eull, 0x4104104104104105ull, 0x4081020408102041ull
+      };
+
+      /// -log2(log2_recip_table[k] / 2^63) in Q0.64, rounded to nearest
+      static constexpr uint64_t log2_table[64] = {
+         0x0000000000000000ull, 0x05b9e5a170b48a62ull, 0x0b5d69bac77ec398ull, 0x10eb389fa29f9ab1ull,
+         0x1663f6fac913167bull, 0x1bc84240adabba61ull, 0x2118b119b4f3c72aull, 0x2655d3c4f15c343dull,
+         0x2b803473f7ad0f3cull, 0x309857a05e0765fbull, 0x359ebc5b69d927ddull, 0x3a93dc9864b2df91ull,
+         0x3f782d7204d01444ull, 0x444c1f6b4c2dd72bull, 0x49101eac381ce608ull, 0x4dc4933a9337b365ull,
+         0x5269e12f346e2bf7ull, 0x570068e7ef5a1e7dull, 0x5b8887367433795bull, 0x6002958c587150caull,
+         0x646eea247c5c22cfull, 0x68cdd829fd814274ull, 0x6d1fafdce20a828dull, 0x7164beb4a56d59f7ull,
+         0x759d4f80cba83bf8ull, 0x79c9aa879d53482eull, 0x7dea15a32c1b3b37ull, 0x81fed45cbccbf99bull,
+         0x86082806b1d532c0ull, 0x8a064fd50f2a1cefull, 0x8df988f4ae806f1cull, 0x91e20ea1393e403dull,
+         0x95c01a39fbd6879dull, 0x9993e355a4e53640ull, 0x9d5d9fd5010b3665ull, 0xa11d83f4c3554b35ull,
+         0xa4d3c25e68dc57eeull, 0xa8808c384547c6ebull, 0xac241134c4e99e19ull, 0xafbe7fa0f04d75c2ull,
+         0xb35004723c465e69ull, 0xb6d8cb53b0ca4ecbull, 0xba58feb2703a9e35ull, 0xbdd0c7c9a817204dull,
+         0xc1404eadf38396dcull, 0xc4a7ba58377c5a00ull, 0xc80730b0001667f0ull, 0xcb5ed69565afaf7bull,
+         0xceaecfea80859b31ull, 0xd1f73f9c70c0f681ull, 0xd53847ac00a69be4ull, 0xd8720935e6435ebcull,
+         0xdba4a47aa996d258ull, 0xded038e633f36da5ull, 0xe1f4e5170d02a998ull, 0xe512c6e54998b1abull,
+         0xe829fb693044b395ull, 0xeb3a9f01975077f0ull, 0xee44cd59ffab62efull, 0xf148a170700a00f9ull,
+         0xf446359b1353954cull, 0xf73da38d9d4a83eaull, 0xfa2f045e7832aa6dull, 0xfd1a708bbe119b12ull
+      };
+
+      /// ln(2)^i / i! for i = 1..8 in Q0.64, the Taylor coefficients of 2^r
+      static constexpr uint64_t exp2_poly[8] = {
+         0xb17217f7d1cf79acull, 0x3d7f7bff058b1d51ull, 0x0e35846b82505fc6ull, 0x0276556df749cee5ull,
+         0x005761ff9e299cc4ull, 0x000a184897c363c4ull, 0x0000ffe5fe2c4586ull, 0x0000162c0223a5c8ull
+      };
+
+      /// 1/i for i = 2..11 in Q0.64, the coefficients of the ln(1+u) series
+      static constexpr uint64_t ln1p_poly[10] = {
+         0x8000000000000000ull, 0x5555555555555555ull, 0x4000000000000000ull, 0x3333333333333333ull, 0x2aaaaaaaaaaaaaabull,
+         0x2492492492492492ull, 0x2000000000000000ull, 0x1c71c71c71c71c72ull, 0x199999999999999aull, 0x1745d1745d1745d1ull
+      };
+
+      static constexpr uint64_t log2e_q63 = 0xb8aa3b295c17f0bcull; ///< log2(e) in Q1.63
+      static constexpr uint64_t ln2_q63   = 0x58b90bfbe8e7bcd6ull; ///< ln(2) in Q1.63
+
+      /**
+       * Upper 64 bits of a 64x64 product, i.e. the product of two Q0.64 values in Q0.64
+       */
+      inline uint64_t mulhi64( uint64_t a, uint64_t b ) {
+         uint64_t hi = 0;
+         uint64_t lo = 0;
+         umul64( a, b, hi, lo );
+         return hi;
+      }
+
+      /**
+       * Multiply a signed 64.64 value by an unsigned Q1.63 constant
+       */
+      inline int128_t mul_q64_q63( int128_t v, uint64_t c ) {
+         const bool negative = v < 0;
+         const uint128_t mag = negative ? uint128_t(0) - uint128_t(v) : uint128_t(v);
+         uint64_t h0 = 0, l0 = 0, h1 = 0, l1 = 0;
+         umul64( uint64_t(mag), c, h0, l0 );
+         umul64( uint64_t(mag >> 64), c, h1, l1 );
+         const uint64_t mid   = h0 + l1;
+         const uint64_t top   = h1 + (mid < h0);
+         eosio::check( (top >> 63) == 0, "fixed point overflow" );
+         const uint128_t r = (uint128_t(top) << 65) | (uint128_t(mid) << 1) | (l0 >> 63);
+         return negative ? -int128_t(r) : int128_t(r);
+      }
+
+      /**
+       * floor(sqrt(n)) for a 192-bit n given as three 64-bit words, most significant first
+       *
+       * @details Digit by digit (two bits per step) square root, needs only shifts, compares and subtractions
+       */
+      inline uint128_t isqrt192( uint64_t w2, uint64_t w1, uint64_t w0 ) {
+         const uint64_t words[3] = { w2, w1, w0 };
+         uint128_t root = 0;
+         uint128_t rem  = 0;
+         for( int w = 0; w < 3; ++w ) {
+            for( int shift = 62; shift >= 0; shift -= 2 ) {
+               rem = (rem << 2) | ((words[w] >> shift) & 3);
+               const uint128_t trial = (root << 2) | 1;
+               root <<= 1;
+               if( rem >= trial ) {
+                  rem -= trial;
+                  root |= 1;
+               }
+            }
+         }
+         return root;
+      }
+
+      inline int clz128( uint128_t v ) {
+         const uint64_t hi = uint64_t(v >> 64);
+         return hi ? clz64(hi) : 64 + clz64(uint64_t(v));
+      }
+   } /// namespace detail
+
+   /**
+    * Integer square root
+    *
+    * @param n - Radicand
+    * @return uint64_t - floor(sqrt(n)), exact
+    */
+   inline uint64_t isqrt( uint64_t n ) {
+      return uint64_t(detail::isqrt192( 0, 0, n ));
+   }
+
+   /**
+    * Integer square root of a 128-bit radicand
+    *
+    * @param n - Radicand
+    * @return uint64_t - floor(sqrt(n)), exact
+    */
+   inline uint64_t isqrt( uint128_t n ) {
+      return uint64_t(detail::isqrt192( 0, uint64_t(n >> 64), uint64_t(n) ));
+   }
+
+   /**
+    * Square root of a 64.64 fixed point value
+    *
+    * @param x - Radicand, must not be negative
+    * @return fixed_point128<64> - sqrt(x) rounded toward zero, exact to the last bit
+    */
+   inline fixed_point128<64> fixed_sqrt( const fixed_point128<64>& x ) {
+      eosio::check( x.val >= 0, "fixed_sqrt of negative value" );
+      const uint128_t v = uint128_t(x.val);
+      // sqrt(v / 2^64) * 2^64 == sqrt(v * 2^64)
+      return fixed_point128<64>( int128_t(detail::isqrt192( uint64_t(v >> 64), uint64_t(v), 0 )) );
+   }
+
+   /**
+    * Base 2 exponential of a 64.64 fixed point value
+    *
+    * @param x - Exponent, must be below 63
+    * @return fixed_point128<64> - 2^x with a relative error below 2^-60 for results of at least one and an absolute error of
+    * a few units of 2^-64 below that; results under 2^-64 flush to zero
+    *
+    * Example:
+    * @code
+    * fixed_point128<64> half = fixed_point128<64>( int128_t(1) << 63 );
+    * auto sqrt2 = fixed_exp2( half ); // 1.41421356...
+    * @endcode
+    */
+   inline fixed_point128<64> fixed_exp2( const fixed_point128<64>& x ) {
+      const int64_t  n = int64_t(x.val >> 64);
+      const uint64_t f = uint64_t(x.val);
+      eosio::check( n < 63, "fixed_exp2 overflow" );
+      if( n < -64 )
+         return fixed_point128<64>( 0 );
+
+      // 2^f = 2^(k/64) * 2^r with r < 1/64
+      const uint64_t k = f >> 58;
+      const uint64_t r = f & ((1ull << 58) - 1);
+      uint64_t acc = detail::exp2_poly[7];
+      for( int i = 6; i >= 0; --i )
+         acc = detail::exp2_poly[i] + detail::mulhi64( acc, r );
+      const uint64_t poly = (1ull << 63) + (detail::mulhi64( acc, r ) >> 1); // Q1.63
+
+      uint64_t hi = 0;
+      uint64_t lo = 0;
+      detail::umul64( detail::exp2_table[k], poly, hi, lo );
+      const uint64_t mant = (hi << 1) | (lo >> 63); // Q1.63 in [1, 2)
+
+      const int64_t shift = n + 1;
+      if( shift >= 0 )
+         return fixed_point128<64>( int128_t(uint128_t(mant) << shift) );
+      return fixed_point128<64>( int128_t(mant >> -shift) );
+   }
+
+   /**
+    * Base 2 logarithm of a 64.64 fixed point value
+    *
+    * @param x - Argument, must be positive
+    * @return fixed_point128<64> - log2(x) with an absolute error below 2^-62
+    */
+   inline fixed_point128<64> fixed_log2( const fixed_point128<64>& x ) {
+      eosio::check( x.val > 0, "fixed_log2 of non-positive value" );
+      const uint128_t v = uint128_t(x.val);
+      const int msb = 127 - detail::clz128( v );
+
+      // normalize into m in [1, 2) as Q1.63
+      const uint64_t m = msb > 63 ? uint64_t(v >> (msb - 63)) : uint64_t(v) << (63 - msb);
+
+      // m * recip(k) lands in [1, 1 + 2^-6], keep u = m * recip(k) - 1 as Q0.64
+      const uint64_t k = (m >> 57) & 0x3F;
+      uint64_t hi = 0;
+      uint64_t lo = 0;
+      detail::umul64( m, detail::log2_recip_table[k], hi, lo );
+      const uint64_t u = (hi << 2) | (lo >> 62);
+
+      // ln(1+u) = u - u^2 * (1/2 - u * (1/3 - u * (1/4 - ...)))
+      uint64_t s = detail::ln1p_poly[9];
+      for( int i = 8; i >= 0; --i )
+         s = detail::ln1p_poly[i] - detail::mulhi64( u, s );
+      const uint64_t ln1p = u - detail::mulhi64( detail::mulhi64( u, u ), s );
+
+      // log2(1+u) = ln(1+u) * log2(e)
+      detail::umul64( ln1p, detail::log2e_q63, hi, lo );
+      const uint64_t frac_u = (hi << 1) | (lo >> 63);
+
+      const uint128_t frac = uint128_t(detail::log2_table[k]) + frac_u;
+      return fixed_point128<64>( int128_t(msb - 64) * (int128_t(1) << 64) + int128_t(frac) );
+   }
+
+   /**
+    * Natural exponential of a 64.64 fixed point value
+    *
+    * @param x - Exponent, must be below 43.6
+    * @return fixed_point128<64> - e^x, computed as 2^(x * log2(e))
+    */
+   inline fixed_point128<64> fixed_exp( const fixed_point128<64>& x ) {
+      return fixed_exp2( fixed_point128<64>( detail::mul_q64_q63( x.val, detail::log2e_q63 ) ) );
+   }
+
+   /**
+    * Natural logarithm of a 64.64 fixed point value
+    *
+    * @param x - Argument, must be positive
+    * @return fixed_point128<64> - ln(x) with an absolute error below 2^-58, computed as log2(x) * ln(2)
+    */
+   inline fixed_point128<64> fixed_ln( const fixed_point128<64>& x ) {
+      return fixed_point128<64>( detail::mul_q64_q63( fixed_log2( x ).val, detail::ln2_q63 ) );
+   }
+
+   /**
+    * Raise a 64.64 fixed point value to a rational power
+    *
+    * @details Computes 2^(log2(base) * num / den). The scaling of the logarithm is done with 64-bit
+    * partial products and division steps only, which makes this the preferred form for weights such as
+    * the connector ratios of Bancor style curves.
+    *
+    * @param base - Base, must be positive
+    * @param num - Numerator of the exponent
+    * @param den - Denominator of the exponent
+    * @return fixed_point128<64> - base^(num/den) with a relative error below (|log2(base) * num/den| + 1) * 2^-59
+    *
+    * Example:
+    * @code
+    * // (1 + deposit/balance)^(weight/1000000)
+    * auto ratio = fixed_point128<64>( int128_t(1) << 64 ) + fixed_divide<64>( deposit, balance );
+    * auto growth = fixed_pow( ratio, weight, 1000000 );
+    * @endcode
+    */
+   inline fixed_point128<64> fixed_pow( const fixed_point128<64>& base, int64_t num, int64_t den ) {
+      eosio::check( den != 0, "divide by zero" );
+      const int128_t l = fixed_log2( base ).val;
+      const bool negative = (l < 0) != (num < 0) != (den < 0);
+      const uint128_t mag = l < 0 ? uint128_t(0) - uint128_t(l) : uint128_t(l);
+
+      // |log2(base)| < 2^70 and |num| < 2^64, so the product fits in 192 bits: (p2:p1:p0)
+      uint64_t h0 = 0, p0 = 0, h1 = 0, l1 = 0;
+      detail::umul64( uint64_t(mag), detail::magnitude(num), h0, p0 );
+      detail::umul64( uint64_t(mag >> 64), detail::magnitude(num), h1, l1 );
+      const uint64_t p1 = h0 + l1;
+      const uint64_t p2 = h1 + (p1 < h0);
+
+      // divide by |den| one word at a time
+      const uint64_t d = detail::magnitude(den);
+      uint64_t rem = 0;
+      const uint64_t q2 = detail::udiv128by64( 0, p2, d, rem );
+      const uint64_t q1 = detail::udiv128by64( rem, p1, d, rem );
+      const uint64_t q0 = detail::udiv128by64( rem, p0, d, rem );
+      eosio::check( q2 == 0 && (q1 >> 63) == 0, "fixed_pow overflow" );
+
+      const int128_t e = int128_t((uint128_t(q1) << 64) | q0);
+      return fixed_exp2( fixed_point128<64>( negative ? -e : e ) );
+   }
+
+   /**
+    * Raise a 64.64 fixed point value to a 64.64 fixed point power
+    *
+    * @param base - Base, must be positive
+    * @param exponent - Exponent
+    * @return fixed_point128<64> - base^exponent with a relative error below (|log2(base) * exponent| + 1) * 2^-59,
+    * computed as 2^(exponent * log2(base))
+    */
+   inline fixed_point128<64> fixed_pow( const fixed_point128<64>& base, const fixed_point128<64>& exponent ) {
+      const fixed_point256<128> e = fixed_log2( base ) * exponent;
+      const fixed_point256<64> scaled( e );
+      eosio::check( scaled.val[2] == (detail::limbs_negative(scaled.val) ? ~0ull : 0) &&
+                    scaled.val[3] == scaled.val[2] &&
+                    (scaled.val[1] >> 63) == (scaled.val[2] & 1), "fixed_pow overflow" );
+      return fixed_exp2( fixed_point128<64>( int128_t((uint128_t(scaled.val[1]) << 64) | scaled.val[0]) ) );
+   }
+
+   /// @} fixed_math
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include <eosiolib/types.h>
 #include <eosiolib/print.hpp>
+#include <eosiolib/math.hpp>
+
+#include <array>
 
 namespace eosio
 {
@@ -22,64 +25,434 @@ namespace eosio
     template <uint8_t Q> struct fixed_point64;
     template <uint8_t Q> struct fixed_point128;
 
-    // Will support fixed_point256 in next release
-#if 0
     template <uint8_t Q> struct fixed_point256;
+
+    namespace detail {
+        /**
+         * Limb helpers backing fixed_point256. Limbs are stored least significant first and every
+         * product and quotient is formed from 64-bit operations only (see math.hpp), so none of the
+         * 128-bit compiler builtins are pulled in.
+         */
+        using limbs256_t = std::array<uint64_t, 4>;
+
+        inline limbs256_t limbs_from_int128(int128_t v) {
+            const uint64_t lo = uint64_t(v);
+            const uint64_t hi = uint64_t(uint128_t(v) >> 64);
+            const uint64_t ext = v < 0 ? ~0ull : 0;
+            return {{ lo, hi, ext, ext }};
+        }
+
+        inline bool limbs_negative(const limbs256_t& v) {
+            return (v[3] >> 63) != 0;
+        }
+
+        inline limbs256_t limbs_negate(const limbs256_t& v) {
+            limbs256_t r;
+            uint64_t carry = 1;
+            for (size_t i = 0; i < 4; ++i) {
+                r[i] = ~v[i] + carry;
+                carry = (r[i] < carry) ? 1 : 0;
+            }
+            return r;
+        }
+
+        inline limbs256_t limbs_abs(const limbs256_t& v) {
+            return limbs_negative(v) ? limbs_negate(v) : v;
+        }
+
+        inline limbs256_t limbs_add(const limbs256_t& a, const limbs256_t& b) {
+            limbs256_t r;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                const uint64_t s = a[i] + b[i];
+                const uint64_t c1 = s < a[i];
+                r[i] = s + carry;
+                carry = c1 | (r[i] < s);
+            }
+            return r;
+        }
+
+        inline limbs256_t limbs_sub(const limbs256_t& a, const limbs256_t& b) {
+            return limbs_add(a, limbs_negate(b));
+        }
+
+        /**
+         * Shift left by n bits (n < 64*N), vacated bits are zero
+         */
+        template <size_t N>
+        inline std::array<uint64_t, N> limbs_shl(const std::array<uint64_t, N>& v, unsigned n) {
+            std::array<uint64_t, N> r{};
+            const unsigned limb = n / 64;
+            const unsigned bits = n % 64;
+            for (size_t i = N; i-- > limb;) {
+                r[i] = v[i - limb] << bits;
+                if (bits && i > limb)
+                    r[i] |= v[i - limb - 1] >> (64 - bits);
+            }
+            return r;
+        }
+
+        /**
+         * Logical shift right by n bits (n < 64*N), vacated bits are zero
+         */
+        template <size_t N>
+        inline std::array<uint64_t, N> limbs_shr(const std::array<uint64_t, N>& v, unsigned n) {
+            std::array<uint64_t, N> r{};
+            const unsigned limb = n / 64;
+            const unsigned bits = n % 64;
+            for (size_t i = 0; i + limb < N; ++i) {
+                r[i] = v[i + limb] >> bits;
+                if (bits && i + limb + 1 < N)
+                    r[i] |= v[i + limb + 1] << (64 - bits);
+            }
+            return r;
+        }
+
+        /**
+         * Arithmetic (sign propagating) shift right by n bits (n < 256)
+         */
+        inline limbs256_t limbs_sar(const limbs256_t& v, unsigned n) {
+            const uint64_t ext = limbs_negative(v) ? ~0ull : 0;
+            limbs256_t r{{ ext, ext, ext, ext }};
+            const unsigned limb = n / 64;
+            const unsigned bits = n % 64;
+            for (size_t i = 0; i + limb < 4; ++i) {
+                const uint64_t next = (i + limb + 1 < 4) ? v[i + limb + 1] : ext;
+                r[i] = bits ? (v[i + limb] >> bits) | (next << (64 - bits)) : v[i + limb];
+            }
+            return r;
+        }
+
+        inline int limbs_compare(const limbs256_t& a, const limbs256_t& b) {
+            const int64_t ha = int64_t(a[3]);
+            const int64_t hb = int64_t(b[3]);
+            if (ha != hb)
+                return ha < hb ? -1 : 1;
+            for (size_t i = 3; i-- > 0;) {
+                if (a[i] != b[i])
+                    return a[i] < b[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        /**
+         * Schoolbook unsigned product of two limb sequences, out must hold na+nb limbs
+         */
+        inline void limbs_mul(const uint64_t* a, size_t na, const uint64_t* b, size_t nb, uint64_t* out) {
+            for (size_t i = 0; i < na + nb; ++i)
+                out[i] = 0;
+            for (size_t i = 0; i < na; ++i) {
+                if (a[i] == 0)
+                    continue;
+                uint64_t carry = 0;
+                for (size_t j = 0; j < nb; ++j) {
+                    uint64_t hi = 0;
+                    uint64_t lo = 0;
+                    umul64(a[i], b[j], hi, lo);
+                    lo += carry;
+                    hi += (lo < carry);
+                    out[i + j] += lo;
+                    hi += (out[i + j] < lo);
+                    carry = hi;
+                }
+                out[i + nb] = carry;
+            }
+        }
+
+        /**
+         * Number of significant limbs in a limb sequence
+         */
+        inline size_t limbs_size(const uint64_t* v, size_t n) {
+            while (n > 0 && v[n - 1] == 0)
+                --n;
+            return n;
+        }
+
+        /**
+         * Unsigned division of an m limb dividend by an n limb divisor (Knuth's algorithm D, base 2^64)
+         *
+         * @pre m >= n, 1 <= n <= 4, m <= 8 and v[n-1] != 0
+         * @param q - Receives the m-n+1 quotient limbs
+         * @param r - Receives the n remainder limbs, may be null
+         */
+        inline void limbs_divmod(const uint64_t* u, size_t m, const uint64_t* v, size_t n, uint64_t* q, uint64_t* r) {
+            if (n == 1) {
+                // single limb divisor: every step is a 128/64 division whose quotient fits in 64 bits
+                uint64_t rem = 0;
+                for (size_t i = m; i-- > 0;)
+                    q[i] = udiv128by64(rem, u[i], v[0], rem);
+                if (r)
+                    r[0] = rem;
+                return;
+            }
+
+            const int s = clz64(v[n - 1]);
+            uint64_t vn[4];
+            uint64_t un[9];
+            for (size_t i = n - 1; i > 0; --i)
+                vn[i] = (v[i] << s) | (s ? v[i - 1] >> (64 - s) : 0);
+            vn[0] = v[0] << s;
+            un[m] = s ? u[m - 1] >> (64 - s) : 0;
+            for (size_t i = m - 1; i > 0; --i)
+                un[i] = (u[i] << s) | (s ? u[i - 1] >> (64 - s) : 0);
+            un[0] = u[0] << s;
+
+            for (size_t j = m - n + 1; j-- > 0;) {
+                uint64_t qhat = 0;
+                uint64_t rhat = 0;
+                bool rhat_overflow = false;
+                if (un[j + n] >= vn[n - 1]) {
+                    qhat = ~0ull;
+                    rhat = un[j + n - 1] + vn[n - 1];
+                    rhat_overflow = rhat < vn[n - 1];
+                } else {
+                    qhat = udiv128by64(un[j + n], un[j + n - 1], vn[n - 1], rhat);
+                }
+                while (!rhat_overflow) {
+                    uint64_t ph = 0;
+                    uint64_t pl = 0;
+                    umul64(qhat, vn[n - 2], ph, pl);
+                    if (ph < rhat || (ph == rhat && pl <= un[j + n - 2]))
+                        break;
+                    --qhat;
+                    rhat += vn[n - 1];
+                    rhat_overflow = rhat < vn[n - 1];
+                }
+
+                // multiply and subtract
+                uint64_t carry = 0;
+                uint64_t borrow = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t ph = 0;
+                    uint64_t pl = 0;
+                    umul64(qhat, vn[i], ph, pl);
+                    pl += carry;
+                    ph += (pl < carry);
+                    carry = ph;
+                    const uint64_t d = un[i + j] - pl;
+                    const uint64_t b1 = un[i + j] < pl;
+                    un[i + j] = d - borrow;
+                    borrow = b1 | (d < borrow);
+                }
+                const uint64_t d = un[j + n] - carry;
+                const bool b1 = un[j + n] < carry;
+                un[j + n] = d - borrow;
+                const bool negative = b1 || (d < borrow);
+
+                q[j] = qhat;
+                if (negative) {
+                    // qhat was one too large, add the divisor back
+                    --q[j];
+                    uint64_t c = 0;
+                    for (size_t i = 0; i < n; ++i) {
+                        const uint64_t s1 = un[i + j] + vn[i];
+                        const uint64_t c1 = s1 < vn[i];
+                        un[i + j] = s1 + c;
+                        c = c1 | (un[i + j] < s1);
+                    }
+                    un[j + n] += c;
+                }
+            }
+
+            if (r) {
+                for (size_t i = 0; i + 1 < n; ++i)
+                    r[i] = (un[i] >> s) | (s ? un[i + 1] << (64 - s) : 0);
+                r[n - 1] = un[n - 1] >> s;
+            }
+        }
+
+        /**
+         * Signed 128-bit by 64-bit division truncating toward zero, using two 64-bit division steps
+         */
+        inline int128_t div128by64(uint64_t u1, uint64_t u0, bool negative, uint64_t v) {
+            uint64_t rem = 0;
+            const uint64_t q1 = u1 / v;
+            const uint64_t q0 = udiv128by64(u1 - q1 * v, u0, v, rem);
+            const uint128_t q = (uint128_t(q1) << 64) | q0;
+            return negative ? -int128_t(q) : int128_t(q);
+        }
+    } /// namespace detail
+
     /**
     * Template class for Fixed Point 256 bits representaton
+    *
+    * @details The value is kept in two's complement in four 64-bit limbs. Multiplication and division
+    * are carried out limb by limb, so a 256-bit intermediate never has to be truncated to 128 bits.
+    *
+    * Example:
+    * @code
+    * fixed_point256<64> price = fixed_point128<64>(reserve_out) / fixed_point128<0>(reserve_in);
+    * fixed_point256<64> amount = price * fixed_point256<0>(quantity);
+    * @endcode
     */
     template <uint8_t Q>
     struct fixed_point256
     {
-        int128_t val;
-        fixed_point256(int256_t v=0) : val(v) {}
+        /**
+         * Value of the fixed point in two's complement, least significant limb first
+         */
+        detail::limbs256_t val;
+
+        /**
+         * Construct a new fixed point256 object from int128_t
+         *
+         * @param v - int128_t representation of the fixed point value
+         */
+        fixed_point256(int128_t v=0) : val(detail::limbs_from_int128(v)) {}
+
+        /**
+         * Construct a new fixed point256 object from its raw limbs
+         *
+         * @param v - Two's complement limbs, least significant first
+         */
+        explicit fixed_point256(const detail::limbs256_t& v) : val(v) {}
+
+        /**
+         * Construct a new fixed point256 object from another fixed_point256
+         *
+         * @param r - Another fixed_point256 as source
+         */
         template <uint8_t QR> fixed_point256(const fixed_point256<QR> &r);
+
+        /**
+         * Construct a new fixed point256 object from a fixed_point128
+         *
+         * @param r - fixed_point128 as source
+         */
         template <uint8_t QR> fixed_point256(const fixed_point128<QR> &r);
+
+        /**
+         * Construct a new fixed point256 object from a fixed_point64
+         *
+         * @param r - fixed_point64 as source
+         */
         template <uint8_t QR> fixed_point256(const fixed_point64<QR> &r);
+
+        /**
+         * Construct a new fixed point256 object from a fixed_point32
+         *
+         * @param r - fixed_point32 as source
+         */
         template <uint8_t QR> fixed_point256(const fixed_point32<QR> &r);
+
         /**
-        * Get the integer part of the 64 bit fixed number
-        * @brief To get the integer part of the fixed number
-        * @return Returns integer part of the fixed number
+        * Get the integer part of the 256 bit fixed number
+        *
+        * @return Returns the low 128 bits of the integer part of the fixed number
         *
         * Example:
         * @code
-        * fixed64<18> a(1234.455667)
+        * fixed_point256<64> a(fixed_point64<0>(1234));
         * std::cout << a.int_part(); // Output: 1234
         * @endcode
         */
         int128_t int_part() const {
-            return val >> q;
+            const auto ip = detail::limbs_sar(val, Q);
+            return int128_t((uint128_t(ip[1]) << 64) | ip[0]);
         }
 
         /**
-        * Get the decimal part of the 64 bit fixed number
-        * @brief To get the decimal part of the fixed number
-        * @return Returns decimal part of the fixed number
+        * Get the decimal part of the 256 bit fixed number
         *
-        * Example:
-        * @code
-        * fixed64<18> a(1234.455667)
-        * std::cout << a.decimal_part(); // Output: 45567
-        * @endcode
+        * @return Returns the upper 128 bits of the fractional part, scaled by 2^128
         */
         uint128_t frac_part() const {
             if(!Q) return 0;
-            return val << (32-Q);
+            const auto fp = detail::limbs_shl(val, 256-Q);
+            return (uint128_t(fp[3]) << 64) | fp[2];
         }
 
+        /**
+         * Prints the fixed point value
+         */
+        void print() const {
+           int128_t ip(int_part());
+           uint128_t fp(frac_part());
+           printi128(&ip);
+           prints(".");
+           printui128(&fp);
+        }
+
+        /**
+         * Assignment operator. Assign another fixed_point type to fixed_point256
+         *
+         * @tparam T - Type of the source
+         * @param r - Source
+         * @return fixed_point256& - Reference to this object
+         */
+        template <typename T> fixed_point256 &operator=(const T &r) {
+            val = fixed_point256(r).val;
+            return *this;
+        }
+
+        /**
+         * Addition operator
+         *
+         * @tparam QR - Precision of the second addend
+         * @param r - Second addend
+         * @return - The result of addition
+         */
+        template <uint8_t QR> fixed_point256< (Q>QR)?Q:QR > operator+(const fixed_point256<QR> &r) const;
+
+        /**
+         * Subtraction operator
+         *
+         * @tparam QR - Precision of the minuend
+         * @param r - Minuend
+         * @return - The result of subtraction
+         */
+        template <uint8_t QR> fixed_point256< (Q>QR)?Q:QR > operator-(const fixed_point256<QR> &r) const;
+
+        /**
+         * Multiplication operator. There is no wider type to widen into, so the product keeps the precision of
+         * the left operand; the full 512-bit product is formed before it is scaled back.
+         *
+         * @tparam QR - Precision of the multiplier
+         * @param r - Multiplier
+         * @return - The result of multiplication
+         */
+        template <uint8_t QR> fixed_point256<Q> operator*(const fixed_point256<QR> &r) const;
 
+        /**
+         * Division operator. The quotient keeps the precision of the left operand.
+         *
+         * @tparam QR - Precision of the divisor
+         * @param r - Divisor
+         * @return - The result of division
+         */
+        template <uint8_t QR> fixed_point256<Q> operator/(const fixed_point256<QR> &r) const;
 
-        template <uint8_t QR> fixed_point256 &operator=(const fixed_point32<QR> &r);
-        template <uint8_t QR> fixed_point256 &operator=(const fixed_point64<QR> &r);
-        template <uint8_t QR> fixed_point256 &operator=(const fixed_point128<QR> &r);
-        template <uint8_t QR> fixed_point256 &operator=(const fixed_point256<QR> &r);
         // Comparison functions
-        template <uint8_t QR> bool operator==(const fixed_point256<QR> &r) { return (val == r.val);}
-        template <uint8_t QR> bool operator>(const fixed_point256<QR> &r) { return (val > r.val);}
-        template <uint8_t QR> bool operator<(const fixed_point256<QR> &r) { return (val < r.val);}
+        /**
+         * Equality operator
+         *
+         * @tparam qr - Precision of the source
+         * @param r - Source
+         * @return true - if equal
+         * @return false - otherwise
+         */
+        template <uint8_t QR> bool operator==(const fixed_point256<QR> &r) const { return detail::limbs_compare(val, fixed_point256(r).val) == 0; }
+
+        /**
+         * Greater than operator
+         *
+         * @tparam qr - Precision of the source
+         * @param r - Source
+         * @return true - if greater
+         * @return false - otherwise
+         */
+        template <uint8_t QR> bool operator>(const fixed_point256<QR> &r) const { return detail::limbs_compare(val, fixed_point256(r).val) > 0; }
+
+        /**
+         * Less than operator
+         *
+         * @tparam qr - Precision of the source
+         * @param r - Source
+         * @return true - if less
+         * @return false - otherwise
+         */
+        template <uint8_t QR> bool operator<(const fixed_point256<QR> &r) const { return detail::limbs_compare(val, fixed_point256(r).val) < 0; }
     };
-#endif
 
     /**
     * The template param Q represents the Q Factor i.e number of decimals
@@ -212,6 +585,44 @@ namespace eosio
          */
         template <uint8_t qr> fixed_point128 &operator=(const fixed_point128<qr> &r);
 
+        // Arithmetic operations
+        /**
+         * Addition operator
+         *
+         * @tparam QR - Precision of the second addend
+         * @param r - Second addend
+         * @return - The result of addition
+         */
+        template <uint8_t QR> fixed_point128< (Q>QR)?Q:QR > operator+(const fixed_point128<QR> &r) const;
+
+        /**
+         * Subtraction operator
+         *
+         * @tparam QR - Precision of the minuend
+         * @param r - Minuend
+         * @return - The result of subtraction
+         */
+        template <uint8_t QR> fixed_point128< (Q>QR)?Q:QR > operator-(const fixed_point128<QR> &r) const;
+
+        // product and division of two fixed_point128 instances will be fixed_point256
+        /**
+         * Multiplication operator
+         *
+         * @tparam QR - Precision of the multiplier
+         * @param r - Multiplier
+         * @return - The result of multiplication
+         */
+        template <uint8_t QR> fixed_point256<Q+QR> operator*(const fixed_point128<QR> &r) const;
+
+        /**
+         * Division operator
+         *
+         * @tparam QR - Precision of the divisor
+         * @param r - Divisor
+         * @return - The result of division
+         */
+        template <uint8_t QR> fixed_point256<Q+128-QR> operator/(const fixed_point128<QR> &r) const;
+
         // Comparison functions
         /**
          * Equality operator
@@ -603,28 +1014,97 @@ namespace eosio
     }
 
 
-#if 0
     // fixed_point256 methods
-    template<uint32_t q> template<uint32_t qr>
-    fixed_point256<q>::fixed_point256(const fixed_point256<qr> &r) {
-        val = assignHelper<int256_t>(r.val, q, qr);
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point256<Q>::fixed_point256(const fixed_point256<QR> &r) {
+        val = (Q > QR) ? detail::limbs_shl(r.val, Q-QR) : detail::limbs_sar(r.val, QR-Q);
+    }
+
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point256<Q>::fixed_point256(const fixed_point128<QR> &r) {
+        val = fixed_point256<Q>(fixed_point256<QR>(r.val)).val;
     }
 
-    template<uint32_t q> template<uint32_t qr>
-    fixed_point256<q>::fixed_point256(const fixed_point128<qr> &r) {
-        val = assignHelper<int256_t>(r.val, q, qr);
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point256<Q>::fixed_point256(const fixed_point64<QR> &r) {
+        val = fixed_point256<Q>(fixed_point256<QR>(int128_t(r.val))).val;
     }
 
-    template<uint32_t q> template<uint32_t qr>
-    fixed_point256<q>::fixed_point256(const fixed_point64<qr> &r) {
-        val = assignHelper<int256_t>(r.val, q, qr);
+    template<uint8_t Q> template <uint8_t QR>
+    fixed_point256<Q>::fixed_point256(const fixed_point32<QR> &r) {
+        val = fixed_point256<Q>(fixed_point256<QR>(int128_t(r.val))).val;
     }
 
-    template<uint32_t q> template <uint32_t qr>
-    fixed_point256<q>::fixed_point256(const fixed_point32<qr> &r) {
-        val = assignHelper<int256_t>(r.val, q, qr);
+    /**
+    * @brief Addition between two fixed_point256 variables and the result goes to fixed_point256
+    *
+    * Number of decimal on result will be max of decimals of lhs and rhs
+    */
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point256< (Q>QR)?Q:QR > fixed_point256<Q>::operator+(const fixed_point256<QR> &rhs) const
+    {
+        return fixed_point256<(Q>QR)?Q:QR>( detail::limbs_add(
+            fixed_point256<(Q>QR)?Q:QR>( *this ).val,
+            fixed_point256<(Q>QR)?Q:QR>( rhs ).val ) );
+    }
+
+    /**
+    * @brief Subtraction between two fixed_point256 variables and the result goes to fixed_point256
+    *
+    * Number of decimal on result will be max of decimals of lhs and rhs
+    */
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point256< (Q>QR)?Q:QR > fixed_point256<Q>::operator-(const fixed_point256<QR> &rhs) const
+    {
+        return fixed_point256<(Q>QR)?Q:QR>( detail::limbs_sub(
+            fixed_point256<(Q>QR)?Q:QR>( *this ).val,
+            fixed_point256<(Q>QR)?Q:QR>( rhs ).val ) );
+    }
+
+    /**
+    * @brief Multiplication operator for fixed_point256
+    *
+    * @details The magnitudes are multiplied into a 512-bit product which is then scaled back by QR bits
+    * @note The result keeps the number of decimals of lhs
+    */
+    template<uint8_t Q> template <uint8_t QR>
+    fixed_point256<Q> fixed_point256<Q>::operator*(const fixed_point256<QR> &r) const {
+        const bool negative = detail::limbs_negative(val) != detail::limbs_negative(r.val);
+        const auto a = detail::limbs_abs(val);
+        const auto b = detail::limbs_abs(r.val);
+        std::array<uint64_t, 8> product;
+        detail::limbs_mul(a.data(), 4, b.data(), 4, product.data());
+        product = detail::limbs_shr(product, QR);
+        eosio::check( (product[4] | product[5] | product[6] | product[7]) == 0 && (product[3] >> 63) == 0,
+                      "fixed_point256 multiplication overflow" );
+        const detail::limbs256_t result{{ product[0], product[1], product[2], product[3] }};
+        return fixed_point256<Q>( negative ? detail::limbs_negate(result) : result );
+    }
+
+    /**
+    * @brief Division operator for fixed_point256
+    *
+    * @details The dividend is widened to 512 bits and pre-scaled by QR bits, so the quotient keeps the
+    * number of decimals of lhs. A divisor that fits in a single limb only needs 128/64 division steps.
+    */
+    template<uint8_t Q> template <uint8_t QR>
+    fixed_point256<Q> fixed_point256<Q>::operator/(const fixed_point256<QR> &r) const {
+        const bool negative = detail::limbs_negative(val) != detail::limbs_negative(r.val);
+        const auto a = detail::limbs_abs(val);
+        const auto b = detail::limbs_abs(r.val);
+        const size_t n = detail::limbs_size(b.data(), 4);
+        eosio::check( n != 0, "divide by zero" );
+
+        const auto dividend = detail::limbs_shl(std::array<uint64_t, 8>{{ a[0], a[1], a[2], a[3], 0, 0, 0, 0 }}, QR);
+        const size_t m = detail::limbs_size(dividend.data(), 8);
+        std::array<uint64_t, 8> quotient{};
+        if (m >= n)
+            detail::limbs_divmod(dividend.data(), m, b.data(), n, quotient.data(), nullptr);
+        eosio::check( (quotient[4] | quotient[5] | quotient[6] | quotient[7]) == 0 && (quotient[3] >> 63) == 0,
+                      "fixed_point256 division overflow" );
+        const detail::limbs256_t result{{ quotient[0], quotient[1], quotient[2], quotient[3] }};
+        return fixed_point256<Q>( negative ? detail::limbs_negate(result) : result );
     }
-#endif
 
     // fixed_point128 methods
     template<uint8_t Q> template<uint8_t QR>
@@ -643,6 +1123,78 @@ namespace eosio
     }
 
 
+    /**
+    * @brief Addition between two fixed_point128 variables and the result goes to fixed_point128
+    *
+    * Number of decimal on result will be max of decimals of lhs and rhs
+    */
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point128< (Q>QR)?Q:QR > fixed_point128<Q>::operator+(const fixed_point128<QR> &rhs) const
+    {
+        if(Q == QR)
+        {
+            return fixed_point128<Q>(val + rhs.val);
+        }
+        return fixed_point128<(Q>QR)?Q:QR>(
+            fixed_point128<(Q>QR)?Q:QR>( *this ).val +
+            fixed_point128<(Q>QR)?Q:QR>( rhs ).val
+        );
+    }
+
+    /**
+    * @brief Subtraction between two fixed_point128 variables and the result goes to fixed_point128
+    *
+    * Number of decimal on result will be max of decimals of lhs and rhs
+    */
+    template<uint8_t Q> template<uint8_t QR>
+    fixed_point128< (Q>QR)?Q:QR > fixed_point128<Q>::operator-(const fixed_point128<QR> &rhs) const
+    {
+        if(Q == QR)
+        {
+            return fixed_point128<Q>(val - rhs.val);
+        }
+        return fixed_point128<(Q>QR)?Q:QR>(
+            fixed_point128<(Q>QR)?Q:QR>( *this ).val -
+            fixed_point128<(Q>QR)?Q:QR>( rhs ).val
+        );
+    }
+
+    /**
+    * @brief Multiplication operator for fixed_point128. The result goes to fixed_point256
+    *
+    * @note Number of decimal on result will be sum of number of decimals of lhs and rhs
+    */
+    template<uint8_t Q> template <uint8_t QR>
+    fixed_point256<Q+QR> fixed_point128<Q>::operator*(const fixed_point128<QR> &r) const {
+        const auto a = detail::limbs_abs(detail::limbs_from_int128(val));
+        const auto b = detail::limbs_abs(detail::limbs_from_int128(r.val));
+        detail::limbs256_t product;
+        detail::limbs_mul(a.data(), 2, b.data(), 2, product.data());
+        const bool negative = (val < 0) != (r.val < 0);
+        return fixed_point256<Q+QR>( negative ? detail::limbs_negate(product) : product );
+    }
+
+    /**
+    * Division of two fixed_point128 result will be stored in fixed_point256
+    *
+    * @details Q(X+128-Y) = Q(X+128) / Q(Y). A divisor below 2^64 only needs 128/64 division steps.
+    */
+    template <uint8_t Q> template <uint8_t QR>
+    fixed_point256<Q+128-QR> fixed_point128<Q>::operator/(const fixed_point128<QR> &r) const {
+        eosio::check( r.val != 0, "divide by zero" );
+        const auto a = detail::limbs_abs(detail::limbs_from_int128(val));
+        const auto b = detail::limbs_abs(detail::limbs_from_int128(r.val));
+        const uint64_t dividend[4] = { 0, 0, a[0], a[1] };
+        const size_t m = detail::limbs_size(dividend, 4);
+        const size_t n = detail::limbs_size(b.data(), 2);
+        detail::limbs256_t quotient{};
+        if (m >= n)
+            detail::limbs_divmod(dividend, m, b.data(), n, quotient.data(), nullptr);
+        eosio::check( (quotient[3] >> 63) == 0, "fixed_point256 division overflow" );
+        const bool negative = (val < 0) != (r.val < 0);
+        return fixed_point256<Q+128-QR>( negative ? detail::limbs_negate(quotient) : quotient );
+    }
+
     // fixed_point64 methods
     template<uint8_t Q> template<uint8_t QR>
     fixed_point64<Q>::fixed_point64(const fixed_point64<QR> &r) {
@@ -707,7 +1259,13 @@ namespace eosio
     */
     template<uint8_t Q> template <uint8_t QR>
     fixed_point128<Q+QR> fixed_point64<Q>::operator*(const fixed_point64<QR> &r) const {
-        return fixed_point128<Q+QR>(int128_t(val)*r.val);
+        // 64x64 product from 32-bit partial products instead of a generic 128-bit multiply
+        uint64_t hi = 0;
+        uint64_t lo = 0;
+        detail::umul64(detail::magnitude(val), detail::magnitude(r.val), hi, lo);
+        const uint128_t product = (uint128_t(hi) << 64) | lo;
+        const bool negative = (val < 0) != (r.val < 0);
+        return fixed_point128<Q+QR>(negative ? -int128_t(product) : int128_t(product));
     }
 
     /**
@@ -720,11 +1278,12 @@ namespace eosio
     */
     template <uint8_t Q> template <uint8_t QR>
     fixed_point128<Q+64-QR> fixed_point64<Q>::operator/(const fixed_point64<QR> &r) const {
-        // std::cout << "Performing division on " << val << ", with " << q << " precision / " << r.val << ", with " << qr << " precision. Result precision " << ((q>qr) ? q:qr) << std::endl;
-        // Convert val to 128 bit by additionally shifting 64 bit and take the result to 128bit
         // Q(X+64-Y) = Q(X+64) / Q(Y)
-       eosio::check( !(r.int_part() == 0 && r.frac_part() == 0), "divide by zero" );
-        return fixed_point128<Q+64-QR>((int128_t(val)<<64)/r.val);
+        // The low 64 bits of the shifted dividend are zero and the divisor fits in 64 bits, so the
+        // quotient is formed with two 64-bit division steps rather than a generic 128-bit division
+        eosio::check( r.val != 0, "divide by zero" );
+        const bool negative = (val < 0) != (r.val < 0);
+        return fixed_point128<Q+64-QR>(detail::div128by64(detail::magnitude(val), 0, negative, detail::magnitude(r.val)));
     }
 
     // fixed_point32 methods
@@ -851,7 +1410,7 @@ namespace eosio
     {
 
         eosio::check( rhs != 0, "divide by zero" );
-        fixed_point128<Q> result = fixed_point64<0>((int32_t)lhs) / fixed_point64<0>((int32_t)rhs);
+        fixed_point128<Q> result = fixed_point64<0>((int64_t)lhs) / fixed_point64<0>((int64_t)rhs);
         return fixed_point128<Q>(result);
     }
 
@@ -2,6 +2,9 @@
 
 #include <eosiolib/eosio.hpp>
 #include <eosiolib/singleton.hpp>
+#include <eosiolib/merkle.hpp>
+
+#include <algorithm>
 
 namespace eosio {
 
@@ -40,11 +43,203 @@ namespace eosio {
       }
    };
 
+   // many packets under one header, packets[i].seq must be first_seq + i
+   struct icp_packet_batch {
+      name peer;
+      uint64_t first_seq = 0;
+      std::vector<icp_sendaction> packets;
+
+      uint64_t last_seq() const { return first_seq + packets.size() - 1; }
+
+      void validate() const {
+         eosio_assert(!packets.empty(), "empty packet batch");
+         for (size_t i = 0; i < packets.size(); ++i) {
+            eosio_assert(packets[i].seq == first_seq + i, "packet batch sequence is not contiguous");
+         }
+      }
+   };
+
+   // inclusive range of sequence numbers
+   struct seq_range {
+      uint64_t first = 0;
+      uint64_t last = 0;
+   };
+
+   // set of sequence numbers as sorted, disjoint and non adjacent ranges
+   struct seq_range_set {
+      std::vector<seq_range> ranges;
+
+      bool empty() const { return ranges.empty(); }
+
+      // checks a set unpacked from action data: every range well formed, sorted and disjoint
+      void validate() const {
+         for (size_t i = 0; i < ranges.size(); ++i) {
+            eosio_assert(ranges[i].first <= ranges[i].last, "invalid sequence range");
+            eosio_assert(i == 0 || ranges[i - 1].last < ranges[i].first, "sequence ranges are not sorted and disjoint");
+         }
+      }
+
+      bool contains(uint64_t seq) const {
+         auto itr = std::upper_bound(ranges.begin(), ranges.end(), seq, [](uint64_t v, const seq_range& r) { return v < r.first; });
+         return itr != ranges.begin() && std::prev(itr)->last >= seq;
+      }
+
+      // returns false when the set already contained [first, last]
+      bool insert(uint64_t seq) { return insert(seq, seq); }
+
+      bool insert(uint64_t first, uint64_t last) {
+         eosio_assert(first <= last, "invalid sequence range");
+         // first range that overlaps or touches [first, last], written without + 1 so ranges ending at UINT64_MAX do not touch 0
+         auto begin = std::lower_bound(ranges.begin(), ranges.end(), first, [](const seq_range& r, uint64_t v) { return v > 0 && r.last < v - 1; });
+         if (begin != ranges.end() && begin->first <= first && last <= begin->last) {
+            return false;
+         }
+         auto end = begin;
+         for (; end != ranges.end() && (end->first == 0 || end->first - 1 <= last); ++end) {
+            first = std::min(first, end->first);
+            last = std::max(last, end->last);
+         }
+         if (begin == end) {
+            ranges.insert(begin, seq_range{first, last});
+         } else {
+            *begin = seq_range{first, last};
+            ranges.erase(begin + 1, end);
+         }
+         return true;
+      }
+
+      bool insert(const seq_range_set& other) {
+         bool changed = false;
+         for (const auto& r : other.ranges) {
+            changed = insert(r.first, r.last) || changed;
+         }
+         return changed;
+      }
+
+      // drops everything below `next` and returns the end of the run starting at `next`, or next - 1 if next is absent
+      uint64_t pop_contiguous(uint64_t next) {
+         auto itr = ranges.begin();
+         while (itr != ranges.end() && itr->last < next) {
+            ++itr;
+         }
+         uint64_t end = next - 1;
+         if (itr != ranges.end() && itr->first <= next) {
+            end = itr->last;
+            ++itr;
+         }
+         ranges.erase(ranges.begin(), itr);
+         return end;
+      }
+   };
+
+   // outgoing receipts acknowledged by the peer out of order, above last_finalised_outgoing_receipt_seq
+   struct icp_receipt_acks {
+      seq_range_set pending;
+   };
+
    typedef eosio::singleton<"peer"_n, peer_contract> peer_singleton;
+   typedef eosio::singleton<"rcptacks"_n, icp_receipt_acks> receipt_acks_singleton;
+
+   // accumulators over all outgoing packets and receipts, proofs are checked against their roots on the peer chain
+   typedef eosio::singleton<"pktmerkle"_n, incremental_merkle> packet_merkle_singleton;
+   typedef eosio::singleton<"rcptmerkle"_n, incremental_merkle> receipt_merkle_singleton;
 
-   uint64_t next_packet_seq(name code) {
+   // records acknowledged outgoing receipts and advances last_finalised_outgoing_receipt_seq over the contiguous prefix
+   inline uint64_t finalise_receipts(name code, const seq_range_set& acked) {
+      peer_singleton peers(code, code.value);
+      auto peer = peers.get_or_default(peer_contract{});
+      eosio_assert(bool(peer.peer), "empty peer icp contract");
+      acked.validate();
+      // sorted, so the last range holds the largest sequence number
+      eosio_assert(acked.empty() || acked.ranges.back().last <= peer.last_outgoing_receipt_seq, "acknowledged receipt was never sent");
+
+      receipt_acks_singleton acks(code, code.value);
+      auto state = acks.get_or_default(icp_receipt_acks{});
+      const bool inserted = state.pending.insert(acked);
+
+      const size_t pending_ranges = state.pending.ranges.size();
+      const uint64_t finalised = state.pending.pop_contiguous(peer.last_finalised_outgoing_receipt_seq + 1);
+      if (finalised != peer.last_finalised_outgoing_receipt_seq) {
+         peer.last_finalised_outgoing_receipt_seq = finalised;
+         peers.set(peer, code);
+      }
+      // pop_contiguous only ever erases ranges, so an unchanged count means nothing was popped
+      if (inserted || state.pending.ranges.size() != pending_ranges) {
+         acks.set(state, code);
+      }
+      return finalised;
+   }
+
+   // reads the peer row on every call, use icp_session when allocating more than one sequence number per action
+   inline uint64_t next_packet_seq(name code) {
       auto peer = peer_singleton(code, code.value).get_or_default(peer_contract{});
       eosio_assert(bool(peer.peer), "empty peer icp contract");
       return peer.last_outgoing_packet_seq + 1;
    }
+
+   // loads the peer row once and allocates sequence numbers in memory, commit() writes the counters back
+   class icp_session {
+   public:
+      explicit icp_session(name code)
+      : _code(code), _peers(code, code.value), _peer(_peers.get_or_default(peer_contract{})) {
+         eosio_assert(bool(_peer.peer), "empty peer icp contract");
+      }
+
+      icp_session(const icp_session&) = delete;
+      icp_session& operator=(const icp_session&) = delete;
+
+      const peer_contract& peer() const { return _peer; }
+
+      uint64_t next_packet_seq() { return allocate_packet_seqs(1).first; }
+
+      seq_range allocate_packet_seqs(uint64_t count) {
+         eosio_assert(count > 0, "cannot allocate an empty sequence range");
+         seq_range range{_peer.last_outgoing_packet_seq + 1, _peer.last_outgoing_packet_seq + count};
+         _peer.last_outgoing_packet_seq = range.last;
+         _dirty = true;
+         return range;
+      }
+
+      uint64_t next_receipt_seq() {
+         _dirty = true;
+         return ++_peer.last_outgoing_receipt_seq;
+      }
+
+      // numbers the packets consecutively and wraps them into one batch
+      icp_packet_batch make_batch(std::vector<icp_sendaction> packets) {
+         const auto range = allocate_packet_seqs(packets.size());
+         for (size_t i = 0; i < packets.size(); ++i) {
+            packets[i].seq = range.first + i;
+         }
+         return icp_packet_batch{_peer.peer, range.first, std::move(packets)};
+      }
+
+      void accept_packet_batch(const icp_packet_batch& batch) {
+         batch.validate();
+         eosio_assert(batch.first_seq == _peer.last_incoming_packet_seq + 1, "unexpected packet batch sequence");
+         _peer.last_incoming_packet_seq = batch.last_seq();
+         _dirty = true;
+      }
+
+      // nothing is written unless this is called, a session dropped without it leaves the peer row untouched
+      void commit() {
+         if (_dirty) {
+            _peers.set(_peer, _code);
+            _dirty = false;
+         }
+      }
+
+   private:
+      name _code;
+      peer_singleton _peers;
+      peer_contract _peer;
+      bool _dirty = false;
+   };
+
+   // accepts a whole incoming batch with one read and one write of the peer row
+   inline void accept_packet_batch(name code, const icp_packet_batch& batch) {
+      icp_session session(code);
+      session.accept_packet_batch(batch);
+      session.commit();
+   }
 }
@@ -0,0 +1,232 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+#include "system.hpp"
+
+#include <limits>
+#include <type_traits>
+
+namespace eosio {
+
+   /**
+    *  @addtogroup math Math C++ API
+    *  @ingroup cpp_api
+    *  @brief Overflow checked integer arithmetic that avoids the 128-bit compiler builtins
+    *
+    *  @details Computing `(a*b)/c` through `uint128_t` lowers to `__multi3` and `__udivti3`/`__divti3`,
+    *  which are comparatively expensive in WASM. The helpers in this group only ever issue 64-bit
+    *  multiplications and divisions.
+    *  @{
+    */
+
+   /**
+    * Rounding mode used when a quotient is not exact
+    */
+   enum class rounding : uint8_t {
+      toward_zero = 0, ///< discard the remainder (C++ integer division)
+      down        = 1, ///< round toward negative infinity
+      up          = 2, ///< round toward positive infinity
+      nearest     = 3  ///< round to nearest, ties away from zero
+   };
+
+   namespace detail {
+
+      /**
+       * Number of leading zero bits of a non-zero 64-bit value
+       */
+      constexpr int clz64( uint64_t v ) {
+         return __builtin_clzll( v );
+      }
+
+      /**
+       * Full 64x64 -> 128 bit unsigned product using four 32-bit partial products
+       *
+       * @param a - First factor
+       * @param b - Second factor
+       * @param hi - Receives the upper 64 bits of the product
+       * @param lo - Receives the lower 64 bits of the product
+       */
+      constexpr void umul64( uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo ) {
+         const uint64_t a_lo = a & 0xFFFFFFFFull;
+         const uint64_t a_hi = a >> 32;
+         const uint64_t b_lo = b & 0xFFFFFFFFull;
+         const uint64_t b_hi = b >> 32;
+
+         const uint64_t ll = a_lo * b_lo;
+         const uint64_t lh = a_lo * b_hi;
+         const uint64_t hl = a_hi * b_lo;
+         const uint64_t hh = a_hi * b_hi;
+
+         const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFull) + (hl & 0xFFFFFFFFull);
+         lo = (mid << 32) | (ll & 0xFFFFFFFFull);
+         hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+      }
+
+      /**
+       * Divide the 128-bit value `u1:u0` by `v`, using only 64-bit divisions
+       *
+       * @details Knuth's algorithm D specialised to a two digit divisor (Hacker's Delight, divlu).
+       * @pre `u1 < v`, i.e. the quotient fits in 64 bits
+       * @param u1 - Upper 64 bits of the dividend
+       * @param u0 - Lower 64 bits of the dividend
+       * @param v - Divisor
+       * @param r - Receives the remainder
+       * @return uint64_t - The quotient
+       */
+      constexpr uint64_t udiv128by64( uint64_t u1, uint64_t u0, uint64_t v, uint64_t& r ) {
+         constexpr uint64_t b = 1ull << 32;
+
+         const int s = clz64( v );
+         v <<= s;
+         const uint64_t vn1 = v >> 32;
+         const uint64_t vn0 = v & 0xFFFFFFFFull;
+
+         const uint64_t un32 = (u1 << s) | (s == 0 ? 0 : (u0 >> (64 - s)));
+         const uint64_t un10 = u0 << s;
+         const uint64_t un1  = un10 >> 32;
+         const uint64_t un0  = un10 & 0xFFFFFFFFull;
+
+         uint64_t q1   = un32 / vn1;
+         uint64_t rhat = un32 - q1 * vn1;
+         while( q1 >= b || q1 * vn0 > b * rhat + un1 ) {
+            --q1;
+            rhat += vn1;
+            if( rhat >= b ) break;
+         }
+
+         const uint64_t un21 = un32 * b + un1 - q1 * v;
+         uint64_t q0 = un21 / vn1;
+         rhat = un21 - q0 * vn1;
+         while( q0 >= b || q0 * vn0 > b * rhat + un0 ) {
+            --q0;
+            rhat += vn1;
+            if( rhat >= b ) break;
+         }
+
+         r = (un21 * b + un0 - q0 * v) >> s;
+         return q1 * b + q0;
+      }
+
+      /**
+       * Adjust a truncated quotient magnitude according to the rounding mode
+       *
+       * @return true - if the magnitude has to be incremented by one
+       */
+      constexpr bool round_up_magnitude( uint64_t rem, uint64_t divisor, bool negative, rounding mode ) {
+         if( rem == 0 )
+            return false;
+         switch( mode ) {
+            case rounding::down:    return negative;
+            case rounding::up:      return !negative;
+            case rounding::nearest: return rem >= divisor - rem;
+            default:                return false;
+         }
+      }
+
+      /**
+       * Unsigned `(a*b)/c` with rounding, without any overflow checks on the result
+       *
+       * @param overflow - Set to true if the quotient does not fit in 64 bits
+       */
+      constexpr uint64_t umul_div( uint64_t a, uint64_t b, uint64_t c, bool negative, rounding mode, bool& overflow ) {
+         uint64_t q = 0;
+         uint64_t r = 0;
+         overflow = false;
+         if( ((a | b) >> 32) == 0 ) {
+            // both factors fit in 32 bits, the product fits in 64 bits
+            const uint64_t p = a * b;
+            q = p / c;
+            r = p - q * c;
+         } else {
+            uint64_t hi = 0;
+            uint64_t lo = 0;
+            umul64( a, b, hi, lo );
+            if( hi == 0 ) {
+               q = lo / c;
+               r = lo - q * c;
+            } else if( hi < c ) {
+               q = udiv128by64( hi, lo, c, r );
+            } else {
+               overflow = true;
+               return 0;
+            }
+         }
+         if( round_up_magnitude( r, c, negative, mode ) ) {
+            if( q == std::numeric_limits<uint64_t>::max() ) {
+               overflow = true;
+               return 0;
+            }
+            ++q;
+         }
+         return q;
+      }
+
+      constexpr uint64_t magnitude( int64_t v ) {
+         return v < 0 ? uint64_t(0) - uint64_t(v) : uint64_t(v);
+      }
+
+      /// 10^i for i = 0..19, every power of ten that fits in 64 bits
+      static constexpr uint64_t pow10_table[20] = {
+         1ull, 10ull, 100ull, 1000ull,
+         10000ull, 100000ull, 1000000ull, 10000000ull,
+         100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+         1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+         10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+      };
+   } /// namespace detail
+
+   /**
+    * Power of ten from a constant table
+    *
+    * @param exp - Exponent, at most 19
+    * @return uint64_t - 10^exp
+    */
+   constexpr uint64_t pow10( uint8_t exp ) {
+      if( exp >= 20 ) {
+         eosio::check( false, "pow10 exponent out of range" );
+      }
+      return detail::pow10_table[exp];
+   }
+
+   /**
+    * Compute `(a*b)/c` exactly, without an intermediate overflow and with the requested rounding
+    *
+    * @details The 128-bit intermediate product is formed from 32-bit partial products and is divided with
+    * 64-bit divisions only. If both factors fit in 32 bits no 128-bit arithmetic is performed at all.
+    * Works for any signed or unsigned integral type of at most 64 bits.
+    *
+    * @param a - First factor
+    * @param b - Second factor
+    * @param c - Divisor
+    * @param mode - Rounding applied to an inexact quotient
+    * @return T - The quotient
+    * @pre `c != 0` and the quotient is representable as a T, otherwise the action is aborted
+    *
+    * Example:
+    * @code
+    * uint64_t fee = eosio::mul_div( amount, fee_bps, uint64_t(10000), eosio::rounding::up );
+    * @endcode
+    */
+   template <typename T, typename = std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8>>
+   inline T mul_div( T a, T b, T c, rounding mode = rounding::toward_zero ) {
+      eosio::check( c != 0, "divide by zero" );
+      bool overflow = false;
+      if constexpr( std::is_signed<T>::value ) {
+         const bool negative = (a < 0) != (b < 0) && a != 0 && b != 0;
+         const bool neg_q    = negative != (c < 0);
+         const uint64_t q = detail::umul_div( detail::magnitude(a), detail::magnitude(b), detail::magnitude(c), neg_q, mode, overflow );
+         const uint64_t limit = neg_q ? uint64_t(0) - uint64_t(std::numeric_limits<T>::min())
+                                      : uint64_t(std::numeric_limits<T>::max());
+         eosio::check( !overflow && q <= limit, "mul_div overflow" );
+         return neg_q ? T(uint64_t(0) - q) : T(q);
+      } else {
+         const uint64_t q = detail::umul_div( a, b, c, false, mode, overflow );
+         eosio::check( !overflow && q <= uint64_t(std::numeric_limits<T>::max()), "mul_div overflow" );
+         return T(q);
+      }
+   }
+
+   /// @} math
+}
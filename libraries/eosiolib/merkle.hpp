@@ -0,0 +1,156 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+#include "crypto.hpp"
+
+#include <vector>
+
+namespace eosio {
+
+   /**
+    *  @addtogroup merkle Merkle Accumulator C++ API
+    *  @ingroup cpp_api
+    *  @brief Append-only merkle tree that only keeps its frontier
+    *
+    *  @details A leaf enters the tree as `sha256(0x00 || leaf)` and nodes are combined pairwise with
+    *  `sha256(0x01 || left || right)`. The prefixes keep an interior node from passing as a leaf with a shorter
+    *  proof. A node without a right sibling is
+    *  promoted unchanged to the next level, so the tree over `n` leaves is fully determined by `n` and the leaves
+    *  and no padding hashes are needed. Appending a leaf and computing the root both cost O(log n) hashes, and a
+    *  proof for a single leaf holds at most ceil(log2(n)) sibling hashes.
+    *  @{
+    */
+
+   /**
+    * Node of a leaf, `sha256(0x00 || leaf)`
+    *
+    * @param leaf - Hash of the leaf
+    * @return checksum256 - The node at the bottom level of the tree
+    */
+   inline checksum256 merkle_hash_leaf( const checksum256& leaf ) {
+      uint8_t buffer[1 + 32];
+      buffer[0] = 0x00;
+      leaf.write_as_bytes( buffer + 1 );
+      return sha256( reinterpret_cast<const char*>(buffer), sizeof(buffer) );
+   }
+
+   /**
+    * Hash of an interior node, `sha256(0x01 || left || right)`
+    *
+    * @param left - Left child
+    * @param right - Right child
+    * @return checksum256 - The parent node
+    */
+   inline checksum256 merkle_hash_pair( const checksum256& left, const checksum256& right ) {
+      uint8_t buffer[1 + 2 * 32];
+      buffer[0] = 0x01;
+      left.write_as_bytes( buffer + 1 );
+      right.write_as_bytes( buffer + 1 + 32 );
+      return sha256( reinterpret_cast<const char*>(buffer), sizeof(buffer) );
+   }
+
+   /**
+    * Incremental merkle accumulator
+    *
+    * @details Holds one node per set bit of `leaf_count`: the roots of the complete subtrees covering all leaves
+    * appended so far, largest subtree first. The serialized size is therefore `8 + 1 + 32 * popcount(leaf_count)`
+    * bytes no matter how many leaves were appended, which makes it cheap to keep in a singleton.
+    *
+    * Example:
+    * @code
+    * eosio::singleton<"packets"_n, incremental_merkle> packets( _self, _self.value );
+    * auto acc = packets.get_or_default();
+    * acc.append( sha256( data.data(), data.size() ) );
+    * packets.set( acc, _self );
+    * @endcode
+    */
+   struct incremental_merkle {
+      /**
+       * Number of leaves appended so far
+       */
+      uint64_t leaf_count = 0;
+
+      /**
+       * Roots of the complete subtrees, ordered from the largest (highest set bit of leaf_count) to the smallest
+       */
+      std::vector<checksum256> frontier;
+
+      /**
+       * Append a leaf
+       *
+       * @param leaf - Hash of the new leaf
+       * @return uint64_t - Index of the appended leaf
+       */
+      uint64_t append( const checksum256& leaf ) {
+         checksum256 node = merkle_hash_leaf( leaf );
+         // merging mirrors a binary increment, one hash per trailing one bit of leaf_count
+         for( uint64_t n = leaf_count; n & 1; n >>= 1 ) {
+            node = merkle_hash_pair( frontier.back(), node );
+            frontier.pop_back();
+         }
+         frontier.push_back( node );
+         return leaf_count++;
+      }
+
+      /**
+       * Root of the tree over all leaves appended so far
+       *
+       * @return checksum256 - The root, all zero bytes for an empty tree
+       */
+      checksum256 root()const {
+         if( frontier.empty() )
+            return checksum256();
+         checksum256 node = frontier.back();
+         for( auto itr = frontier.rbegin() + 1; itr != frontier.rend(); ++itr )
+            node = merkle_hash_pair( *itr, node );
+         return node;
+      }
+
+      EOSLIB_SERIALIZE( incremental_merkle, (leaf_count)(frontier) )
+   };
+
+   /**
+    * Check that a leaf is part of the tree with the given root
+    *
+    * @param leaf - Hash of the leaf
+    * @param index - Position of the leaf, starting at 0
+    * @param leaf_count - Number of leaves in the tree the root was computed over
+    * @param path - Sibling nodes from the leaf level up, levels where the node is promoted have no entry
+    * @param root - Expected root
+    * @return true - if the path leads from the leaf to the root
+    */
+   inline bool verify_merkle_proof( const checksum256& leaf, uint64_t index, uint64_t leaf_count,
+                                    const std::vector<checksum256>& path, const checksum256& root ) {
+      if( index >= leaf_count )
+         return false;
+      checksum256 node = merkle_hash_leaf( leaf );
+      auto sibling = path.begin();
+      for( uint64_t width = leaf_count; width > 1; width = (width + 1) / 2, index /= 2 ) {
+         if( (index & 1) == 0 && index == width - 1 )
+            continue; // no right sibling, promoted unchanged
+         if( sibling == path.end() )
+            return false;
+         node = (index & 1) ? merkle_hash_pair( *sibling, node ) : merkle_hash_pair( node, *sibling );
+         ++sibling;
+      }
+      return sibling == path.end() && node == root;
+   }
+
+   /**
+    * Check that a leaf is part of the tree with the given root, aborting the action otherwise
+    *
+    * @param leaf - Hash of the leaf
+    * @param index - Position of the leaf, starting at 0
+    * @param leaf_count - Number of leaves in the tree the root was computed over
+    * @param path - Sibling hashes from the leaf level up
+    * @param root - Expected root
+    */
+   inline void assert_merkle_proof( const checksum256& leaf, uint64_t index, uint64_t leaf_count,
+                                    const std::vector<checksum256>& path, const checksum256& root ) {
+      eosio::check( verify_merkle_proof( leaf, index, leaf_count, path, root ), "invalid merkle proof" );
+   }
+
+   /// @} merkle
+}
@@ -240,6 +240,38 @@ namespace eosio {
       : value( (symbol_code(ss).raw() << 8)  | static_cast<uint64_t>(precision) )
       {}
 
+      /**
+       * Construct a new symbol from its string representation, e.g. "4,EOS"
+       *
+       * @brief Construct a new symbol object from a string of the form precision,CODE
+       * @param str - The string containing the precision and the symbol code separated by a comma
+       *
+       */
+      constexpr explicit symbol( std::string_view str )
+      : value(0)
+      {
+         const auto comma = str.find( ',' );
+         if( comma == std::string_view::npos || comma == 0 || comma > 2 ) {
+            eosio::check( false, "symbol string must be of the form precision,CODE" );
+         }
+         uint64_t precision = 0;
+         for( size_t i = 0; i < comma; ++i ) {
+            if( str[i] < '0' || str[i] > '9' ) {
+               eosio::check( false, "symbol precision must be a number" );
+            }
+            precision = precision * 10 + (str[i] - '0');
+         }
+         if( precision > max_precision ) {
+            eosio::check( false, "symbol precision must be at most 18" );
+         }
+         value = (symbol_code( str.substr(comma + 1) ).raw() << 8) | precision;
+      }
+
+      /**
+       * Largest precision an asset amount can be formatted or parsed with
+       */
+      static constexpr uint8_t max_precision = 18;
+
       /**
        * Is this symbol valid
        */
@@ -400,3 +432,18 @@ namespace eosio {
 
    /// @}
 }
+
+/**
+ * %symbol literal operator
+ *
+ * @brief "4,EOS"_sym is a shortcut for symbol{"4,EOS"}, evaluated at compile time
+ * @return constexpr eosio::symbol - the parsed symbol
+ */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+template <typename T, T... Str>
+inline constexpr eosio::symbol operator""_sym() {
+   constexpr auto x = eosio::symbol{std::string_view{eosio::detail::to_const_char_arr<Str...>::value, sizeof...(Str)}};
+   return x;
+}
+#pragma clang diagnostic pop
@@ -0,0 +1,234 @@
+#include "bench.hpp"
+#include "crt.hpp"
+#include "host.hpp"
+#include "intrinsics.hpp"
+
+#include <eosiolib/system.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+   extern bool ___disable_output;
+}
+
+namespace eosio { namespace native {
+
+   namespace {
+      // stops calibrating even if the clock does not move
+      constexpr uint64_t max_batch_size = 1000000000;
+
+      void write_out( const std::string& s ) { host::write_stdout(s.data(), s.size()); }
+
+      // picoseconds as nanoseconds with three decimals
+      std::string format_ns( uint64_t ps ) {
+         std::string frac = std::to_string(ps % 1000);
+         return std::to_string(ps / 1000) + "." + std::string(3 - frac.size(), '0') + frac;
+      }
+
+      std::string format_change( uint64_t current, uint64_t base ) {
+         const int64_t permille = (int64_t(current) - int64_t(base)) * 1000 / int64_t(base);
+         const uint64_t abs_permille = permille < 0 ? -permille : permille;
+         return std::string(permille < 0 ? "-" : "+") + std::to_string(abs_permille / 10) + "." +
+                std::to_string(abs_permille % 10) + "%";
+      }
+
+      bool starts_with( const std::string& s, const char* prefix ) {
+         return s.compare(0, strlen(prefix), prefix) == 0;
+      }
+   }
+
+   bool bench_state::next_batch() {
+      const uint64_t now     = host::monotonic_ns();
+      const uint64_t elapsed = now - _batch_start;
+      switch (_phase) {
+         case phase::start:
+            _phase      = phase::calibrate;
+            _batch_size = 1;
+            break;
+         case phase::calibrate:
+            if (elapsed < _opts.min_sample_ns && _batch_size < max_batch_size) {
+               const uint64_t target = elapsed ? _batch_size * _opts.min_sample_ns / elapsed + 1 : _batch_size * 10;
+               _batch_size = std::min(_batch_size * 10, std::max(_batch_size * 2, target));
+            } else {
+               _phase      = phase::warmup;
+               _warmup_end = now + _opts.warmup_ns;
+            }
+            break;
+         case phase::warmup:
+            if (now >= _warmup_end) {
+               _phase = phase::measure;
+               intrinsics::reset_call_counts();
+               intrinsics::count_calls(true);
+            }
+            break;
+         case phase::measure:
+            _samples_ps.push_back(elapsed * 1000 / _batch_size);
+            if (_samples_ps.size() >= _opts.samples) {
+               intrinsics::count_calls(false);
+               _phase = phase::done;
+               return false;
+            }
+            break;
+         case phase::done:
+            return false;
+      }
+      // this call is the first operation of the batch
+      _remaining   = _batch_size - 1;
+      _batch_start = host::monotonic_ns();
+      return true;
+   }
+
+   bench_result bench_state::result( const std::string& name )const {
+      bench_result r;
+      r.name    = name;
+      r.samples = _samples_ps.size();
+      if (_samples_ps.empty())
+         return r;
+      r.iterations = _batch_size * _samples_ps.size();
+
+      std::vector<uint64_t> sorted = _samples_ps;
+      std::sort(sorted.begin(), sorted.end());
+      const size_t n = sorted.size();
+      r.median_ps = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+      r.p99_ps    = sorted[(n * 99 + 99) / 100 - 1];
+      r.min_ps    = sorted.front();
+      uint64_t sum = 0;
+      for (uint64_t s : sorted)
+         sum += s;
+      r.mean_ps = sum / n;
+
+      for (const auto& count : intrinsics::call_counts())
+         r.intrinsic_calls.emplace_back(count.first, count.second * 1000 / r.iterations);
+      return r;
+   }
+
+   bench_runner::bench_runner( int argc, char** argv ) {
+      for (int i = 1; i < argc; i++) {
+         const std::string arg = argv[i];
+         if (arg == "--json")
+            _json = true;
+         else if (starts_with(arg, "--baseline="))
+            _baseline = arg.substr(11);
+         else if (starts_with(arg, "--threshold="))
+            _threshold = std::atoi(arg.c_str() + 12);
+         else if (starts_with(arg, "--samples="))
+            _opts.samples = std::max(std::atoi(arg.c_str() + 10), 1);
+         else if (starts_with(arg, "--warmup-ms="))
+            _opts.warmup_ns = uint64_t(std::atoi(arg.c_str() + 12)) * 1000000;
+         else
+            _filter.push_back(arg);
+      }
+   }
+
+   void bench_runner::run( const char* name, bench_function bench ) {
+      if (!_filter.empty() && std::find(_filter.begin(), _filter.end(), name) == _filter.end())
+         return;
+      bench_state state(_opts);
+      const bool disable_output = ___disable_output;
+      ___disable_output = true;
+      if (catch_assert([&]() { bench(state); })) {
+         _results.push_back(state.result(name));
+      } else {
+         intrinsics::count_calls(false);
+         write_out(std::string("benchmark ") + name + " failed: " + std_err.to_string() + "\n");
+         _failed = true;
+      }
+      ___disable_output = disable_output;
+   }
+
+   int bench_runner::finish() {
+      std::map<std::string, uint64_t> baseline;
+      if (!_baseline.empty()) {
+         std::string contents;
+         if (!host::read_file(_baseline, contents)) {
+            write_out("could not read baseline " + _baseline + "\n");
+            return 1;
+         }
+         baseline = parse_baseline(contents);
+      }
+
+      if (_json) {
+         write_out(to_json(_results));
+      } else {
+         for (const auto& r : _results) {
+            std::string line = r.name + ": median " + format_ns(r.median_ps) + " ns/op, p99 " + format_ns(r.p99_ps) +
+                               " ns/op, min " + format_ns(r.min_ps) + " ns/op, " + std::to_string(r.iterations) +
+                               " iterations";
+            auto base = baseline.find(r.name);
+            if (base != baseline.end() && base->second != 0)
+               line += ", " + format_change(r.median_ps, base->second) + " vs baseline";
+            write_out(line + "\n");
+            for (const auto& calls : r.intrinsic_calls)
+               write_out("   " + calls.first + " " + format_ns(calls.second) + " calls/op\n");
+         }
+      }
+
+      const auto regressed = regressions(_results, baseline, _threshold);
+      if (!_json)
+         for (const auto& name : regressed)
+            write_out("regression: " + name + " is more than " + std::to_string(_threshold) + "% slower than the baseline\n");
+      return _failed || !regressed.empty() ? 1 : 0;
+   }
+
+   std::string bench_runner::to_json( const std::vector<bench_result>& results ) {
+      std::string json = "{\n  \"benchmarks\": [";
+      for (size_t i = 0; i < results.size(); i++) {
+         const auto& r = results[i];
+         json += std::string(i ? "," : "") + "\n    {\"name\": \"" + r.name + "\", \"iterations\": " +
+                 std::to_string(r.iterations) + ", \"samples\": " + std::to_string(r.samples) +
+                 ", \"median_ns\": " + format_ns(r.median_ps) + ", \"p99_ns\": " + format_ns(r.p99_ps) +
+                 ", \"min_ns\": " + format_ns(r.min_ps) + ", \"mean_ns\": " + format_ns(r.mean_ps) +
+                 ", \"intrinsic_calls_per_op\": {";
+         for (size_t j = 0; j < r.intrinsic_calls.size(); j++)
+            json += std::string(j ? ", " : "") + "\"" + r.intrinsic_calls[j].first + "\": " +
+                    format_ns(r.intrinsic_calls[j].second);
+         json += "}}";
+      }
+      return json + "\n  ]\n}\n";
+   }
+
+   std::map<std::string, uint64_t> bench_runner::parse_baseline( const std::string& json ) {
+      // only reads what to_json() writes: a name followed by its median in nanoseconds with up to 3 decimals
+      std::map<std::string, uint64_t> baseline;
+      size_t pos = 0;
+      while ((pos = json.find("\"name\": \"", pos)) != std::string::npos) {
+         pos += 9;
+         const size_t name_end = json.find('"', pos);
+         const size_t median   = json.find("\"median_ns\": ", name_end);
+         if (name_end == std::string::npos || median == std::string::npos)
+            break;
+         const std::string name = json.substr(pos, name_end - pos);
+         uint64_t ps = 0;
+         size_t i = median + 13;
+         for (; i < json.size() && json[i] >= '0' && json[i] <= '9'; i++)
+            ps = ps * 10 + (json[i] - '0');
+         uint32_t decimals = 0;
+         if (i < json.size() && json[i] == '.')
+            for (i++; i < json.size() && json[i] >= '0' && json[i] <= '9'; i++)
+               if (decimals < 3) {
+                  ps = ps * 10 + (json[i] - '0');
+                  decimals++;
+               }
+         for (; decimals < 3; decimals++)
+            ps *= 10;
+         baseline[name] = ps;
+         pos = i;
+      }
+      return baseline;
+   }
+
+   std::vector<std::string> bench_runner::regressions( const std::vector<bench_result>& results,
+                                                       const std::map<std::string, uint64_t>& baseline,
+                                                       uint32_t threshold_percent ) {
+      std::vector<std::string> regressed;
+      for (const auto& r : results) {
+         auto base = baseline.find(r.name);
+         if (base != baseline.end() && r.median_ps * 100 > base->second * (100 + threshold_percent))
+            regressed.push_back(r.name);
+      }
+      return regressed;
+   }
+
+}} //ns eosio::native
@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    * Keep the compiler from optimizing away the computation of `value`
+    */
+   template <typename T>
+   inline void do_not_optimize( const T& value ) {
+      asm volatile("" : : "r,m"(value) : "memory");
+   }
+
+   struct bench_options {
+      uint32_t samples        = 25;
+      uint64_t warmup_ns      = 100000000; ///< time spent running the loop before measuring
+      uint64_t min_sample_ns  = 1000000;   ///< each sample runs enough iterations to take at least this long
+   };
+
+   /**
+    * Statistics of one benchmark, times are in picoseconds per operation
+    */
+   struct bench_result {
+      std::string name;
+      uint64_t    iterations = 0; ///< measured iterations, warm-up excluded
+      uint32_t    samples    = 0;
+      uint64_t    median_ps  = 0;
+      uint64_t    p99_ps     = 0;
+      uint64_t    min_ps     = 0;
+      uint64_t    mean_ps    = 0;
+      std::vector<std::pair<std::string, uint64_t>> intrinsic_calls; ///< intrinsic calls per 1000 operations
+   };
+
+   /**
+    * Drives the loop of one benchmark: calibration, warm-up, then the measured samples
+    *
+    * keep_running() is true while the benchmark should run another operation, between batches it reads the
+    * clock and decides the size of the next batch, so the clock is never read per operation.
+    */
+   class bench_state {
+      public:
+         explicit bench_state( const bench_options& opts ) : _opts(opts) {}
+
+         bool keep_running() {
+            if (_remaining != 0) {
+               --_remaining;
+               return true;
+            }
+            return next_batch();
+         }
+
+         bench_result result( const std::string& name )const;
+
+      private:
+         enum class phase { start, calibrate, warmup, measure, done };
+
+         bool next_batch();
+
+         bench_options         _opts;
+         phase                 _phase       = phase::start;
+         uint64_t              _remaining   = 0;
+         uint64_t              _batch_size  = 1;
+         uint64_t              _batch_start = 0;
+         uint64_t              _warmup_end  = 0;
+         std::vector<uint64_t> _samples_ps;
+   };
+
+   /**
+    * Runs the benchmarks of one binary and reports them
+    *
+    * Command line:
+    * - `--json` prints the results as JSON instead of a table
+    * - `--baseline=FILE` compares the median of every benchmark against a file written with `--json` and fails
+    *   when one got slower by more than `--threshold=PERCENT` (10 by default)
+    * - `--samples=N`, `--warmup-ms=N` tune the measurement
+    * - any other argument selects benchmarks by name
+    *
+    * Example:
+    * @code
+    * EOSIO_BENCH_BEGIN(name_to_string)
+    *    eosio::name n("eosio.token");
+    *    EOSIO_BENCH_LOOP {
+    *       do_not_optimize(n.to_string());
+    *    }
+    * EOSIO_BENCH_END
+    *
+    * int main(int argc, char** argv) {
+    *    bench_runner bench(argc, argv);
+    *    EOSIO_BENCH(bench, name_to_string);
+    *    return bench.finish();
+    * }
+    * @endcode
+    */
+   class bench_runner {
+      public:
+         using bench_function = void(*)(bench_state&);
+
+         bench_runner( int argc, char** argv );
+
+         void run( const char* name, bench_function bench );
+
+         /**
+          * Print the report and compare against the baseline
+          *
+          * @return 0, or 1 if a benchmark regressed or the baseline could not be read
+          */
+         int finish();
+
+         const std::vector<bench_result>& results()const { return _results; }
+
+         static std::string to_json( const std::vector<bench_result>& results );
+
+         /**
+          * Median picoseconds per operation of every benchmark in a file written by to_json()
+          */
+         static std::map<std::string, uint64_t> parse_baseline( const std::string& json );
+
+         /**
+          * Names of the benchmarks slower than their baseline by more than `threshold_percent`
+          */
+         static std::vector<std::string> regressions( const std::vector<bench_result>& results,
+                                                      const std::map<std::string, uint64_t>& baseline,
+                                                      uint32_t threshold_percent );
+
+      private:
+         bench_options             _opts;
+         bool                      _json      = false;
+         std::string               _baseline;
+         uint32_t                  _threshold = 10;
+         bool                      _failed    = false;
+         std::vector<std::string>  _filter;
+         std::vector<bench_result> _results;
+   };
+
+}} //ns eosio::native
+
+#define EOSIO_BENCH_BEGIN(X) \
+   void X(eosio::native::bench_state& __bench_state) {
+
+#define EOSIO_BENCH_LOOP \
+   while (__bench_state.keep_running())
+
+#define EOSIO_BENCH_END \
+   }
+
+#define EOSIO_BENCH(RUNNER, X) \
+   RUNNER.run(#X, X);
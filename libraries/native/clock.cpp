@@ -0,0 +1,29 @@
+#include "clock.hpp"
+#include "intrinsics.hpp"
+
+namespace eosio { namespace native {
+
+   void virtual_clock::set( eosio::time_point t ) {
+      eosio_assert(t >= _now, "virtual clock cannot go backwards");
+      _now = t;
+   }
+
+   void install_clock_intrinsics() {
+      intrinsics::set_intrinsic<intrinsics::current_time>([]() {
+            return (uint64_t)virtual_clock::get().now().time_since_epoch().count();
+         });
+      intrinsics::set_intrinsic<intrinsics::publication_time>([]() {
+            return (uint64_t)virtual_clock::get().now().time_since_epoch().count();
+         });
+      intrinsics::set_intrinsic<intrinsics::expiration>([]() {
+            return virtual_clock::get().expiration().sec_since_epoch();
+         });
+      intrinsics::set_intrinsic<intrinsics::tapos_block_num>([]() {
+            return (int)virtual_clock::get().tapos_block_num();
+         });
+      intrinsics::set_intrinsic<intrinsics::tapos_block_prefix>([]() {
+            return (int)virtual_clock::get().tapos_block_prefix();
+         });
+   }
+
+}} //ns eosio::native
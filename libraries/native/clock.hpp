@@ -0,0 +1,70 @@
+#pragma once
+#include <eosiolib/time.hpp>
+
+#include <cstdint>
+
+namespace eosio { namespace native {
+
+   /**
+    * Simulated chain time for native tests
+    *
+    * Backs current_time, publication_time, expiration and the TaPoS intrinsics. Time only moves when a test
+    * calls set() or advance(), so weeks of chain time pass in a single call. Block numbers are derived from the
+    * time elapsed since genesis with the nodeos block interval of 500ms.
+    */
+   class virtual_clock {
+      public:
+         static constexpr int64_t  block_interval_us      = 500000;
+         static constexpr uint32_t default_expiration_sec = 60;
+         /// nodeos' default genesis timestamp, 2018-06-01T12:00:00
+         static constexpr int64_t  genesis_time_us        = 1527854400ll * 1000000;
+
+         static virtual_clock& get() {
+            static virtual_clock inst;
+            return inst;
+         }
+
+         eosio::time_point now()const { return _now; }
+
+         /**
+          * Move the clock to `t`, which must not be in the past
+          */
+         void set( eosio::time_point t );
+
+         void advance( eosio::microseconds delta ) { set(_now + delta); }
+
+         /**
+          * Go back to genesis, for use between test cases
+          */
+         void reset() { _now = eosio::time_point(eosio::microseconds(genesis_time_us)); }
+
+         /**
+          * Put the clock back to `t`, for restoring snapshots
+          */
+         void restore( eosio::time_point t ) { _now = t; }
+
+         uint32_t head_block_num()const {
+            return 1 + uint32_t((_now.time_since_epoch().count() - genesis_time_us) / block_interval_us);
+         }
+
+         uint16_t tapos_block_num()const { return uint16_t(head_block_num() & 0xffff); }
+
+         /**
+          * Stand-in for the second word of the head block id, stable for a given block number
+          */
+         uint32_t tapos_block_prefix()const { return head_block_num() * 2654435761u; }
+
+         eosio::time_point_sec expiration()const {
+            return eosio::time_point_sec(_now) + default_expiration_sec;
+         }
+
+      private:
+         eosio::time_point _now = eosio::time_point(eosio::microseconds(genesis_time_us));
+   };
+
+   /**
+    * Route the time and TaPoS intrinsics to virtual_clock::get(), called before main() runs
+    */
+   void install_clock_intrinsics();
+
+}} //ns eosio::native
@@ -1,9 +1,15 @@
 #include <eosiolib/name.hpp>
 #include <eosiolib/action.hpp>
+#include <eosiolib/charconv.hpp>
 #include "intrinsics.hpp"
+#include "database.hpp"
+#include "clock.hpp"
+#include "crypto.hpp"
 #include "crt.hpp"
+#include "host.hpp"
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <stdio.h>
 #include <setjmp.h>
 
@@ -30,25 +36,16 @@ extern "C" {
    bool ___has_failed;
 
    void _prints_l(const char* cstr, uint32_t len, uint8_t which) {
-      for (int i=0; i < len; i++) {
-         if (which == eosio::cdt::output_stream_kind::std_out)
-            std_out.push(cstr[i]);
-         else if (which == eosio::cdt::output_stream_kind::std_err)
-            std_err.push(cstr[i]);
-         if (!___disable_output)
-            ___putc(cstr[i]);
-      }
+      if (which == eosio::cdt::output_stream_kind::std_out)
+         std_out.write(cstr, len);
+      else if (which == eosio::cdt::output_stream_kind::std_err)
+         std_err.write(cstr, len);
+      if (!___disable_output)
+         eosio::native::host::write_stdout(cstr, len);
    }
 
    void _prints(const char* cstr, uint8_t which) {
-      for (int i=0; cstr[i] != '\0'; i++) {
-         if (which == eosio::cdt::output_stream_kind::std_out)
-            std_out.push(cstr[i]);
-         else if (which == eosio::cdt::output_stream_kind::std_err)
-            std_err.push(cstr[i]);
-         if (!___disable_output)
-            ___putc(cstr[i]);
-      }
+      _prints_l(cstr, strlen(cstr), which);
    }
 
    void __set_env_test() {
@@ -73,55 +70,61 @@ extern "C" {
             _prints(cs, eosio::cdt::output_stream_kind::std_out);
          });
       intrinsics::set_intrinsic<intrinsics::printi>([](int64_t v) {
-            printf("%lli\n", v);
+            char buff[eosio::max_integer_chars];
+            char* end = eosio::to_chars(buff, buff + sizeof(buff), v);
+            _prints_l(buff, end - buff, eosio::cdt::output_stream_kind::std_out);
          });
       intrinsics::set_intrinsic<intrinsics::printui>([](uint64_t v) {
-            printf("%llu\n", v);
+            char buff[eosio::max_integer_chars];
+            char* end = eosio::to_chars(buff, buff + sizeof(buff), v);
+            _prints_l(buff, end - buff, eosio::cdt::output_stream_kind::std_out);
          });
       intrinsics::set_intrinsic<intrinsics::printi128>([](const int128_t* v) {
-            int* tmp = (int*)v;
-            printf("0x%04x%04x%04x%04x\n", tmp[0], tmp[1], tmp[2], tmp[3]);
+            char buff[eosio::max_integer_chars];
+            char* end = eosio::to_chars(buff, buff + sizeof(buff), *v);
+            _prints_l(buff, end - buff, eosio::cdt::output_stream_kind::std_out);
          });
       intrinsics::set_intrinsic<intrinsics::printui128>([](const uint128_t* v) {
-            int* tmp = (int*)v;
-            printf("0x%04x%04x%04x%04x\n", tmp[0], tmp[1], tmp[2], tmp[3]);
+            char buff[eosio::max_integer_chars];
+            char* end = eosio::to_chars(buff, buff + sizeof(buff), *v);
+            _prints_l(buff, end - buff, eosio::cdt::output_stream_kind::std_out);
          });
+      // scientific notation with digits10 significant digits after the point, as nodeos prints them
       intrinsics::set_intrinsic<intrinsics::printsf>([](float v) {
-            char buff[512] = {0};
-            std::string ret = std::to_string((int)v);
-            memcpy(buff, ret.c_str(), ret.size());
-            v -= (int)v;
-            buff[ret.size()] = '.';
-            size_t size = ret.size(); 
-            for (size_t i=size+1; i < size+10; i++) {
-               v *= 10; 
-               buff[i] = ((int)v)+'0';
-               v -= (int)v;
-            }
-            prints(buff);
+            char buff[64];
+            int len = snprintf(buff, sizeof(buff), "%.*e", std::numeric_limits<float>::digits10, (double)v);
+            _prints_l(buff, len, eosio::cdt::output_stream_kind::std_out);
          });
       intrinsics::set_intrinsic<intrinsics::printdf>([](double v) {
-            char buff[512] = {0};
-            std::string ret = std::to_string((long)v);
-            memcpy(buff, ret.c_str(), ret.size());
-            v -= (long)v;
-            buff[ret.size()] = '.';
-            size_t size = ret.size(); 
-            for (size_t i=size+1; i < size+10; i++) {
-               v *= 10; 
-               buff[i] = ((int)v)+'0';
-               v -= (int)v;
-            }
-            prints(buff);
+            char buff[64];
+            int len = snprintf(buff, sizeof(buff), "%.*e", std::numeric_limits<double>::digits10, v);
+            _prints_l(buff, len, eosio::cdt::output_stream_kind::std_out);
          });
       intrinsics::set_intrinsic<intrinsics::printqf>([](const long double* v) {
-            int* tmp = (int*)v;
-            printf("0x%04x%04x%04x%04x\n", tmp[0], tmp[1], tmp[2], tmp[3]);
+            char buff[64];
+            int len = snprintf(buff, sizeof(buff), "%.*Le", std::numeric_limits<long double>::digits10, *v);
+            _prints_l(buff, len, eosio::cdt::output_stream_kind::std_out);
+         });
+      intrinsics::set_intrinsic<intrinsics::printhex>([](const void* data, uint32_t len) {
+            static const char digits[] = "0123456789abcdef";
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            char buff[128];
+            for (uint32_t i = 0; i < len;) {
+               uint32_t n = 0;
+               for (; i < len && n < sizeof(buff); i++) {
+                  buff[n++] = digits[bytes[i] >> 4];
+                  buff[n++] = digits[bytes[i] & 0xf];
+               }
+               _prints_l(buff, n, eosio::cdt::output_stream_kind::std_out);
+            }
          });
       intrinsics::set_intrinsic<intrinsics::printn>([](uint64_t nm) {
             std::string s = eosio::name(nm).to_string();
             prints_l(s.c_str(), s.length());
          });
+      install_database_intrinsics();
+      install_clock_intrinsics();
+      crypto::install_crypto_intrinsics();
 
       jmp_ret = setjmp(env); 
       if (jmp_ret == 0) {
@@ -129,6 +132,7 @@ extern "C" {
       } else {
          ret_val = -1;
       }
+      host::flush_stdout();
       return ret_val;
    }
 
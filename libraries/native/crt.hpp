@@ -1,5 +1,8 @@
 #pragma once
 #include <setjmp.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 
 namespace eosio { namespace cdt {
    enum output_stream_kind {
@@ -7,13 +10,57 @@ namespace eosio { namespace cdt {
       std_err,
       none
    };
-   struct output_stream {
-      char output[1024*2];
-      size_t index = 0;
-      std::string to_string()const { return std::string((const char*)output, index); }
-      const char* get()const { return output; }
-      void push(char c) { output[index++] = c; }
-      void clear() { index = 0; }
+
+   /**
+    * Everything printed to one stream, kept for CHECK_PRINT and CHECK_ASSERT
+    *
+    * Grows one fixed size chunk at a time, so appending never copies what was captured before. Constant
+    * initialized, the native crt does not run global constructors.
+    */
+   class output_stream {
+      public:
+         static constexpr size_t chunk_size = 4096;
+
+         size_t index = 0; ///< number of characters captured
+
+         void push( char c ) { write(&c, 1); }
+
+         void write( const char* data, size_t len ) {
+            while (len != 0) {
+               if (index == _nchunks * chunk_size)
+                  grow();
+               const size_t offset = index % chunk_size;
+               const size_t n = len < chunk_size - offset ? len : chunk_size - offset;
+               memcpy(_chunks[index / chunk_size] + offset, data, n);
+               index += n;
+               data  += n;
+               len   -= n;
+            }
+         }
+
+         std::string to_string()const {
+            std::string s;
+            s.reserve(index);
+            for (size_t i = 0; i < index; i += chunk_size)
+               s.append(_chunks[i / chunk_size], index - i < chunk_size ? index - i : chunk_size);
+            return s;
+         }
+
+         std::string get()const { return to_string(); }
+
+         /**
+          * Forget the captured output, the chunks are kept for reuse
+          */
+         void clear() { index = 0; }
+
+      private:
+         void grow() {
+            _chunks = (char**)realloc(_chunks, (_nchunks + 1) * sizeof(char*));
+            _chunks[_nchunks++] = (char*)malloc(chunk_size);
+         }
+
+         char** _chunks  = nullptr;
+         size_t _nchunks = 0;
    };
 }} //ns eosio::cdt
 
@@ -28,3 +75,26 @@ extern "C" {
    void _prints_l(const char* cstr, uint32_t len, uint8_t which);
    void _prints(const char* cstr, uint8_t which);
 }
+
+namespace eosio { namespace native {
+   /**
+    * Call `func`, returning false instead of unwinding further if it fails an eosio_assert
+    *
+    * The assert is caught in the global env, which CHECK_ASSERT inside `func` points ___env_ptr back to. Its
+    * previous contents are restored afterwards, so a later assert does not longjmp into this returned frame.
+    */
+   template <typename F>
+   inline bool catch_assert( F&& func ) {
+      __reset_env();
+      jmp_buf prev_env;
+      memcpy(&prev_env, ___env_ptr, sizeof(jmp_buf));
+      volatile bool completed = false;
+      if (setjmp(*___env_ptr) == 0) {
+         func();
+         completed = true;
+      }
+      __reset_env();
+      memcpy(___env_ptr, &prev_env, sizeof(jmp_buf));
+      return completed;
+   }
+}} //ns eosio::native
@@ -0,0 +1,702 @@
+#include "crypto.hpp"
+
+#include <eosiolib/system.h>
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace eosio { namespace native { namespace crypto {
+
+   namespace {
+      inline uint32_t rotl32( uint32_t x, int n ) { return (x << n) | (x >> (32 - n)); }
+      inline uint32_t rotr32( uint32_t x, int n ) { return (x >> n) | (x << (32 - n)); }
+      inline uint64_t rotr64( uint64_t x, int n ) { return (x >> n) | (x << (64 - n)); }
+
+      inline uint32_t load_be32( const uint8_t* p ) {
+         return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+      }
+      inline uint64_t load_be64( const uint8_t* p ) { return uint64_t(load_be32(p)) << 32 | load_be32(p + 4); }
+      inline uint32_t load_le32( const uint8_t* p ) {
+         return uint32_t(p[3]) << 24 | uint32_t(p[2]) << 16 | uint32_t(p[1]) << 8 | p[0];
+      }
+      inline void store_be32( uint8_t* p, uint32_t v ) {
+         p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+      }
+      inline void store_be64( uint8_t* p, uint64_t v ) {
+         store_be32(p, v >> 32);
+         store_be32(p + 4, v);
+      }
+      inline void store_le32( uint8_t* p, uint32_t v ) {
+         p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+      }
+
+      // -1 until the CPU was asked
+      int sha_extensions = -1;
+
+      bool detect_sha_extensions() {
+#if defined(__x86_64__)
+         unsigned eax, ebx, ecx, edx;
+         if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+         const bool ssse3_sse41 = (ecx & bit_SSSE3) && (ecx & bit_SSE4_1);
+         if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+         return ssse3_sse41 && (ebx & (1u << 29));
+#else
+         return false;
+#endif
+      }
+
+      bool use_sha_extensions() {
+         if (sha_extensions < 0)
+            sha_extensions = detect_sha_extensions();
+         return sha_extensions;
+      }
+
+      /**
+       * Merkle-Damgard padding shared by all four hashes, `Engine` supplies the compression function
+       */
+      template <typename Engine>
+      void hash_message( Engine& engine, const char* data, uint32_t length ) {
+         constexpr size_t block = Engine::block_size;
+         const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+         const size_t full = length / block;
+         if (full)
+            engine.compress(p, full);
+
+         uint8_t tail[2 * block] = {};
+         const size_t rem = length - full * block;
+         memcpy(tail, p + full * block, rem);
+         tail[rem] = 0x80;
+         const size_t tail_blocks = rem + 1 + Engine::length_size > block ? 2 : 1;
+         uint8_t* end = tail + tail_blocks * block;
+         const uint64_t bits = uint64_t(length) * 8;
+         for (int i = 0; i < 8; i++) {
+            if (Engine::big_endian)
+               end[-1 - i] = uint8_t(bits >> (8 * i));
+            else
+               end[-8 + i] = uint8_t(bits >> (8 * i));
+         }
+         engine.compress(tail, tail_blocks);
+      }
+
+      constexpr uint32_t sha256_k[64] = {
+         0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+         0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+         0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+         0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+         0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+         0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+         0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+         0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+      };
+
+      constexpr uint64_t sha512_k[80] = {
+         0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+         0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+         0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+         0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+         0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+         0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+         0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+         0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+         0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+         0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+         0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+         0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+         0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+         0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+         0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+         0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+         0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+         0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+         0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+         0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+      };
+
+      void sha1_compress_portable( uint32_t* h, const uint8_t* data, size_t blocks ) {
+         for (; blocks--; data += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; i++)
+               w[i] = load_be32(data + 4 * i);
+            for (int i = 16; i < 80; i++)
+               w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; i++) {
+               uint32_t f, k;
+               if (i < 20) {
+                  f = (b & c) | (~b & d);
+                  k = 0x5a827999;
+               } else if (i < 40) {
+                  f = b ^ c ^ d;
+                  k = 0x6ed9eba1;
+               } else if (i < 60) {
+                  f = (b & c) | (b & d) | (c & d);
+                  k = 0x8f1bbcdc;
+               } else {
+                  f = b ^ c ^ d;
+                  k = 0xca62c1d6;
+               }
+               const uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+               e = d;
+               d = c;
+               c = rotl32(b, 30);
+               b = a;
+               a = t;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+         }
+      }
+
+      void sha256_compress_portable( uint32_t* h, const uint8_t* data, size_t blocks ) {
+         for (; blocks--; data += 64) {
+            uint32_t w[64];
+            for (int i = 0; i < 16; i++)
+               w[i] = load_be32(data + 4 * i);
+            for (int i = 16; i < 64; i++) {
+               const uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+               const uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+               w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+            for (int i = 0; i < 64; i++) {
+               const uint32_t t1 = hh + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) + ((e & f) ^ (~e & g)) +
+                                   sha256_k[i] + w[i];
+               const uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+               hh = g; g = f; f = e; e = d + t1;
+               d = c; c = b; b = a; a = t1 + t2;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+         }
+      }
+
+#if defined(__x86_64__)
+      __attribute__((target("sha,sse4.1,ssse3")))
+      void sha1_compress_shani( uint32_t* h, const uint8_t* data, size_t blocks ) {
+         const __m128i mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+         __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1b);
+         __m128i e[2] = { _mm_set_epi32(h[4], 0, 0, 0), _mm_setzero_si128() };
+
+         for (; blocks--; data += 64) {
+            const __m128i abcd_save = abcd;
+            const __m128i e_save    = e[0];
+            __m128i m[4];
+            // 20 groups of 4 rounds, the message schedule runs 1 to 3 groups ahead
+            for (int i = 0; i < 20; i++) {
+               if (i < 4)
+                  m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * i)), mask);
+               __m128i& e_in = e[i % 2];
+               if (i == 0)
+                  e_in = _mm_add_epi32(e_in, m[0]);
+               else
+                  e_in = _mm_sha1nexte_epu32(e_in, m[i % 4]);
+               e[(i + 1) % 2] = abcd;
+               if (i >= 3 && i <= 18)
+                  m[(i + 1) % 4] = _mm_sha1msg2_epu32(m[(i + 1) % 4], m[i % 4]);
+               switch (i / 5) {
+                  case 0:  abcd = _mm_sha1rnds4_epu32(abcd, e_in, 0); break;
+                  case 1:  abcd = _mm_sha1rnds4_epu32(abcd, e_in, 1); break;
+                  case 2:  abcd = _mm_sha1rnds4_epu32(abcd, e_in, 2); break;
+                  default: abcd = _mm_sha1rnds4_epu32(abcd, e_in, 3); break;
+               }
+               if (i >= 1 && i <= 16)
+                  m[(i + 3) % 4] = _mm_sha1msg1_epu32(m[(i + 3) % 4], m[i % 4]);
+               if (i >= 2 && i <= 17)
+                  m[(i + 2) % 4] = _mm_xor_si128(m[(i + 2) % 4], m[i % 4]);
+            }
+            e[0] = _mm_sha1nexte_epu32(e[0], e_save);
+            abcd = _mm_add_epi32(abcd, abcd_save);
+         }
+         _mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(abcd, 0x1b));
+         h[4] = _mm_extract_epi32(e[0], 3);
+      }
+
+      __attribute__((target("sha,sse4.1,ssse3")))
+      void sha256_compress_shani( uint32_t* h, const uint8_t* data, size_t blocks ) {
+         const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+         const __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0xb1);
+         const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h + 4)), 0x1b);
+         __m128i state0 = _mm_alignr_epi8(cdab, efgh, 8);    // abef
+         __m128i state1 = _mm_blend_epi16(efgh, cdab, 0xf0); // cdgh
+
+         for (; blocks--; data += 64) {
+            const __m128i state0_save = state0;
+            const __m128i state1_save = state1;
+            __m128i m[4];
+            // 16 groups of 4 rounds, the message schedule runs 1 to 3 groups ahead
+            for (int i = 0; i < 16; i++) {
+               if (i < 4)
+                  m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * i)), mask);
+               __m128i msg = _mm_add_epi32(m[i % 4], _mm_loadu_si128((const __m128i*)(sha256_k + 4 * i)));
+               state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+               if (i >= 3 && i <= 14) {
+                  const __m128i t = _mm_alignr_epi8(m[i % 4], m[(i + 3) % 4], 4);
+                  m[(i + 1) % 4] = _mm_sha256msg2_epu32(_mm_add_epi32(m[(i + 1) % 4], t), m[i % 4]);
+               }
+               msg = _mm_shuffle_epi32(msg, 0x0e);
+               state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+               if (i >= 1 && i <= 12)
+                  m[(i + 3) % 4] = _mm_sha256msg1_epu32(m[(i + 3) % 4], m[i % 4]);
+            }
+            state0 = _mm_add_epi32(state0, state0_save);
+            state1 = _mm_add_epi32(state1, state1_save);
+         }
+         const __m128i feba = _mm_shuffle_epi32(state0, 0x1b);
+         const __m128i dchg = _mm_shuffle_epi32(state1, 0xb1);
+         _mm_storeu_si128((__m128i*)h, _mm_blend_epi16(feba, dchg, 0xf0));
+         _mm_storeu_si128((__m128i*)(h + 4), _mm_alignr_epi8(dchg, feba, 8));
+      }
+#endif
+
+      struct sha1_engine {
+         static constexpr size_t block_size  = 64;
+         static constexpr size_t length_size = 8;
+         static constexpr bool   big_endian  = true;
+         uint32_t h[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+         void compress( const uint8_t* data, size_t blocks ) {
+#if defined(__x86_64__)
+            if (use_sha_extensions())
+               return sha1_compress_shani(h, data, blocks);
+#endif
+            sha1_compress_portable(h, data, blocks);
+         }
+      };
+
+      struct sha256_engine {
+         static constexpr size_t block_size  = 64;
+         static constexpr size_t length_size = 8;
+         static constexpr bool   big_endian  = true;
+         uint32_t h[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                           0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+         void compress( const uint8_t* data, size_t blocks ) {
+#if defined(__x86_64__)
+            if (use_sha_extensions())
+               return sha256_compress_shani(h, data, blocks);
+#endif
+            sha256_compress_portable(h, data, blocks);
+         }
+      };
+
+      struct sha512_engine {
+         static constexpr size_t block_size  = 128;
+         static constexpr size_t length_size = 16;
+         static constexpr bool   big_endian  = true;
+         uint64_t h[8] = { 0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+                           0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179 };
+
+         void compress( const uint8_t* data, size_t blocks ) {
+            for (; blocks--; data += 128) {
+               uint64_t w[80];
+               for (int i = 0; i < 16; i++)
+                  w[i] = load_be64(data + 8 * i);
+               for (int i = 16; i < 80; i++) {
+                  const uint64_t s0 = rotr64(w[i - 15], 1) ^ rotr64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+                  const uint64_t s1 = rotr64(w[i - 2], 19) ^ rotr64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+                  w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+               }
+               uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+               for (int i = 0; i < 80; i++) {
+                  const uint64_t t1 = hh + (rotr64(e, 14) ^ rotr64(e, 18) ^ rotr64(e, 41)) + ((e & f) ^ (~e & g)) +
+                                      sha512_k[i] + w[i];
+                  const uint64_t t2 = (rotr64(a, 28) ^ rotr64(a, 34) ^ rotr64(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+                  hh = g; g = f; f = e; e = d + t1;
+                  d = c; c = b; b = a; a = t1 + t2;
+               }
+               h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+            }
+         }
+      };
+
+      struct ripemd160_engine {
+         static constexpr size_t block_size  = 64;
+         static constexpr size_t length_size = 8;
+         static constexpr bool   big_endian  = false;
+         uint32_t h[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+         static uint32_t f( int j, uint32_t x, uint32_t y, uint32_t z ) {
+            switch (j / 16) {
+               case 0:  return x ^ y ^ z;
+               case 1:  return (x & y) | (~x & z);
+               case 2:  return (x | ~y) ^ z;
+               case 3:  return (x & z) | (y & ~z);
+               default: return x ^ (y | ~z);
+            }
+         }
+
+         void compress( const uint8_t* data, size_t blocks ) {
+            static constexpr uint8_t r[80] = {
+               0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+               7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+               3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+               1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+               4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13 };
+            static constexpr uint8_t rr[80] = {
+               5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+               6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+               15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+               8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+               12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11 };
+            static constexpr uint8_t s[80] = {
+               11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+               7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+               11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+               11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+               9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6 };
+            static constexpr uint8_t ss[80] = {
+               8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+               9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+               9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+               15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+               8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11 };
+            static constexpr uint32_t k[5]  = { 0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e };
+            static constexpr uint32_t kk[5] = { 0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000 };
+
+            for (; blocks--; data += 64) {
+               uint32_t x[16];
+               for (int i = 0; i < 16; i++)
+                  x[i] = load_le32(data + 4 * i);
+               uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+               uint32_t aa = a, bb = b, cc = c, dd = d, ee = e;
+               for (int j = 0; j < 80; j++) {
+                  uint32_t t = rotl32(a + f(j, b, c, d) + x[r[j]] + k[j / 16], s[j]) + e;
+                  a = e; e = d; d = rotl32(c, 10); c = b; b = t;
+                  t = rotl32(aa + f(79 - j, bb, cc, dd) + x[rr[j]] + kk[j / 16], ss[j]) + ee;
+                  aa = ee; ee = dd; dd = rotl32(cc, 10); cc = bb; bb = t;
+               }
+               const uint32_t t = h[1] + c + dd;
+               h[1] = h[2] + d + ee;
+               h[2] = h[3] + e + aa;
+               h[3] = h[4] + a + bb;
+               h[4] = h[0] + b + cc;
+               h[0] = t;
+            }
+         }
+      };
+
+      /**
+       * secp256k1 arithmetic for key recovery
+       *
+       * Numbers are 4 little-endian 64 bit limbs. Both moduli are just below 2^256, so products are reduced by
+       * folding the high half back in as high * (2^256 - m). Recovery only handles public data, none of this is
+       * constant time.
+       */
+      struct u256 {
+         uint64_t v[4] = {};
+
+         bool is_zero()const { return (v[0] | v[1] | v[2] | v[3]) == 0; }
+         bool bit( int i )const { return (v[i / 64] >> (i % 64)) & 1; }
+
+         static u256 from_be( const uint8_t* p ) {
+            u256 r;
+            for (int i = 0; i < 4; i++)
+               r.v[3 - i] = load_be64(p + 8 * i);
+            return r;
+         }
+
+         void to_be( uint8_t* p )const {
+            for (int i = 0; i < 4; i++)
+               store_be64(p + 8 * i, v[3 - i]);
+         }
+
+         friend bool operator<( const u256& a, const u256& b ) {
+            for (int i = 3; i >= 0; i--)
+               if (a.v[i] != b.v[i])
+                  return a.v[i] < b.v[i];
+            return false;
+         }
+         friend bool operator==( const u256& a, const u256& b ) {
+            return memcmp(a.v, b.v, sizeof(a.v)) == 0;
+         }
+      };
+
+      uint64_t add_to( u256& a, const u256& b ) {
+         unsigned __int128 carry = 0;
+         for (int i = 0; i < 4; i++) {
+            carry += (unsigned __int128)a.v[i] + b.v[i];
+            a.v[i] = uint64_t(carry);
+            carry >>= 64;
+         }
+         return uint64_t(carry);
+      }
+
+      uint64_t sub_from( u256& a, const u256& b ) {
+         uint64_t borrow = 0;
+         for (int i = 0; i < 4; i++) {
+            const unsigned __int128 d = (unsigned __int128)a.v[i] - b.v[i] - borrow;
+            a.v[i] = uint64_t(d);
+            borrow = uint64_t(d >> 64) & 1;
+         }
+         return borrow;
+      }
+
+      struct modulus {
+         u256 m;
+         u256 fold;       ///< 2^256 - m
+         int  fold_limbs; ///< limbs of fold that are not zero
+
+         u256 add( u256 a, const u256& b )const {
+            if (add_to(a, b) || !(a < m))
+               sub_from(a, m);
+            return a;
+         }
+
+         u256 sub( u256 a, const u256& b )const {
+            if (sub_from(a, b))
+               add_to(a, m);
+            return a;
+         }
+
+         u256 mul( const u256& a, const u256& b )const {
+            uint64_t w[8] = {};
+            mul_wide(a, b, w);
+            return reduce(w);
+         }
+
+         u256 pow( const u256& a, const u256& e )const {
+            u256 r;
+            r.v[0] = 1;
+            for (int i = 255; i >= 0; i--) {
+               r = mul(r, r);
+               if (e.bit(i))
+                  r = mul(r, a);
+            }
+            return r;
+         }
+
+         // m is prime
+         u256 inverse( const u256& a )const {
+            u256 e = m;
+            u256 two;
+            two.v[0] = 2;
+            sub_from(e, two);
+            return pow(a, e);
+         }
+
+         static void mul_wide( const u256& a, const u256& b, uint64_t* w ) {
+            for (int i = 0; i < 4; i++) {
+               uint64_t carry = 0;
+               for (int j = 0; j < 4; j++) {
+                  const unsigned __int128 t = (unsigned __int128)a.v[i] * b.v[j] + w[i + j] + carry;
+                  w[i + j] = uint64_t(t);
+                  carry = uint64_t(t >> 64);
+               }
+               w[i + 4] = carry;
+            }
+         }
+
+         u256 reduce( uint64_t* w )const {
+            while (w[4] | w[5] | w[6] | w[7]) {
+               u256 high;
+               memcpy(high.v, w + 4, sizeof(high.v));
+               // fold is a single limb for the field, so only multiply its nonzero limbs
+               uint64_t folded[8] = {};
+               for (int i = 0; i < 4; i++) {
+                  uint64_t carry = 0;
+                  for (int j = 0; j < fold_limbs; j++) {
+                     const unsigned __int128 t = (unsigned __int128)high.v[i] * fold.v[j] + folded[i + j] + carry;
+                     folded[i + j] = uint64_t(t);
+                     carry = uint64_t(t >> 64);
+                  }
+                  folded[i + fold_limbs] = carry;
+               }
+               unsigned __int128 carry = 0;
+               for (int i = 0; i < 8; i++) {
+                  carry += (unsigned __int128)folded[i] + (i < 4 ? w[i] : 0);
+                  w[i] = uint64_t(carry);
+                  carry >>= 64;
+               }
+            }
+            u256 r;
+            memcpy(r.v, w, sizeof(r.v));
+            while (!(r < m))
+               sub_from(r, m);
+            return r;
+         }
+      };
+
+      const modulus field = {
+         {{ 0xfffffffefffffc2full, 0xffffffffffffffffull, 0xffffffffffffffffull, 0xffffffffffffffffull }},
+         {{ 0x00000001000003d1ull, 0, 0, 0 }}, 1 };
+      const modulus order = {
+         {{ 0xbfd25e8cd0364141ull, 0xbaaedce6af48a03bull, 0xfffffffffffffffeull, 0xffffffffffffffffull }},
+         {{ 0x402da1732fc9bebfull, 0x4551231950b75fc4ull, 0x0000000000000001ull, 0 }}, 3 };
+
+      /// jacobian coordinates, z == 0 is the point at infinity
+      struct point {
+         u256 x, y, z;
+         bool infinite()const { return z.is_zero(); }
+      };
+
+      point affine_point( const u256& x, const u256& y ) {
+         point p{x, y, {}};
+         p.z.v[0] = 1;
+         return p;
+      }
+
+      const point generator = affine_point(
+         {{ 0x59f2815b16f81798ull, 0x029bfcdb2dce28d9ull, 0x55a06295ce870b07ull, 0x79be667ef9dcbbacull }},
+         {{ 0x9c47d08ffb10d4b8ull, 0xfd17b448a6855419ull, 0x5da4fbfc0e1108a8ull, 0x483ada7726a3c465ull }});
+
+      point point_double( const point& p ) {
+         if (p.infinite() || p.y.is_zero())
+            return point{};
+         const auto& f = field;
+         const u256 a  = f.mul(p.x, p.x);
+         const u256 b  = f.mul(p.y, p.y);
+         const u256 c  = f.mul(b, b);
+         const u256 xb = f.add(p.x, b);
+         u256 d = f.sub(f.sub(f.mul(xb, xb), a), c);
+         d = f.add(d, d);
+         const u256 e  = f.add(f.add(a, a), a);
+         const u256 x3 = f.sub(f.mul(e, e), f.add(d, d));
+         u256 c8 = f.add(c, c);
+         c8 = f.add(c8, c8);
+         c8 = f.add(c8, c8);
+         const u256 y3 = f.sub(f.mul(e, f.sub(d, x3)), c8);
+         const u256 yz = f.mul(p.y, p.z);
+         return point{x3, y3, f.add(yz, yz)};
+      }
+
+      point point_add( const point& p, const point& q ) {
+         if (p.infinite())
+            return q;
+         if (q.infinite())
+            return p;
+         const auto& f = field;
+         const u256 z1z1 = f.mul(p.z, p.z);
+         const u256 z2z2 = f.mul(q.z, q.z);
+         const u256 u1   = f.mul(p.x, z2z2);
+         const u256 u2   = f.mul(q.x, z1z1);
+         const u256 s1   = f.mul(f.mul(p.y, q.z), z2z2);
+         const u256 s2   = f.mul(f.mul(q.y, p.z), z1z1);
+         const u256 h    = f.sub(u2, u1);
+         const u256 r    = f.sub(s2, s1);
+         if (h.is_zero())
+            return r.is_zero() ? point_double(p) : point{};
+         const u256 hh  = f.mul(h, h);
+         const u256 hhh = f.mul(h, hh);
+         const u256 v   = f.mul(u1, hh);
+         const u256 x3  = f.sub(f.sub(f.mul(r, r), hhh), f.add(v, v));
+         const u256 y3  = f.sub(f.mul(r, f.sub(v, x3)), f.mul(s1, hhh));
+         return point{x3, y3, f.mul(f.mul(p.z, q.z), h)};
+      }
+
+      // a * p + b * q, sharing the doublings
+      point double_mul( const u256& a, const point& p, const u256& b, const point& q ) {
+         const point pq = point_add(p, q);
+         point r;
+         for (int i = 255; i >= 0; i--) {
+            r = point_double(r);
+            const bool ba = a.bit(i), bb = b.bit(i);
+            if (ba && bb)
+               r = point_add(r, pq);
+            else if (ba)
+               r = point_add(r, p);
+            else if (bb)
+               r = point_add(r, q);
+         }
+         return r;
+      }
+   }
+
+   bool hardware_acceleration() { return use_sha_extensions(); }
+
+   void enable_hardware_acceleration( bool enable ) {
+      sha_extensions = enable && detect_sha_extensions();
+   }
+
+   void sha1( const char* data, uint32_t length, capi_checksum160* hash ) {
+      sha1_engine engine;
+      hash_message(engine, data, length);
+      for (int i = 0; i < 5; i++)
+         store_be32(hash->hash + 4 * i, engine.h[i]);
+   }
+
+   void sha256( const char* data, uint32_t length, capi_checksum256* hash ) {
+      sha256_engine engine;
+      hash_message(engine, data, length);
+      for (int i = 0; i < 8; i++)
+         store_be32(hash->hash + 4 * i, engine.h[i]);
+   }
+
+   void sha512( const char* data, uint32_t length, capi_checksum512* hash ) {
+      sha512_engine engine;
+      hash_message(engine, data, length);
+      for (int i = 0; i < 8; i++)
+         store_be64(hash->hash + 8 * i, engine.h[i]);
+   }
+
+   void ripemd160( const char* data, uint32_t length, capi_checksum160* hash ) {
+      ripemd160_engine engine;
+      hash_message(engine, data, length);
+      for (int i = 0; i < 5; i++)
+         store_le32(hash->hash + 4 * i, engine.h[i]);
+   }
+
+   int recover_key( const capi_checksum256* digest, const char* sig, size_t siglen, char* pub, size_t publen ) {
+      // packed signature: key type, then recovery id, r and s
+      eosio_assert(siglen == 66, "invalid signature size");
+      eosio_assert(sig[0] == 0, "only K1 signatures can be recovered in native builds");
+      eosio_assert(publen >= 34, "public key buffer too small");
+      const uint8_t* compact = reinterpret_cast<const uint8_t*>(sig + 1);
+      int v = compact[0];
+      eosio_assert(v >= 27 && v < 35, "unable to reconstruct public key from signature");
+      if (v >= 31)
+         v -= 4;
+      const int recid = v - 27;
+
+      const u256 r = u256::from_be(compact + 1);
+      const u256 s = u256::from_be(compact + 33);
+      eosio_assert(!r.is_zero() && r < order.m && !s.is_zero() && s < order.m,
+                   "unable to reconstruct public key from signature");
+
+      // x coordinate of the nonce point, r or r + n
+      u256 x = r;
+      if (recid & 2) {
+         eosio_assert(!add_to(x, order.m) && x < field.m, "unable to reconstruct public key from signature");
+      }
+      u256 seven;
+      seven.v[0] = 7;
+      const u256 y2 = field.add(field.mul(field.mul(x, x), x), seven);
+      // p = 3 mod 4, so the square root is y2^((p + 1) / 4)
+      u256 sqrt_exp = field.m;
+      u256 one;
+      one.v[0] = 1;
+      add_to(sqrt_exp, one);
+      for (int i = 0; i < 4; i++)
+         sqrt_exp.v[i] = (sqrt_exp.v[i] >> 2) | (i < 3 ? sqrt_exp.v[i + 1] << 62 : 0);
+      u256 y = field.pow(y2, sqrt_exp);
+      eosio_assert(field.mul(y, y) == y2, "unable to reconstruct public key from signature");
+      if ((y.v[0] & 1) != (recid & 1))
+         y = field.sub(u256{}, y);
+
+      u256 e = u256::from_be(digest->hash);
+      if (!(e < order.m))
+         sub_from(e, order.m);
+
+      // Q = r^-1 (sR - eG)
+      const u256 r_inv = order.inverse(r);
+      const u256 u1    = order.sub(u256{}, order.mul(e, r_inv));
+      const u256 u2    = order.mul(s, r_inv);
+      const point q    = double_mul(u1, generator, u2, affine_point(x, y));
+      eosio_assert(!q.infinite(), "unable to reconstruct public key from signature");
+
+      const u256 z_inv  = field.inverse(q.z);
+      const u256 z_inv2 = field.mul(z_inv, z_inv);
+      const u256 qx     = field.mul(q.x, z_inv2);
+      const u256 qy     = field.mul(q.y, field.mul(z_inv2, z_inv));
+
+      uint8_t* out = reinterpret_cast<uint8_t*>(pub);
+      out[0] = 0; // K1
+      out[1] = 2 | (qy.v[0] & 1);
+      qx.to_be(out + 2);
+      return 34;
+   }
+
+}}} //ns eosio::native::crypto
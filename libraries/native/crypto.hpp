@@ -0,0 +1,38 @@
+#pragma once
+#include <eosiolib/types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace eosio { namespace native { namespace crypto {
+
+   void sha1( const char* data, uint32_t length, capi_checksum160* hash );
+   void sha256( const char* data, uint32_t length, capi_checksum256* hash );
+   void sha512( const char* data, uint32_t length, capi_checksum512* hash );
+   void ripemd160( const char* data, uint32_t length, capi_checksum160* hash );
+
+   /**
+    * Recover the public key of a K1 signature the way nodeos does
+    *
+    * `sig` is a packed eosio::signature, the key is written to `pub` as a packed eosio::public_key.
+    *
+    * @return the size of the packed key
+    */
+   int recover_key( const capi_checksum256* digest, const char* sig, size_t siglen, char* pub, size_t publen );
+
+   /**
+    * Whether sha1 and sha256 run on the SHA extensions of the CPU
+    */
+   bool hardware_acceleration();
+
+   /**
+    * Turn the SHA extensions off, or back on if the CPU has them, to compare against the portable code
+    */
+   void enable_hardware_acceleration( bool enable );
+
+   /**
+    * Route the hash and key recovery intrinsics to the functions above, called before main() runs
+    */
+   void install_crypto_intrinsics();
+
+}}} //ns eosio::native::crypto
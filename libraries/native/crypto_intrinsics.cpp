@@ -0,0 +1,42 @@
+#include "crypto.hpp"
+#include "intrinsics.hpp"
+
+#include <cstring>
+
+namespace eosio { namespace native { namespace crypto {
+
+   void install_crypto_intrinsics() {
+      intrinsics::set_intrinsic<intrinsics::sha1>(crypto::sha1);
+      intrinsics::set_intrinsic<intrinsics::sha256>(crypto::sha256);
+      intrinsics::set_intrinsic<intrinsics::sha512>(crypto::sha512);
+      intrinsics::set_intrinsic<intrinsics::ripemd160>(crypto::ripemd160);
+      intrinsics::set_intrinsic<intrinsics::assert_sha1>([](const char* data, uint32_t length, const capi_checksum160* hash) {
+            capi_checksum160 result;
+            crypto::sha1(data, length, &result);
+            eosio_assert(memcmp(result.hash, hash->hash, sizeof(result.hash)) == 0, "hash mismatch");
+         });
+      intrinsics::set_intrinsic<intrinsics::assert_sha256>([](const char* data, uint32_t length, const capi_checksum256* hash) {
+            capi_checksum256 result;
+            crypto::sha256(data, length, &result);
+            eosio_assert(memcmp(result.hash, hash->hash, sizeof(result.hash)) == 0, "hash mismatch");
+         });
+      intrinsics::set_intrinsic<intrinsics::assert_sha512>([](const char* data, uint32_t length, const capi_checksum512* hash) {
+            capi_checksum512 result;
+            crypto::sha512(data, length, &result);
+            eosio_assert(memcmp(result.hash, hash->hash, sizeof(result.hash)) == 0, "hash mismatch");
+         });
+      intrinsics::set_intrinsic<intrinsics::assert_ripemd160>([](const char* data, uint32_t length, const capi_checksum160* hash) {
+            capi_checksum160 result;
+            crypto::ripemd160(data, length, &result);
+            eosio_assert(memcmp(result.hash, hash->hash, sizeof(result.hash)) == 0, "hash mismatch");
+         });
+      intrinsics::set_intrinsic<intrinsics::recover_key>(crypto::recover_key);
+      intrinsics::set_intrinsic<intrinsics::assert_recover_key>([](const capi_checksum256* digest, const char* sig, size_t siglen, const char* pub, size_t publen) {
+            char recovered[34];
+            crypto::recover_key(digest, sig, siglen, recovered, sizeof(recovered));
+            eosio_assert(publen == sizeof(recovered) && memcmp(recovered, pub, publen) == 0,
+                         "Error expected key different than recovered key");
+         });
+   }
+
+}}} //ns eosio::native::crypto
@@ -0,0 +1,274 @@
+#include "database.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace eosio { namespace native {
+
+   database::database( const database& other )
+      : idx64(other.idx64), idx128(other.idx128), idx256(other.idx256),
+        idx_double(other.idx_double), idx_long_double(other.idx_long_double),
+        _tables(other._tables), _ram(other._ram) {}
+
+   database& database::operator=( const database& other ) {
+      if (this != &other) {
+         idx64           = other.idx64;
+         idx128          = other.idx128;
+         idx256          = other.idx256;
+         idx_double      = other.idx_double;
+         idx_long_double = other.idx_long_double;
+         _keyval_cache.clear();
+         _tables = other._tables;
+         _ram    = other._ram;
+         _undo.clear();
+         _snapshots.clear();
+      }
+      return *this;
+   }
+
+   database::primary_table* database::find_table( uint64_t code, uint64_t scope, uint64_t table_name ) {
+      auto itr = _tables.find(table_id{code, scope, table_name});
+      // nodeos drops a table together with its last row
+      if (itr == _tables.end() || itr->second.rows.empty())
+         return nullptr;
+      return &itr->second;
+   }
+
+   int32_t database::store_i64( uint64_t receiver, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* buffer, uint32_t buffer_size ) {
+      eosio_assert(payer != 0, "must specify a valid account to pay for new record");
+      const table_id tid{receiver, scope, table};
+      auto& t = _tables.try_emplace(tid, primary_table{tid, 0, {}}).first->second;
+      auto res = t.rows.emplace(id, key_value_object{id, payer, {}});
+      eosio_assert(res.second, "could not insert object, most likely a uniqueness constraint was violated");
+      record(t, id, std::nullopt);
+      if (t.rows.size() == 1) {
+         t.payer = payer;
+         _ram.bill(payer, ram_ledger::table_overhead);
+      }
+      _ram.bill(payer, ram_ledger::key_value_overhead + buffer_size);
+      key_value_object& obj = res.first->second;
+      obj.value.assign((const char*)buffer, (const char*)buffer + buffer_size);
+      _keyval_cache.cache_table(t);
+      return _keyval_cache.add(t, obj);
+   }
+
+   void database::update_i64( uint64_t receiver, int32_t iterator, uint64_t payer, const void* buffer, uint32_t buffer_size ) {
+      key_value_object& obj = _keyval_cache.get(iterator);
+      const primary_table& t = _keyval_cache.get_table(iterator);
+      eosio_assert(t.id.code == receiver, "db access violation");
+      if (payer == 0)
+         payer = obj.payer;
+      record(t, obj.primary_key, obj);
+      const int64_t old_size = ram_ledger::key_value_overhead + obj.value.size();
+      const int64_t new_size = ram_ledger::key_value_overhead + buffer_size;
+      _ram.bill(obj.payer, -old_size);
+      _ram.bill(payer, new_size);
+      obj.payer = payer;
+      obj.value.assign((const char*)buffer, (const char*)buffer + buffer_size);
+   }
+
+   void database::remove_i64( uint64_t receiver, int32_t iterator ) {
+      key_value_object& obj = _keyval_cache.get(iterator);
+      primary_table& t = _keyval_cache.get_table(iterator);
+      eosio_assert(t.id.code == receiver, "db access violation");
+      record(t, obj.primary_key, obj);
+      _keyval_cache.remove(iterator);
+      _ram.bill(obj.payer, -(ram_ledger::key_value_overhead + int64_t(obj.value.size())));
+      t.rows.erase(obj.primary_key);
+      if (t.rows.empty())
+         _ram.bill(t.payer, -ram_ledger::table_overhead);
+   }
+
+   int32_t database::get_i64( int32_t iterator, void* buffer, uint32_t buffer_size ) {
+      const key_value_object& obj = _keyval_cache.get(iterator);
+      const uint32_t s = obj.value.size();
+      if (buffer_size == 0)
+         return s;
+      const uint32_t copy_size = std::min(buffer_size, s);
+      memcpy(buffer, obj.value.data(), copy_size);
+      return copy_size;
+   }
+
+   int32_t database::next_i64( int32_t iterator, uint64_t& primary ) {
+      if (iterator < -1)
+         return -1; // cannot increment past end iterator of table
+      const key_value_object& obj = _keyval_cache.get(iterator);
+      primary_table& t = _keyval_cache.get_table(iterator);
+      auto itr = t.rows.find(obj.primary_key);
+      ++itr;
+      if (itr == t.rows.end())
+         return _keyval_cache.cache_table(t);
+      primary = itr->first;
+      return _keyval_cache.add(t, itr->second);
+   }
+
+   int32_t database::previous_i64( int32_t iterator, uint64_t& primary ) {
+      if (iterator < -1) {
+         primary_table& t = _keyval_cache.find_table_by_end_iterator(iterator);
+         if (t.rows.empty())
+            return -1;
+         auto itr = std::prev(t.rows.end());
+         primary = itr->first;
+         return _keyval_cache.add(t, itr->second);
+      }
+      const key_value_object& obj = _keyval_cache.get(iterator);
+      primary_table& t = _keyval_cache.get_table(iterator);
+      auto itr = t.rows.find(obj.primary_key);
+      if (itr == t.rows.begin())
+         return -1; // cannot decrement past beginning iterator of table
+      --itr;
+      primary = itr->first;
+      return _keyval_cache.add(t, itr->second);
+   }
+
+   int32_t database::find_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id ) {
+      primary_table* t = find_table(code, scope, table);
+      if (!t)
+         return -1;
+      int32_t table_end_itr = _keyval_cache.cache_table(*t);
+      auto itr = t->rows.find(id);
+      if (itr == t->rows.end())
+         return table_end_itr;
+      return _keyval_cache.add(*t, itr->second);
+   }
+
+   int32_t database::lowerbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id ) {
+      primary_table* t = find_table(code, scope, table);
+      if (!t)
+         return -1;
+      int32_t table_end_itr = _keyval_cache.cache_table(*t);
+      auto itr = t->rows.lower_bound(id);
+      if (itr == t->rows.end())
+         return table_end_itr;
+      return _keyval_cache.add(*t, itr->second);
+   }
+
+   int32_t database::upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id ) {
+      primary_table* t = find_table(code, scope, table);
+      if (!t)
+         return -1;
+      int32_t table_end_itr = _keyval_cache.cache_table(*t);
+      auto itr = t->rows.upper_bound(id);
+      if (itr == t->rows.end())
+         return table_end_itr;
+      return _keyval_cache.add(*t, itr->second);
+   }
+
+   int32_t database::end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
+      primary_table* t = find_table(code, scope, table);
+      if (!t)
+         return -1;
+      return _keyval_cache.cache_table(*t);
+   }
+
+   void database::reset_iterators() {
+      _keyval_cache.clear();
+      idx64.reset_iterators();
+      idx128.reset_iterators();
+      idx256.reset_iterators();
+      idx_double.reset_iterators();
+      idx_long_double.reset_iterators();
+   }
+
+   void database::clear() {
+      _keyval_cache.clear();
+      _tables.clear();
+      _ram.clear();
+      _snapshots.clear();
+      enable_undo(false);
+      idx64.clear();
+      idx128.clear();
+      idx256.clear();
+      idx_double.clear();
+      idx_long_double.clear();
+   }
+
+   void database::record( const primary_table& t, uint64_t primary_key, std::optional<key_value_object> old ) {
+      if (!_snapshots.empty())
+         _undo.push_back({t.id, primary_key, t.payer, std::move(old)});
+   }
+
+   void database::undo( size_t revision ) {
+      while (_undo.size() > revision) {
+         auto& entry = _undo.back();
+         auto& t = _tables.try_emplace(entry.table, primary_table{entry.table, 0, {}}).first->second;
+         // unbill the current state and bill the restored one, billing only depends on the rows
+         if (!t.rows.empty())
+            _ram.bill(t.payer, -ram_ledger::table_overhead);
+         auto itr = t.rows.find(entry.primary_key);
+         if (itr != t.rows.end()) {
+            _ram.bill(itr->second.payer, -(ram_ledger::key_value_overhead + int64_t(itr->second.value.size())));
+            t.rows.erase(itr);
+         }
+         if (entry.old) {
+            _ram.bill(entry.old->payer, ram_ledger::key_value_overhead + int64_t(entry.old->value.size()));
+            t.rows.emplace(entry.primary_key, std::move(*entry.old));
+         }
+         t.payer = entry.table_payer;
+         if (!t.rows.empty())
+            _ram.bill(t.payer, ram_ledger::table_overhead);
+         _undo.pop_back();
+      }
+   }
+
+   void database::enable_undo( bool enable ) {
+      if (!enable)
+         _undo.clear();
+      idx64.enable_undo(enable);
+      idx128.enable_undo(enable);
+      idx256.enable_undo(enable);
+      idx_double.enable_undo(enable);
+      idx_long_double.enable_undo(enable);
+   }
+
+   database::revision database::snapshot() {
+      if (_snapshots.empty())
+         enable_undo(true);
+      _snapshots.push_back({_undo.size(), idx64.undo_revision(), idx128.undo_revision(), idx256.undo_revision(),
+                            idx_double.undo_revision(), idx_long_double.undo_revision()});
+      return _snapshots.size() - 1;
+   }
+
+   void database::restore( revision rev ) {
+      eosio_assert(rev < _snapshots.size(), "unknown database snapshot");
+      const snapshot_marks marks = _snapshots[rev];
+      _keyval_cache.clear();
+      undo(marks.primary);
+      idx64.undo(marks.idx64);
+      idx128.undo(marks.idx128);
+      idx256.undo(marks.idx256);
+      idx_double.undo(marks.idx_double);
+      idx_long_double.undo(marks.idx_long_double);
+      _snapshots.resize(rev + 1);
+   }
+
+   void database::release( revision rev ) {
+      eosio_assert(rev < _snapshots.size(), "unknown database snapshot");
+      _snapshots.resize(rev);
+      if (_snapshots.empty())
+         enable_undo(false);
+   }
+
+   int64_t database::ram_usage( uint64_t payer )const {
+      return _ram.usage(payer) + idx64.ram().usage(payer) + idx128.ram().usage(payer) + idx256.ram().usage(payer) +
+             idx_double.ram().usage(payer) + idx_long_double.ram().usage(payer);
+   }
+
+   ram_usage_map database::ram_usage()const {
+      ram_ledger total;
+      for (const ram_ledger* ledger : {&_ram, &idx64.ram(), &idx128.ram(), &idx256.ram(), &idx_double.ram(), &idx_long_double.ram()})
+         for (const auto& entry : ledger->usage())
+            total.bill(entry.first, entry.second);
+      return total.usage();
+   }
+
+   ram_usage_map database::ram_diff( const ram_usage_map& before, const ram_usage_map& after ) {
+      ram_ledger diff;
+      for (const auto& entry : after)
+         diff.bill(entry.first, entry.second);
+      for (const auto& entry : before)
+         diff.bill(entry.first, -entry.second);
+      return diff.usage();
+   }
+
+}} //ns eosio::native
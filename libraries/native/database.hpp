@@ -0,0 +1,615 @@
+#pragma once
+#include <eosiolib/system.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    * Identifies a table the same way nodeos does, by (code, scope, table)
+    */
+   struct table_id {
+      uint64_t code  = 0;
+      uint64_t scope = 0;
+      uint64_t table = 0;
+
+      friend bool operator<( const table_id& a, const table_id& b ) {
+         return std::tie(a.code, a.scope, a.table) < std::tie(b.code, b.scope, b.table);
+      }
+   };
+
+   /**
+    * Maps the int32_t iterators handed to contracts onto tables and rows
+    *
+    * Mirrors the iterator cache of nodeos' apply_context: a row keeps the same iterator for as long as it lives,
+    * -1 is the invalid iterator and the end iterator of the n-th cached table is -(n+2).
+    */
+   template <typename Table, typename Object>
+   class iterator_cache {
+      public:
+         int32_t cache_table( Table& t ) {
+            auto itr = _table_cache.find(&t);
+            if (itr != _table_cache.end())
+               return itr->second;
+            int32_t ei = index_to_end_iterator(_end_iterator_to_table.size());
+            _end_iterator_to_table.push_back(&t);
+            _table_cache.emplace(&t, ei);
+            return ei;
+         }
+
+         Table& find_table_by_end_iterator( int32_t ei )const {
+            eosio_assert(ei < -1, "not an end iterator");
+            size_t indx = end_iterator_to_index(ei);
+            eosio_assert(indx < _end_iterator_to_table.size(), "an invalid iterator");
+            return *_end_iterator_to_table[indx];
+         }
+
+         Table& get_table( int32_t iterator )const {
+            get(iterator);
+            return *_iterator_to_object[iterator].table;
+         }
+
+         Object& get( int32_t iterator )const {
+            eosio_assert(iterator != -1, "invalid iterator");
+            eosio_assert(iterator >= 0, "dereference of end iterator");
+            eosio_assert(size_t(iterator) < _iterator_to_object.size(), "iterator out of range");
+            Object* obj = _iterator_to_object[iterator].object;
+            eosio_assert(obj != nullptr, "dereference of deleted object");
+            return *obj;
+         }
+
+         void remove( int32_t iterator ) {
+            eosio_assert(iterator != -1, "invalid iterator");
+            eosio_assert(iterator >= 0, "cannot call remove on end iterators");
+            eosio_assert(size_t(iterator) < _iterator_to_object.size(), "iterator out of range");
+            auto& entry = _iterator_to_object[iterator];
+            if (entry.object == nullptr)
+               return;
+            _object_to_iterator.erase(entry.object);
+            entry.object = nullptr;
+         }
+
+         int32_t add( Table& t, Object& obj ) {
+            auto itr = _object_to_iterator.find(&obj);
+            if (itr != _object_to_iterator.end())
+               return itr->second;
+            int32_t iterator = _iterator_to_object.size();
+            _iterator_to_object.push_back({&t, &obj});
+            _object_to_iterator.emplace(&obj, iterator);
+            return iterator;
+         }
+
+         void clear() {
+            _end_iterator_to_table.clear();
+            _table_cache.clear();
+            _iterator_to_object.clear();
+            _object_to_iterator.clear();
+         }
+
+      private:
+         struct entry {
+            Table*  table;
+            Object* object;
+         };
+
+         static int32_t index_to_end_iterator( size_t indx ) { return -(int32_t(indx) + 2); }
+         static size_t  end_iterator_to_index( int32_t ei ) { return size_t(-ei - 2); }
+
+         std::vector<Table*>                            _end_iterator_to_table;
+         std::unordered_map<const Table*, int32_t>      _table_cache;
+         std::vector<entry>                             _iterator_to_object;
+         std::unordered_map<const Object*, int32_t>     _object_to_iterator;
+   };
+
+   /**
+    * RAM billed per payer account, as a map from payer to bytes
+    */
+   using ram_usage_map = std::map<uint64_t, int64_t>;
+
+   /**
+    * Keeps the RAM usage of every payer the way nodeos bills it
+    *
+    * The constants are nodeos' billable sizes, the fixed size of each chain object plus
+    * config::overhead_per_row_per_index_ram_bytes for every index the object sits in. A table is billed to the
+    * payer of its first row and refunded to that payer when its last row goes away.
+    */
+   class ram_ledger {
+      public:
+         static constexpr int64_t overhead_per_row_per_index = 32;
+         /// billable_size_v<table_id_object>
+         static constexpr int64_t table_overhead     = 44 + 2 * overhead_per_row_per_index;
+         /// billable_size_v<key_value_object>, billed on top of the size of the row data
+         static constexpr int64_t key_value_overhead = 32 + 8 + 4 + 2 * overhead_per_row_per_index;
+         /// billable_size_v<index64_object>, index128_object, ... : fixed fields, the key and three indices
+         template <typename Key>
+         static constexpr int64_t secondary_overhead = 24 + int64_t(sizeof(Key)) + 3 * overhead_per_row_per_index;
+
+         void bill( uint64_t payer, int64_t delta ) {
+            if (delta == 0)
+               return;
+            auto itr = _usage.emplace(payer, 0).first;
+            itr->second += delta;
+            if (itr->second == 0)
+               _usage.erase(itr);
+         }
+
+         int64_t usage( uint64_t payer )const {
+            auto itr = _usage.find(payer);
+            return itr == _usage.end() ? 0 : itr->second;
+         }
+
+         const ram_usage_map& usage()const { return _usage; }
+
+         void clear() { _usage.clear(); }
+
+      private:
+         ram_usage_map _usage;
+   };
+
+   /**
+    * A row of a primary (i64) table
+    */
+   struct key_value_object {
+      uint64_t          primary_key = 0;
+      uint64_t          payer       = 0;
+      std::vector<char> value;
+   };
+
+   /**
+    * A row of a secondary index, ordered by (secondary, primary_key)
+    */
+   template <typename Key>
+   struct secondary_object {
+      uint64_t primary_key = 0;
+      uint64_t payer       = 0;
+      Key      secondary   = {};
+   };
+
+   /**
+    * State of one row before a change, recorded while a database snapshot is open
+    */
+   template <typename Object>
+   struct undo_entry {
+      table_id              table;
+      uint64_t              primary_key = 0;
+      uint64_t              table_payer = 0; ///< payer of the table before the change
+      std::optional<Object> old;             ///< empty if the row did not exist
+   };
+
+   /**
+    * One secondary index type (idx64, idx128, ...) over all tables
+    *
+    * The member functions follow the db_idx* intrinsics one to one, the `receiver` argument is the account
+    * executing the action and is used for the access checks nodeos performs.
+    */
+   template <typename Key>
+   class secondary_index {
+      public:
+         using object_type = secondary_object<Key>;
+
+         secondary_index() = default;
+         secondary_index( secondary_index&& ) = default;
+         secondary_index& operator=( secondary_index&& ) = default;
+
+         /**
+          * Copies the rows only, iterators handed out for `other` are not valid for the copy
+          */
+         secondary_index( const secondary_index& other ) : _tables(other._tables), _ram(other._ram) {
+            rebuild_indices();
+         }
+
+         secondary_index& operator=( const secondary_index& other ) {
+            if (this != &other) {
+               _itr_cache.clear();
+               _tables = other._tables;
+               _ram    = other._ram;
+               enable_undo(false);
+               rebuild_indices();
+            }
+            return *this;
+         }
+
+         int32_t store( uint64_t receiver, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const Key& secondary ) {
+            eosio_assert(payer != 0, "must specify a valid account to pay for new record");
+            validate(secondary);
+            const table_id tid{receiver, scope, table};
+            auto& t = _tables.try_emplace(tid, index_table{tid, 0, {}, {}}).first->second;
+            auto res = t.objects.emplace(id, object_type{id, payer, secondary});
+            eosio_assert(res.second, "could not insert object, most likely a uniqueness constraint was violated");
+            record(t, id, std::nullopt);
+            if (t.objects.size() == 1) {
+               t.payer = payer;
+               _ram.bill(payer, ram_ledger::table_overhead);
+            }
+            _ram.bill(payer, billable_size);
+            object_type& obj = res.first->second;
+            t.index.insert(&obj);
+            _itr_cache.cache_table(t);
+            return _itr_cache.add(t, obj);
+         }
+
+         void remove( uint64_t receiver, int32_t iterator ) {
+            object_type& obj = _itr_cache.get(iterator);
+            index_table& t = _itr_cache.get_table(iterator);
+            eosio_assert(t.id.code == receiver, "db access violation");
+            record(t, obj.primary_key, obj);
+            _itr_cache.remove(iterator);
+            _ram.bill(obj.payer, -billable_size);
+            t.index.erase(&obj);
+            t.objects.erase(obj.primary_key);
+            if (t.objects.empty())
+               _ram.bill(t.payer, -ram_ledger::table_overhead);
+         }
+
+         void update( uint64_t receiver, int32_t iterator, uint64_t payer, const Key& secondary ) {
+            object_type& obj = _itr_cache.get(iterator);
+            index_table& t = _itr_cache.get_table(iterator);
+            eosio_assert(t.id.code == receiver, "db access violation");
+            validate(secondary);
+            if (payer == 0)
+               payer = obj.payer;
+            record(t, obj.primary_key, obj);
+            if (payer != obj.payer) {
+               _ram.bill(obj.payer, -billable_size);
+               _ram.bill(payer, billable_size);
+            }
+            t.index.erase(&obj);
+            obj.secondary = secondary;
+            obj.payer     = payer;
+            t.index.insert(&obj);
+         }
+
+         int32_t find_secondary( uint64_t code, uint64_t scope, uint64_t table, const Key& secondary, uint64_t& primary ) {
+            index_table* t = find_table(code, scope, table);
+            if (!t)
+               return -1;
+            int32_t table_end_itr = _itr_cache.cache_table(*t);
+            auto itr = t->index.lower_bound(probe(secondary, 0));
+            if (itr == t->index.end() || !equal((*itr)->secondary, secondary))
+               return table_end_itr;
+            primary = (*itr)->primary_key;
+            return _itr_cache.add(*t, **itr);
+         }
+
+         int32_t lowerbound( uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t& primary ) {
+            return bound(code, scope, table, secondary, primary, false);
+         }
+
+         int32_t upperbound( uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t& primary ) {
+            return bound(code, scope, table, secondary, primary, true);
+         }
+
+         int32_t end( uint64_t code, uint64_t scope, uint64_t table ) {
+            index_table* t = find_table(code, scope, table);
+            if (!t)
+               return -1;
+            return _itr_cache.cache_table(*t);
+         }
+
+         int32_t next( int32_t iterator, uint64_t& primary ) {
+            if (iterator < -1)
+               return -1; // cannot increment past end iterator of index
+            object_type& obj = _itr_cache.get(iterator);
+            index_table& t = _itr_cache.get_table(iterator);
+            auto itr = t.index.find(&obj);
+            ++itr;
+            if (itr == t.index.end())
+               return _itr_cache.cache_table(t);
+            primary = (*itr)->primary_key;
+            return _itr_cache.add(t, **itr);
+         }
+
+         int32_t previous( int32_t iterator, uint64_t& primary ) {
+            if (iterator < -1) {
+               index_table& t = _itr_cache.find_table_by_end_iterator(iterator);
+               if (t.index.empty())
+                  return -1;
+               object_type& obj = **t.index.rbegin();
+               primary = obj.primary_key;
+               return _itr_cache.add(t, obj);
+            }
+            object_type& obj = _itr_cache.get(iterator);
+            index_table& t = _itr_cache.get_table(iterator);
+            auto itr = t.index.find(&obj);
+            if (itr == t.index.begin())
+               return -1; // cannot decrement past beginning iterator of index
+            --itr;
+            primary = (*itr)->primary_key;
+            return _itr_cache.add(t, **itr);
+         }
+
+         int32_t find_primary( uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t primary ) {
+            index_table* t = find_table(code, scope, table);
+            if (!t)
+               return -1;
+            int32_t table_end_itr = _itr_cache.cache_table(*t);
+            auto itr = t->objects.find(primary);
+            if (itr == t->objects.end())
+               return table_end_itr;
+            secondary = itr->second.secondary;
+            return _itr_cache.add(*t, itr->second);
+         }
+
+         /**
+          * Forget every iterator handed out so far, nodeos does this at the start of each action
+          */
+         void reset_iterators() { _itr_cache.clear(); }
+
+         /**
+          * Drop all rows of every table
+          */
+         void clear() {
+            _itr_cache.clear();
+            _tables.clear();
+            _ram.clear();
+         }
+
+         /**
+          * RAM billed for the rows of this index and the tables backing it
+          */
+         const ram_ledger& ram()const { return _ram; }
+
+         /**
+          * Start or stop recording undo entries, driven by database::snapshot() and database::release()
+          */
+         void enable_undo( bool enable ) {
+            _undo_enabled = enable;
+            if (!enable)
+               _undo.clear();
+         }
+
+         size_t undo_revision()const { return _undo.size(); }
+
+         /**
+          * Revert every change recorded after `revision`, newest first
+          */
+         void undo( size_t revision ) {
+            _itr_cache.clear();
+            while (_undo.size() > revision) {
+               auto& entry = _undo.back();
+               auto& t = _tables.try_emplace(entry.table, index_table{entry.table, 0, {}, {}}).first->second;
+               // unbill the current state and bill the restored one, billing only depends on the rows
+               if (!t.objects.empty())
+                  _ram.bill(t.payer, -ram_ledger::table_overhead);
+               auto itr = t.objects.find(entry.primary_key);
+               if (itr != t.objects.end()) {
+                  _ram.bill(itr->second.payer, -billable_size);
+                  t.index.erase(&itr->second);
+                  t.objects.erase(itr);
+               }
+               if (entry.old) {
+                  _ram.bill(entry.old->payer, billable_size);
+                  t.index.insert(&t.objects.emplace(entry.primary_key, *entry.old).first->second);
+               }
+               t.payer = entry.table_payer;
+               if (!t.objects.empty())
+                  _ram.bill(t.payer, ram_ledger::table_overhead);
+               _undo.pop_back();
+            }
+         }
+
+      private:
+         struct secondary_less {
+            bool operator()( const object_type* a, const object_type* b )const {
+               if (a->secondary < b->secondary)
+                  return true;
+               if (b->secondary < a->secondary)
+                  return false;
+               return a->primary_key < b->primary_key;
+            }
+         };
+
+         static constexpr int64_t billable_size = ram_ledger::secondary_overhead<Key>;
+
+         struct index_table {
+            table_id                                id;
+            uint64_t                                payer; ///< billed for the table itself
+            std::map<uint64_t, object_type>         objects;
+            std::set<object_type*, secondary_less>  index;
+         };
+
+         static bool equal( const Key& a, const Key& b ) { return !(a < b) && !(b < a); }
+
+         void record( const index_table& t, uint64_t primary_key, std::optional<object_type> old ) {
+            if (_undo_enabled)
+               _undo.push_back({t.id, primary_key, t.payer, std::move(old)});
+         }
+
+         // the copied index still points at the objects of the source
+         void rebuild_indices() {
+            for (auto& entry : _tables) {
+               auto& t = entry.second;
+               t.index.clear();
+               for (auto& obj : t.objects)
+                  t.index.insert(&obj.second);
+            }
+         }
+
+         static void validate( const Key& secondary ) {
+            if constexpr (std::is_floating_point<Key>::value)
+               eosio_assert(!std::isnan(secondary), "NaN is not an allowed value for a secondary key");
+         }
+
+         object_type* probe( const Key& secondary, uint64_t primary ) {
+            _probe.secondary   = secondary;
+            _probe.primary_key = primary;
+            return &_probe;
+         }
+
+         index_table* find_table( uint64_t code, uint64_t scope, uint64_t table_name ) {
+            auto itr = _tables.find(table_id{code, scope, table_name});
+            // nodeos drops a table together with its last row
+            if (itr == _tables.end() || itr->second.objects.empty())
+               return nullptr;
+            return &itr->second;
+         }
+
+         int32_t bound( uint64_t code, uint64_t scope, uint64_t table, Key& secondary, uint64_t& primary, bool upper ) {
+            index_table* t = find_table(code, scope, table);
+            if (!t)
+               return -1;
+            int32_t table_end_itr = _itr_cache.cache_table(*t);
+            auto itr = upper ? t->index.upper_bound(probe(secondary, UINT64_MAX))
+                             : t->index.lower_bound(probe(secondary, 0));
+            if (itr == t->index.end())
+               return table_end_itr;
+            secondary = (*itr)->secondary;
+            primary   = (*itr)->primary_key;
+            return _itr_cache.add(*t, **itr);
+         }
+
+         std::map<table_id, index_table>          _tables;
+         iterator_cache<index_table, object_type> _itr_cache;
+         object_type                              _probe;
+         ram_ledger                               _ram;
+         std::vector<undo_entry<object_type>>     _undo;
+         bool                                     _undo_enabled = false;
+   };
+
+   /**
+    * In-memory implementation of the database intrinsics with the iterator semantics of nodeos
+    *
+    * Installed by default for native tests, so multi_index based code runs without hand written mocks.
+    * The instance returned by get() backs the db_* intrinsics, tests can clear() it between cases.
+    *
+    * snapshot() and restore() work like the undo sessions of chainbase: while a snapshot is open every change
+    * records the previous state of the row, so restoring costs O(changes) whatever the size of the database.
+    *
+    * Example:
+    * @code
+    * deploy_fixture();
+    * auto fixture = database::get().snapshot();
+    * for (auto& test_case : cases) {
+    *    test_case(); // builds its own multi_index objects
+    *    database::get().restore(fixture);
+    * }
+    * @endcode
+    */
+   class database {
+      public:
+         using idx256_key = std::array<uint128_t, 2>;
+         using revision   = uint32_t;
+
+         static database& get() {
+            static database inst;
+            return inst;
+         }
+
+         database() = default;
+         database( database&& ) = default;
+         database& operator=( database&& ) = default;
+
+         /**
+          * Copies the rows only, iterators and snapshots of `other` are not valid for the copy
+          */
+         database( const database& other );
+         database& operator=( const database& other );
+
+         int32_t store_i64( uint64_t receiver, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* buffer, uint32_t buffer_size );
+         void    update_i64( uint64_t receiver, int32_t iterator, uint64_t payer, const void* buffer, uint32_t buffer_size );
+         void    remove_i64( uint64_t receiver, int32_t iterator );
+         int32_t get_i64( int32_t iterator, void* buffer, uint32_t buffer_size );
+         int32_t next_i64( int32_t iterator, uint64_t& primary );
+         int32_t previous_i64( int32_t iterator, uint64_t& primary );
+         int32_t find_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
+         int32_t lowerbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
+         int32_t upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
+         int32_t end_i64( uint64_t code, uint64_t scope, uint64_t table );
+
+         secondary_index<uint64_t>    idx64;
+         secondary_index<uint128_t>   idx128;
+         secondary_index<idx256_key>  idx256;
+         secondary_index<double>      idx_double;
+         secondary_index<long double> idx_long_double;
+
+         /**
+          * Forget every iterator handed out so far, nodeos does this at the start of each action
+          */
+         void reset_iterators();
+
+         /**
+          * Drop all rows of every table and index, together with all snapshots
+          */
+         void clear();
+
+         /**
+          * Mark the current state, snapshots nest and the newest one has the highest revision
+          */
+         revision snapshot();
+
+         /**
+          * Bring every table, index and RAM counter back to the state of snapshot `rev`
+          *
+          * Newer snapshots are dropped, `rev` stays open and can be restored again. Invalidates all iterators,
+          * multi_index objects cache them and must be created again after a restore.
+          */
+         void restore( revision rev );
+
+         /**
+          * Close snapshot `rev` and all newer ones, keeping the changes made since
+          */
+         void release( revision rev );
+
+         /**
+          * Bytes of RAM billed to `payer` over all tables and indices
+          */
+         int64_t ram_usage( uint64_t payer )const;
+
+         /**
+          * RAM billed to every payer, payers at zero are left out
+          */
+         ram_usage_map ram_usage()const;
+
+         /**
+          * Per payer change from `before` to `after`, payers whose usage did not change are left out
+          *
+          * Example:
+          * @code
+          * auto before = database::get().ram_usage();
+          * accounts.emplace("alice"_n, [&](auto& r) { ... });
+          * auto diff = database::ram_diff(before, database::get().ram_usage());
+          * CHECK_EQUAL( diff["alice"_n.value], ram_ledger::key_value_overhead + pack_size(row) );
+          * @endcode
+          */
+         static ram_usage_map ram_diff( const ram_usage_map& before, const ram_usage_map& after );
+
+      private:
+         struct primary_table {
+            table_id                                 id;
+            uint64_t                                 payer; ///< billed for the table itself
+            std::map<uint64_t, key_value_object>     rows;
+         };
+
+         // undo revision of every index when a snapshot was taken
+         struct snapshot_marks {
+            size_t primary, idx64, idx128, idx256, idx_double, idx_long_double;
+         };
+
+         primary_table* find_table( uint64_t code, uint64_t scope, uint64_t table_name );
+         void record( const primary_table& t, uint64_t primary_key, std::optional<key_value_object> old );
+         void undo( size_t revision );
+         void enable_undo( bool enable );
+
+         std::map<table_id, primary_table>               _tables;
+         iterator_cache<primary_table, key_value_object> _keyval_cache;
+         ram_ledger                                      _ram;
+         std::vector<undo_entry<key_value_object>>       _undo;
+         std::vector<snapshot_marks>                     _snapshots;
+   };
+
+   /**
+    * Route every db_* intrinsic to database::get(), called before main() runs
+    */
+   void install_database_intrinsics();
+
+}} //ns eosio::native
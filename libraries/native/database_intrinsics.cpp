@@ -0,0 +1,140 @@
+#include "database.hpp"
+#include "intrinsics.hpp"
+
+#include <string>
+
+namespace eosio { namespace native {
+
+   namespace {
+      void check_idx256_size( uint32_t data_len ) {
+         if (data_len != 2)
+            eosio_assert(false, ("invalid size of secondary key array for idx256: given "+std::to_string(data_len)+
+                                 " bytes but expected 2").c_str());
+      }
+
+      database::idx256_key to_idx256_key( const uint128_t* data, uint32_t data_len ) {
+         check_idx256_size(data_len);
+         return {data[0], data[1]};
+      }
+
+      void from_idx256_key( const database::idx256_key& key, uint128_t* data, uint32_t data_len ) {
+         check_idx256_size(data_len);
+         data[0] = key[0];
+         data[1] = key[1];
+      }
+   }
+
+#define REGISTER_SECONDARY_INTRINSICS(IDX, TYPE) \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_store>([](uint64_t scope, capi_name table, capi_name payer, uint64_t id, const TYPE* secondary) { \
+         return database::get().IDX.store(current_receiver(), scope, table, payer, id, *secondary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_remove>([](int32_t iterator) { \
+         database::get().IDX.remove(current_receiver(), iterator); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_update>([](int32_t iterator, capi_name payer, const TYPE* secondary) { \
+         database::get().IDX.update(current_receiver(), iterator, payer, *secondary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_find_primary>([](capi_name code, uint64_t scope, capi_name table, TYPE* secondary, uint64_t primary) { \
+         return database::get().IDX.find_primary(code, scope, table, *secondary, primary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_find_secondary>([](capi_name code, uint64_t scope, capi_name table, const TYPE* secondary, uint64_t* primary) { \
+         return database::get().IDX.find_secondary(code, scope, table, *secondary, *primary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_lowerbound>([](capi_name code, uint64_t scope, capi_name table, TYPE* secondary, uint64_t* primary) { \
+         return database::get().IDX.lowerbound(code, scope, table, *secondary, *primary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_upperbound>([](capi_name code, uint64_t scope, capi_name table, TYPE* secondary, uint64_t* primary) { \
+         return database::get().IDX.upperbound(code, scope, table, *secondary, *primary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_end>([](capi_name code, uint64_t scope, capi_name table) { \
+         return database::get().IDX.end(code, scope, table); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_next>([](int32_t iterator, uint64_t* primary) { \
+         return database::get().IDX.next(iterator, *primary); \
+      }); \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_previous>([](int32_t iterator, uint64_t* primary) { \
+         return database::get().IDX.previous(iterator, *primary); \
+      });
+
+   void install_database_intrinsics() {
+      intrinsics::set_intrinsic<intrinsics::db_store_i64>([](uint64_t scope, capi_name table, capi_name payer, uint64_t id, const void* data, uint32_t len) {
+            return database::get().store_i64(current_receiver(), scope, table, payer, id, data, len);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_update_i64>([](int32_t iterator, capi_name payer, const void* data, uint32_t len) {
+            database::get().update_i64(current_receiver(), iterator, payer, data, len);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_remove_i64>([](int32_t iterator) {
+            database::get().remove_i64(current_receiver(), iterator);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_get_i64>([](int32_t iterator, const void* data, uint32_t len) {
+            return database::get().get_i64(iterator, const_cast<void*>(data), len);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_next_i64>([](int32_t iterator, uint64_t* primary) {
+            return database::get().next_i64(iterator, *primary);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_previous_i64>([](int32_t iterator, uint64_t* primary) {
+            return database::get().previous_i64(iterator, *primary);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_find_i64>([](capi_name code, uint64_t scope, capi_name table, uint64_t id) {
+            return database::get().find_i64(code, scope, table, id);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_lowerbound_i64>([](capi_name code, uint64_t scope, capi_name table, uint64_t id) {
+            return database::get().lowerbound_i64(code, scope, table, id);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_upperbound_i64>([](capi_name code, uint64_t scope, capi_name table, uint64_t id) {
+            return database::get().upperbound_i64(code, scope, table, id);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_end_i64>([](capi_name code, uint64_t scope, capi_name table) {
+            return database::get().end_i64(code, scope, table);
+         });
+
+      REGISTER_SECONDARY_INTRINSICS(idx64, uint64_t)
+      REGISTER_SECONDARY_INTRINSICS(idx128, uint128_t)
+      REGISTER_SECONDARY_INTRINSICS(idx_double, double)
+      REGISTER_SECONDARY_INTRINSICS(idx_long_double, long double)
+
+      intrinsics::set_intrinsic<intrinsics::db_idx256_store>([](uint64_t scope, capi_name table, capi_name payer, uint64_t id, const uint128_t* data, uint32_t data_len) {
+            return database::get().idx256.store(current_receiver(), scope, table, payer, id, to_idx256_key(data, data_len));
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_remove>([](int32_t iterator) {
+            database::get().idx256.remove(current_receiver(), iterator);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_update>([](int32_t iterator, capi_name payer, const uint128_t* data, uint32_t data_len) {
+            database::get().idx256.update(current_receiver(), iterator, payer, to_idx256_key(data, data_len));
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_find_primary>([](capi_name code, uint64_t scope, capi_name table, uint128_t* data, uint32_t data_len, uint64_t primary) {
+            database::idx256_key key{};
+            int32_t itr = database::get().idx256.find_primary(code, scope, table, key, primary);
+            if (itr >= 0)
+               from_idx256_key(key, data, data_len);
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_find_secondary>([](capi_name code, uint64_t scope, capi_name table, const uint128_t* data, uint32_t data_len, uint64_t* primary) {
+            return database::get().idx256.find_secondary(code, scope, table, to_idx256_key(data, data_len), *primary);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_lowerbound>([](capi_name code, uint64_t scope, capi_name table, uint128_t* data, uint32_t data_len, uint64_t* primary) {
+            database::idx256_key key = to_idx256_key(data, data_len);
+            int32_t itr = database::get().idx256.lowerbound(code, scope, table, key, *primary);
+            from_idx256_key(key, data, data_len);
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_upperbound>([](capi_name code, uint64_t scope, capi_name table, uint128_t* data, uint32_t data_len, uint64_t* primary) {
+            database::idx256_key key = to_idx256_key(data, data_len);
+            int32_t itr = database::get().idx256.upperbound(code, scope, table, key, *primary);
+            from_idx256_key(key, data, data_len);
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_end>([](capi_name code, uint64_t scope, capi_name table) {
+            return database::get().idx256.end(code, scope, table);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_next>([](int32_t iterator, uint64_t* primary) {
+            return database::get().idx256.next(iterator, *primary);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_previous>([](int32_t iterator, uint64_t* primary) {
+            return database::get().idx256.previous(iterator, *primary);
+         });
+   }
+
+#undef REGISTER_SECONDARY_INTRINSICS
+
+}} //ns eosio::native
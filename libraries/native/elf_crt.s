@@ -1,11 +1,13 @@
 .global _start
 .global ___putc
 .global _mmap
+.global ___syscall
 .global setjmp
 .global longjmp
 .type _start,@function
 .type ___putc,@function
 .type _mmap,@function
+.type ___syscall,@function
 .type setjmp,@function
 .type longjmp,@function
 
@@ -43,6 +45,17 @@ _mmap:
    syscall
    ret 
 
+# long ___syscall(long n, long a1, long a2, long a3, long a4, long a5)
+___syscall:
+   mov %rdi, %rax
+   mov %rsi, %rdi
+   mov %rdx, %rsi
+   mov %rcx, %rdx
+   mov %r8, %r10
+   mov %r9, %r8
+   syscall
+   ret
+
 setjmp:
 	mov %rbx, 0(%rdi)
 	mov %rbp, 8(%rdi)
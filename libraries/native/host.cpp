@@ -0,0 +1,109 @@
+#include "host.hpp"
+
+#include <eosiolib/system.h>
+
+#include <cstring>
+
+extern "C" {
+#ifndef __APPLE__
+   long ___syscall(long n, long a1, long a2, long a3, long a4, long a5);
+#else
+   void ___putc(char c);
+#endif
+}
+
+namespace eosio { namespace native { namespace host {
+
+   namespace {
+      enum : long {
+         sys_read          = 0,
+         sys_write         = 1,
+         sys_open          = 2,
+         sys_close         = 3,
+         sys_clock_gettime = 228
+      };
+      constexpr long eintr           = 4;
+      constexpr long clock_monotonic = 1;
+
+      // output is collected here and written in blocks of this size
+      constexpr size_t stdout_buffer_size = 8192;
+      char   stdout_buffer[stdout_buffer_size];
+      size_t stdout_used = 0;
+
+      void write_all( const char* data, size_t size ) {
+#ifndef __APPLE__
+         while (size != 0) {
+            const long n = syscall(sys_write, 1, (long)data, size);
+            if (n == -eintr)
+               continue;
+            if (n < 0)
+               return;
+            data += n;
+            size -= n;
+         }
+#else
+         for (size_t i = 0; i < size; i++)
+            ___putc(data[i]);
+#endif
+      }
+   }
+
+   long syscall( long n, long a1, long a2, long a3, long a4, long a5 ) {
+#ifndef __APPLE__
+      return ___syscall(n, a1, a2, a3, a4, a5);
+#else
+      eosio_assert(false, "raw linux system calls are not available on macOS");
+      return -1;
+#endif
+   }
+
+   uint64_t monotonic_ns() {
+#ifndef __APPLE__
+      struct { long sec; long nsec; } ts = {};
+      syscall(sys_clock_gettime, clock_monotonic, (long)&ts);
+      return uint64_t(ts.sec) * 1000000000 + uint64_t(ts.nsec);
+#else
+      return 0;
+#endif
+   }
+
+   void write_stdout( const char* data, size_t size ) {
+      if (stdout_used + size > stdout_buffer_size) {
+         flush_stdout();
+         if (size >= stdout_buffer_size) {
+            write_all(data, size);
+            return;
+         }
+      }
+      memcpy(stdout_buffer + stdout_used, data, size);
+      stdout_used += size;
+   }
+
+   void flush_stdout() {
+      write_all(stdout_buffer, stdout_used);
+      stdout_used = 0;
+   }
+
+   bool read_file( const std::string& path, std::string& contents ) {
+#ifndef __APPLE__
+      const long fd = syscall(sys_open, (long)path.c_str(), 0 /* O_RDONLY */);
+      if (fd < 0)
+         return false;
+      contents.clear();
+      char buffer[4096];
+      long n;
+      while ((n = syscall(sys_read, fd, (long)buffer, sizeof(buffer))) != 0) {
+         if (n == -eintr)
+            continue;
+         if (n < 0)
+            break;
+         contents.append(buffer, n);
+      }
+      syscall(sys_close, fd);
+      return n == 0;
+#else
+      return false;
+#endif
+   }
+
+}}} //ns eosio::native::host
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace eosio { namespace native { namespace host {
+
+   /**
+    * Raw x86_64 linux system call, the native libc does not wrap process, file or clock calls
+    */
+   long syscall( long n, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0 );
+
+   /**
+    * Monotonic clock in nanoseconds, always 0 on macOS
+    */
+   uint64_t monotonic_ns();
+
+   /**
+    * Buffer `size` bytes for stdout, the buffer is written out in blocks once it is full
+    */
+   void write_stdout( const char* data, size_t size );
+
+   /**
+    * Write out everything buffered by write_stdout, needed before the process exits, forks or longjmps
+    */
+   void flush_stdout();
+
+   /**
+    * Read the whole file at `path` into `contents`
+    *
+    * @return false if the file could not be read
+    */
+   bool read_file( const std::string& path, std::string& contents );
+
+}}} //ns eosio::native::host
@@ -11,6 +11,7 @@
 #include <eosiolib/random.h>
 #include "intrinsics.hpp"
 #include "crt.hpp"
+#include "host.hpp"
 #include <softfloat.hpp>
 #include <float.h>
 
@@ -871,6 +872,7 @@ extern "C" {
       if (test == 0) {
          _prints(msg, eosio::cdt::output_stream_kind::std_err);
          _prints_l("\n", 1, eosio::cdt::output_stream_kind::none);
+         eosio::native::host::flush_stdout();
          longjmp(*___env_ptr, 1);
       }
    }
@@ -879,6 +881,7 @@ extern "C" {
       if (test == 0) {
          _prints_l(msg, len, eosio::cdt::output_stream_kind::std_err);
          _prints_l("\n", 1, eosio::cdt::output_stream_kind::none);
+         eosio::native::host::flush_stdout();
          longjmp(*___env_ptr, 1);
       }
    }
@@ -889,6 +892,7 @@ extern "C" {
          snprintf(buff, 32, "%llu", code);
          _prints(buff, eosio::cdt::output_stream_kind::std_err);
          _prints_l("\n", 1, eosio::cdt::output_stream_kind::none);
+         eosio::native::host::flush_stdout();
          longjmp(*___env_ptr, 1);
       }
    }
@@ -3,12 +3,21 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 namespace eosio { namespace native {
-   
+
+   /**
+    * Table of the host functions backing every intrinsic in native builds
+    *
+    * Each entry is an intrinsic_slot, so dispatching an intrinsic costs one indirect call. Tests replace entries
+    * with set_intrinsic(), or for the duration of a scope with intrinsic_override. Call counting is off by default,
+    * turn it on with count_calls() to see how often contract code reaches each intrinsic.
+    */
    class intrinsics {
       public:
          static intrinsics& get() {
-            static intrinsics inst;
             return inst;
          }
 
@@ -17,28 +26,91 @@ namespace eosio { namespace native {
             INTRINSICS_SIZE
          };
 
+         static constexpr const char* names[INTRINSICS_SIZE] = { INTRINSICS(GET_NAME) };
+
          INTRINSICS(GENERATE_TYPE_MAPPING)
-         std::tuple< INTRINSICS(GET_TYPE) std::function<void()> > funcs {
-            INTRINSICS(REGISTER_INTRINSIC)
-            std::function<void()>{[](){}}
-         };
+         std::tuple< INTRINSICS(GET_TYPE) intrinsic_slot<void, std::tuple<>> > funcs;
+
+         template <intrinsic_name IN>
+         using slot_type = typename std::tuple_element<IN, decltype(funcs)>::type;
 
          template <intrinsic_name IN, typename... Args>
-         auto call(Args... args) -> decltype(std::get<IN>(intrinsics::get().funcs)(args...)) {
-            return std::get<IN>(intrinsics::get().funcs)(args...); 
+         static decltype(auto) call(Args... args) {
+            if (_count_calls)
+               ++_call_counts[IN];
+            return std::get<IN>(inst.funcs)(args...);
          }
 
          template <intrinsic_name IN, typename F>
          static void set_intrinsic(F&& func) {
-            auto& f = std::get<IN>(intrinsics::get().funcs);
-            std::get<IN>(intrinsics::get().funcs) = typename std::remove_reference<decltype(f)>::type {func};
+            std::get<IN>(inst.funcs) = slot_type<IN>::make(std::forward<F>(func));
+         }
+
+         template <intrinsic_name IN>
+         static slot_type<IN> get_intrinsic() {
+            return std::get<IN>(inst.funcs);
+         }
+
+         /**
+          * Start or stop counting calls per intrinsic, the counts are kept when counting stops
+          */
+         static void count_calls( bool enable ) { _count_calls = enable; }
+
+         static void reset_call_counts() {
+            for (auto& count : _call_counts)
+               count = 0;
          }
-         
+
          template <intrinsic_name IN>
-         static auto get_intrinsic() 
-               -> typename std::remove_reference<decltype(std::get<IN>(intrinsics::get().funcs))>::type {
-            return std::get<IN>(intrinsics::get().funcs);
+         static uint64_t call_count() { return _call_counts[IN]; }
+
+         /**
+          * Name and count of every intrinsic called at least once while counting
+          */
+         static std::vector<std::pair<const char*, uint64_t>> call_counts() {
+            std::vector<std::pair<const char*, uint64_t>> counts;
+            for (size_t i = 0; i < INTRINSICS_SIZE; i++)
+               if (_call_counts[i] != 0)
+                  counts.emplace_back(names[i], _call_counts[i]);
+            return counts;
+         }
+
+      private:
+         static intrinsics      inst;
+         static inline bool     _count_calls = false;
+         static inline uint64_t _call_counts[INTRINSICS_SIZE] = {};
+   };
+
+   // constant initialized, usable before main() without a guard on every call
+   inline intrinsics intrinsics::inst;
+
+   /**
+    * Replaces intrinsic `IN` until the end of the scope, then puts the previous function back
+    *
+    * Example:
+    * @code
+    * intrinsic_override<intrinsics::current_receiver> receiver([]() { return "test"_n.value; });
+    * @endcode
+    *
+    * A failing assert longjmps past the destructor, only the normal exit of the scope restores the intrinsic.
+    */
+   template <intrinsics::intrinsic_name IN>
+   class intrinsic_override {
+      public:
+         template <typename F>
+         explicit intrinsic_override(F&& func) : _previous(intrinsics::get_intrinsic<IN>()) {
+            intrinsics::set_intrinsic<IN>(std::forward<F>(func));
+         }
+
+         ~intrinsic_override() {
+            std::get<IN>(intrinsics::get().funcs) = std::move(_previous);
          }
+
+         intrinsic_override( const intrinsic_override& ) = delete;
+         intrinsic_override& operator=( const intrinsic_override& ) = delete;
+
+      private:
+         intrinsics::slot_type<IN> _previous;
    };
 
 }} //ns eosio::native
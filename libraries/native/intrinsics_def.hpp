@@ -12,6 +12,9 @@
 #include <eosiolib/types.h>
 #include <eosiolib/random.h>
 
+#include <memory>
+#include <new>
+#include <tuple>
 #include <type_traits>
 
 namespace eosio { namespace native {
@@ -31,14 +34,62 @@ namespace eosio { namespace native {
        return std::tuple<std::decay_t<Args>...>{};
    }
    
-   template <typename R, typename Args, size_t... Is>
-   auto create_function(std::index_sequence<Is...>) {
-      return std::function<R(typename std::tuple_element<Is, Args>::type ...)>{ 
-         [](typename std::tuple_element<Is, Args>::type ...) { 
-            eosio_assert(false, "unsupported intrinsic"); return (R)0;
+   /**
+    * One entry of the intrinsics table, a plain function pointer to a trampoline for the installed callable
+    *
+    * Callables that are small and trivially copyable, such as captureless lambdas or lambdas capturing a pointer,
+    * live inside the slot, anything else on the heap. Either way a call is a single indirect call to a trampoline
+    * that has the body of the callable inlined. A default constructed slot asserts "unsupported intrinsic".
+    */
+   template <typename R, typename Args>
+   class intrinsic_slot;
+
+   template <typename R, typename... Args>
+   class intrinsic_slot<R, std::tuple<Args...>> {
+      public:
+         using invoker = R(*)(const void* callable, Args...);
+
+         constexpr intrinsic_slot() = default;
+
+         template <typename F>
+         static intrinsic_slot make( F&& f ) {
+            using callable_t = std::decay_t<F>;
+            intrinsic_slot slot;
+            if constexpr (is_inline<callable_t>()) {
+               new (slot._storage) callable_t(std::forward<F>(f));
+               slot._invoke = [](const void* c, Args... args) -> R {
+                  return (*std::launder(static_cast<const callable_t*>(c)))(args...);
+               };
+            } else {
+               auto callable = std::make_shared<const callable_t>(std::forward<F>(f));
+               const callable_t* ptr = callable.get();
+               new (slot._storage) const callable_t*(ptr);
+               slot._owner  = std::move(callable);
+               slot._invoke = [](const void* c, Args... args) -> R {
+                  return (**std::launder(static_cast<const callable_t* const*>(c)))(args...);
+               };
+            }
+            return slot;
          }
-      };
-   }   
+
+         R operator()( Args... args )const { return _invoke(_storage, args...); }
+
+      private:
+         template <typename F>
+         static constexpr bool is_inline() {
+            return sizeof(F) <= sizeof(_storage) && alignof(F) <= alignof(void*) &&
+                   std::is_trivially_copyable<F>::value && std::is_trivially_destructible<F>::value;
+         }
+
+         static R unsupported( const void*, Args... ) {
+            eosio_assert(false, "unsupported intrinsic");
+            return (R)0;
+         }
+
+         invoker                     _invoke = &unsupported;
+         alignas(void*) char         _storage[2 * sizeof(void*)] = {};
+         std::shared_ptr<const void> _owner; ///< keeps callables too large for _storage alive
+   };
 
 #define INTRINSICS(intrinsic_macro) \
 intrinsic_macro(get_resource_limits) \
@@ -175,11 +226,10 @@ intrinsic_macro(producer_random_seed)
    };
 
 #define GET_TYPE(name) \
-   decltype(create_function<eosio::native::intrinsics::__ ## name ## _types::res_t, \
-         eosio::native::intrinsics::__ ## name ## _types::deduced_full_ts>(eosio::native::intrinsics::__ ## name ## _types::is)),
+   eosio::native::intrinsic_slot<eosio::native::intrinsics::__ ## name ## _types::res_t, \
+         eosio::native::intrinsics::__ ## name ## _types::deduced_full_ts>,
 
-#define REGISTER_INTRINSIC(name) \
-   create_function<eosio::native::intrinsics::__ ## name ## _types::res_t, \
-         eosio::native::intrinsics::__ ## name ## _types::deduced_full_ts>(eosio::native::intrinsics::__ ## name ## _types::is),
+#define GET_NAME(name) \
+   #name,
 
 }} //ns eosio::native
@@ -0,0 +1,145 @@
+#include "replay.hpp"
+#include "clock.hpp"
+#include "host.hpp"
+#include "intrinsics.hpp"
+
+#include <eosiolib/datastream.hpp>
+#include <eosiolib/system.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+   extern bool ___disable_output;
+}
+
+namespace eosio { namespace native {
+
+   namespace {
+      void write_out( const std::string& s ) { host::write_stdout(s.data(), s.size()); }
+
+      std::string format_us( uint64_t ns ) {
+         std::string frac = std::to_string(ns % 1000);
+         return std::to_string(ns / 1000) + "." + std::string(3 - frac.size(), '0') + frac + " us";
+      }
+
+      template <typename Key>
+      void load_index_row( secondary_index<Key>& idx, const captured_index_row& row ) {
+         eosio_assert(row.secondary.size() == sizeof(Key), "captured secondary key has the wrong size");
+         Key key;
+         memcpy(&key, row.secondary.data(), sizeof(Key));
+         idx.store(row.code.value, row.scope, row.table.value, row.payer.value, row.primary_key, key);
+      }
+   }
+
+   uint64_t replay_result::median_ns()const {
+      if (durations_ns.empty())
+         return 0;
+      std::vector<uint64_t> sorted = durations_ns;
+      std::sort(sorted.begin(), sorted.end());
+      return sorted[sorted.size() / 2];
+   }
+
+   void replayer::load( const action_capture& capture ) {
+      auto& db = database::get();
+      db.clear();
+      virtual_clock::get().restore(capture.time);
+
+      _sim = simulator{};
+      _sim.set_contract(capture.act.account, _apply);
+      for (const auto& account : capture.accounts)
+         if (!_sim.is_account(account))
+            _sim.create_account(account);
+      for (const auto& auth : capture.act.authorization)
+         if (!_sim.is_account(auth.actor))
+            _sim.create_account(auth.actor);
+
+      for (const auto& row : capture.rows)
+         db.store_i64(row.code.value, row.scope, row.table.value, row.payer.value, row.primary_key,
+                      row.value.data(), row.value.size());
+      for (const auto& row : capture.index_rows) {
+         switch (captured_index(row.index)) {
+            case captured_index::idx64:           load_index_row(db.idx64, row); break;
+            case captured_index::idx128:          load_index_row(db.idx128, row); break;
+            case captured_index::idx256:          load_index_row(db.idx256, row); break;
+            case captured_index::idx_double:      load_index_row(db.idx_double, row); break;
+            case captured_index::idx_long_double: load_index_row(db.idx_long_double, row); break;
+            default: eosio_assert(false, "unknown secondary index in capture");
+         }
+      }
+      db.reset_iterators();
+   }
+
+   replay_result replayer::replay( const action_capture& capture, uint32_t runs ) {
+      eosio_assert(runs > 0, "replay needs at least one run");
+      replay_result r;
+      const state_snapshot loaded = _sim.snapshot();
+      const ram_usage_map ram_before = database::get().ram_usage();
+      intrinsics::reset_call_counts();
+      for (uint32_t i = 0; i < runs; i++) {
+         if (i != 0)
+            _sim.restore(loaded);
+         intrinsics::count_calls(true);
+         const uint64_t start = host::monotonic_ns();
+         r.result = _sim.push_action(capture.act);
+         r.durations_ns.push_back(host::monotonic_ns() - start);
+         intrinsics::count_calls(false);
+         if (i == 0)
+            r.ram_delta = database::ram_diff(ram_before, database::get().ram_usage());
+      }
+      _sim.release(loaded);
+      for (const auto& count : intrinsics::call_counts())
+         r.intrinsic_calls.emplace_back(count.first, count.second / runs);
+      return r;
+   }
+
+   int replay_main( int argc, char** argv, apply_handler apply ) {
+      std::string path;
+      uint32_t runs = 1;
+      for (int i = 1; i < argc; i++) {
+         const std::string arg = argv[i];
+         if (arg == "-n" && i + 1 < argc)
+            runs = std::max(std::atoi(argv[++i]), 1);
+         else
+            path = arg;
+      }
+      if (path.empty()) {
+         write_out(std::string("usage: ") + argv[0] + " <capture file> [-n RUNS]\n");
+         return 1;
+      }
+      std::string contents;
+      if (!host::read_file(path, contents)) {
+         write_out("could not read capture " + path + "\n");
+         return 1;
+      }
+      const auto capture = eosio::unpack<action_capture>(contents.data(), contents.size());
+
+      replayer rep(std::move(apply));
+      rep.load(capture);
+      // the contract prints once per run, only the report goes out
+      const bool disable_output = ___disable_output;
+      ___disable_output = true;
+      const replay_result r = rep.replay(capture, runs);
+      ___disable_output = disable_output;
+
+      write_out(capture.act.account.to_string() + "::" + capture.act.name.to_string() + " " +
+                (r.result.succeeded ? std::string("succeeded") : "failed: " + r.result.error) + "\n");
+      for (const auto& trace : r.result.traces)
+         write_out(std::string(3 * (trace.depth + 1), ' ') + trace.receiver.to_string() + " <= " +
+                   trace.act.account.to_string() + "::" + trace.act.name.to_string() + "\n");
+
+      const auto minmax = std::minmax_element(r.durations_ns.begin(), r.durations_ns.end());
+      write_out(std::to_string(runs) + " runs, median " + format_us(r.median_ns()) + ", min " +
+                format_us(*minmax.first) + ", max " + format_us(*minmax.second) + "\n");
+      write_out("intrinsic calls per run:\n");
+      for (const auto& calls : r.intrinsic_calls)
+         write_out("   " + calls.first + " " + std::to_string(calls.second) + "\n");
+      write_out("ram billed per run:\n");
+      for (const auto& delta : r.ram_delta)
+         write_out("   " + eosio::name(delta.first).to_string() + " " + (delta.second > 0 ? "+" : "") +
+                   std::to_string(delta.second) + "\n");
+      return r.result.succeeded ? 0 : 1;
+   }
+
+}} //ns eosio::native
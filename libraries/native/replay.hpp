@@ -0,0 +1,121 @@
+#pragma once
+#include "database.hpp"
+#include "simulator.hpp"
+
+#include <eosiolib/action.hpp>
+#include <eosiolib/name.hpp>
+#include <eosiolib/serialize.hpp>
+#include <eosiolib/time.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    * A row of a primary table as it was on chain before the action ran
+    */
+   struct captured_row {
+      eosio::name       code;
+      uint64_t          scope       = 0;
+      eosio::name       table;
+      eosio::name       payer;
+      uint64_t          primary_key = 0;
+      std::vector<char> value;
+
+      EOSLIB_SERIALIZE( captured_row, (code)(scope)(table)(payer)(primary_key)(value) )
+   };
+
+   enum class captured_index : uint8_t { idx64, idx128, idx256, idx_double, idx_long_double };
+
+   /**
+    * A row of a secondary index, `table` includes the index number in its low 4 bits as in nodeos
+    */
+   struct captured_index_row {
+      eosio::name       code;
+      uint64_t          scope       = 0;
+      eosio::name       table;
+      eosio::name       payer;
+      uint64_t          primary_key = 0;
+      uint8_t           index       = 0; ///< a captured_index
+      std::vector<char> secondary;       ///< the key in memory layout, little endian
+
+      EOSLIB_SERIALIZE( captured_index_row, (code)(scope)(table)(payer)(primary_key)(index)(secondary) )
+   };
+
+   /**
+    * Everything needed to run one action again offline
+    *
+    * The binary format is the eosio serialization of this struct, so a capture can be written by any tool that
+    * can pack these types. Only the rows the action reads have to be captured.
+    */
+   struct action_capture {
+      eosio::time_point               time;     ///< block time the action ran at
+      std::vector<eosio::name>        accounts; ///< accounts that must exist, notified or inline targets
+      std::vector<captured_row>       rows;
+      std::vector<captured_index_row> index_rows;
+      eosio::action                   act;      ///< with its authorization and data
+
+      EOSLIB_SERIALIZE( action_capture, (time)(accounts)(rows)(index_rows)(act) )
+   };
+
+   /**
+    * Outcome of replaying a capture
+    */
+   struct replay_result {
+      transaction_result    result;       ///< of the last run
+      std::vector<uint64_t> durations_ns; ///< wall clock time of every run
+      ram_usage_map         ram_delta;    ///< RAM billed per payer by one run
+      std::vector<std::pair<std::string, uint64_t>> intrinsic_calls; ///< per run
+
+      uint64_t median_ns()const;
+   };
+
+   /**
+    * Replays captured mainnet actions through a natively compiled contract
+    *
+    * load() puts the captured rows into database::get() and the clock at the captured time, replay() then runs
+    * the action `runs` times from that same state, so it can be timed, counted or profiled with perf. The
+    * action runs in a simulator, notifications and inline actions to the captured accounts are traced but
+    * only the replayed contract has code.
+    *
+    * Example:
+    * @code
+    * int main(int argc, char** argv) {
+    *    return eosio::native::replay_main(argc, argv, apply);
+    * }
+    * @endcode
+    */
+   class replayer {
+      public:
+         explicit replayer( apply_handler apply ) : _apply(std::move(apply)) {}
+
+         /**
+          * Clear the database and the clock and load the state of `capture`
+          */
+         void load( const action_capture& capture );
+
+         /**
+          * Run the action of `capture` `runs` times, each time from the loaded state
+          *
+          * The state of the last run is kept.
+          */
+         replay_result replay( const action_capture& capture, uint32_t runs = 1 );
+
+      private:
+         apply_handler _apply;
+         simulator     _sim;
+   };
+
+   /**
+    * Command line entry point of a replay tool: `<capture file> [-n RUNS]`
+    *
+    * Prints whether the action succeeded, the actions it ran, the timings, the intrinsic calls and the RAM
+    * billed.
+    *
+    * @return 0 if the action succeeded, 1 otherwise
+    */
+   int replay_main( int argc, char** argv, apply_handler apply );
+
+}} //ns eosio::native
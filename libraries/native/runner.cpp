@@ -0,0 +1,206 @@
+#include "runner.hpp"
+#include "crt.hpp"
+#include "host.hpp"
+
+#include <eosiolib/system.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+extern "C" {
+   extern bool ___disable_output;
+   extern bool ___has_failed;
+}
+
+namespace eosio { namespace native {
+
+   namespace {
+#ifndef __APPLE__
+      // x86_64 linux system call numbers, the native libc does not wrap these
+      enum : long {
+         sys_read              = 0,
+         sys_close             = 3,
+         sys_poll              = 7,
+         sys_pipe              = 22,
+         sys_dup2              = 33,
+         sys_fork              = 57,
+         sys_wait4             = 61,
+         sys_sched_getaffinity = 204,
+         sys_exit_group        = 231
+      };
+      constexpr long  eintr  = 4;
+      constexpr short pollin = 0x1;
+
+      struct pollfd {
+         int   fd;
+         short events;
+         short revents;
+      };
+
+      using host::syscall;
+#endif
+
+      uint64_t now_us() { return host::monotonic_ns() / 1000; }
+
+      void write_out( const std::string& s ) { host::write_stdout(s.data(), s.size()); }
+
+      std::string format_ms( uint64_t us ) {
+         std::string frac = std::to_string(us % 1000);
+         return std::to_string(us / 1000) + "." + std::string(3 - frac.size(), '0') + frac + " ms";
+      }
+
+      // runs one test case in this process the way EOSIO_TEST does
+      bool run_case( const test_runner::test_function& test ) {
+         ___has_failed = false;
+         std_out.clear();
+         std_err.clear();
+         return catch_assert(test) && !___has_failed;
+      }
+   }
+
+   uint32_t test_runner::hardware_concurrency() {
+#ifndef __APPLE__
+      uint64_t mask[16] = {};
+      const long size = syscall(sys_sched_getaffinity, 0, sizeof(mask), (long)mask);
+      uint32_t count = 0;
+      for (long i = 0; i < size / long(sizeof(uint64_t)); i++)
+         count += __builtin_popcountll(mask[i]);
+      return std::max(count, 1u);
+#else
+      return 1;
+#endif
+   }
+
+   std::vector<test_result> test_runner::run_all( uint32_t jobs, const std::vector<std::string>& filter )const {
+      std::vector<const std::pair<std::string, test_function>*> selected;
+      for (const auto& test : _tests)
+         if (filter.empty() || std::find(filter.begin(), filter.end(), test.first) != filter.end())
+            selected.push_back(&test);
+
+      std::vector<test_result> results(selected.size());
+      for (size_t i = 0; i < selected.size(); i++)
+         results[i].name = selected[i]->first;
+
+#ifndef __APPLE__
+      struct worker {
+         size_t   index;
+         long     pid;
+         int      fd;
+         uint64_t start;
+      };
+      std::vector<worker> running;
+      size_t next = 0;
+      jobs = std::max(jobs, 1u);
+
+      while (next < selected.size() || !running.empty()) {
+         while (running.size() < jobs && next < selected.size()) {
+            int fds[2];
+            eosio_assert(syscall(sys_pipe, (long)fds) == 0, "test runner could not create a pipe");
+            const uint64_t start = now_us();
+            // the worker would write out a copy of anything still buffered
+            host::flush_stdout();
+            const long pid = syscall(sys_fork);
+            eosio_assert(pid >= 0, "test runner could not fork a worker");
+            if (pid == 0) {
+               // the worker reports through its exit code, everything it prints goes to the pipe
+               syscall(sys_close, fds[0]);
+               syscall(sys_dup2, fds[1], 1);
+               syscall(sys_dup2, fds[1], 2);
+               syscall(sys_close, fds[1]);
+               ___disable_output = false;
+               const bool passed = run_case(selected[next]->second);
+               host::flush_stdout();
+               syscall(sys_exit_group, passed ? 0 : 1);
+            }
+            syscall(sys_close, fds[1]);
+            running.push_back({next++, pid, fds[0], start});
+         }
+
+         std::vector<pollfd> fds;
+         for (const auto& w : running)
+            fds.push_back({w.fd, pollin, 0});
+         if (syscall(sys_poll, (long)fds.data(), fds.size(), -1) < 0)
+            continue;
+
+         for (size_t i = fds.size(); i-- > 0;) {
+            if (fds[i].revents == 0)
+               continue;
+            worker& w = running[i];
+            test_result& result = results[w.index];
+            char buffer[4096];
+            const long n = syscall(sys_read, w.fd, (long)buffer, sizeof(buffer));
+            if (n > 0) {
+               result.output.append(buffer, n);
+               continue;
+            }
+            if (n == -eintr)
+               continue;
+            // end of output, the worker is done
+            syscall(sys_close, w.fd);
+            int status = 0;
+            while (syscall(sys_wait4, w.pid, (long)&status, 0, 0) == -eintr)
+               ;
+            result.duration_us = now_us() - w.start;
+            const int signal = status & 0x7f;
+            result.passed = signal == 0 && ((status >> 8) & 0xff) == 0;
+            if (signal != 0)
+               result.output += "worker killed by signal " + std::to_string(signal) + "\n";
+            running.erase(running.begin() + i);
+         }
+      }
+#else
+      // no fork, run in this process and let the output go straight to stdout
+      for (size_t i = 0; i < selected.size(); i++) {
+         const uint64_t start = now_us();
+         results[i].passed = run_case(selected[i]->second);
+         results[i].duration_us = now_us() - start;
+      }
+#endif
+      return results;
+   }
+
+   int test_runner::run( int argc, char** argv )const {
+      uint32_t jobs = hardware_concurrency();
+      std::vector<std::string> filter;
+      for (int i = 1; i < argc; i++) {
+         const std::string arg = argv[i];
+         if (arg == "-j" && i + 1 < argc)
+            jobs = std::max(std::atoi(argv[++i]), 1);
+         else if (arg.size() > 2 && arg.compare(0, 2, "-j") == 0)
+            jobs = std::max(std::atoi(arg.c_str() + 2), 1);
+         else
+            filter.push_back(arg);
+      }
+      for (const auto& name : filter) {
+         if (std::none_of(_tests.begin(), _tests.end(), [&](const auto& t) { return t.first == name; })) {
+            write_out("unknown test case " + name + "\n");
+            return 1;
+         }
+      }
+
+      const uint64_t start = now_us();
+      const auto results = run_all(jobs, filter);
+      const uint64_t wall_us = now_us() - start;
+
+      uint64_t total_us = 0;
+      std::vector<std::string> failed;
+      for (const auto& result : results) {
+         if (!result.passed || !___disable_output)
+            write_out(result.output);
+         write_out("\033[1;37m" + result.name + " \033[0;37munit test " +
+                   (result.passed ? "\033[1;32mpassed" : "\033[1;31mfailed") + "\033[0m (" +
+                   format_ms(result.duration_us) + ")\n");
+         total_us += result.duration_us;
+         if (!result.passed)
+            failed.push_back(result.name);
+      }
+
+      write_out(std::to_string(results.size()) + " test cases, " + std::to_string(failed.size()) + " failed, " +
+                format_ms(wall_us) + " wall clock on " + std::to_string(jobs) + " workers, " +
+                format_ms(total_us) + " in test cases\n");
+      for (const auto& name : failed)
+         write_out("   failed: " + name + "\n");
+      return failed.empty() ? 0 : 1;
+   }
+
+}} //ns eosio::native
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    * Outcome of one test case run by test_runner
+    */
+   struct test_result {
+      std::string name;
+      bool        passed      = false;
+      uint64_t    duration_us = 0;
+      std::string output; ///< everything the test case printed, including the assert message on failure
+   };
+
+   /**
+    * Runs EOSIO_TEST_BEGIN/EOSIO_TEST_END test cases in forked worker processes
+    *
+    * Every test case gets a process of its own, so the jmp_buf, the output buffers, the intrinsic overrides and
+    * the database of one case cannot leak into another, and up to `jobs` cases run at the same time. The output
+    * of a case is collected and printed in one piece once it finishes, so parallel cases do not interleave.
+    * A case fails if it asserts, if a CHECK_* fails or if the worker dies.
+    *
+    * On macOS the cases run one after the other in the runner process.
+    *
+    * Example:
+    * @code
+    * int main(int argc, char** argv) {
+    *    silence_output(true);
+    *    test_runner runner;
+    *    EOSIO_TEST_ADD(runner, primary_index_test);
+    *    EOSIO_TEST_ADD(runner, secondary_index_test);
+    *    return runner.run(argc, argv);
+    * }
+    * @endcode
+    */
+   class test_runner {
+      public:
+         using test_function = std::function<void()>;
+
+         void add( std::string name, test_function test ) {
+            _tests.emplace_back(std::move(name), std::move(test));
+         }
+
+         /**
+          * Run the test cases whose name is in `filter`, or all of them if it is empty, `jobs` at a time
+          *
+          * @return the results in the order the cases were added
+          */
+         std::vector<test_result> run_all( uint32_t jobs, const std::vector<std::string>& filter = {} )const;
+
+         /**
+          * Command line entry point
+          *
+          * `-j N` sets the number of workers, one per core by default, other arguments select test cases by name.
+          * Prints one line per case with its duration, the output of failed cases (of all cases unless the output is
+          * silenced) and a summary.
+          *
+          * @return 0 if every case passed, 1 otherwise
+          */
+         int run( int argc, char** argv )const;
+
+         /**
+          * Number of cores this process may run on
+          */
+         static uint32_t hardware_concurrency();
+
+      private:
+         std::vector<std::pair<std::string, test_function>> _tests;
+   };
+
+}} //ns eosio::native
+
+#define EOSIO_TEST_ADD(RUNNER, X) \
+   RUNNER.add(#X, X);
@@ -0,0 +1,212 @@
+#include "simulator.hpp"
+#include "clock.hpp"
+#include "database.hpp"
+#include "intrinsics.hpp"
+#include "crt.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <setjmp.h>
+
+namespace eosio { namespace native {
+
+   void simulator::create_account( eosio::name account ) {
+      _accounts.emplace(account, apply_handler{});
+   }
+
+   void simulator::set_contract( eosio::name account, apply_handler apply ) {
+      _accounts[account] = std::move(apply);
+   }
+
+   bool simulator::is_account( eosio::name account )const {
+      return _accounts.count(account) != 0;
+   }
+
+   transaction_result simulator::push_action( const eosio::action& act ) {
+      return push_transaction({act});
+   }
+
+   transaction_result simulator::push_transaction( const std::vector<eosio::action>& actions ) {
+      // the contracts abort through eosio_assert, which longjmps to *___env_ptr
+      jmp_buf env;
+      jmp_buf* prev_env = ___env_ptr;
+      const auto prev_intrinsics = intrinsics::get().funcs;
+      const database::revision db_revision = database::get().snapshot();
+      const auto deferred_backup = _deferred;
+
+      _traces.clear();
+      _ctx = nullptr;
+      std_err.clear();
+      install_intrinsics();
+
+      transaction_result result;
+      ___env_ptr = &env;
+      if (setjmp(env) == 0) {
+         for (const auto& act : actions)
+            execute(act, 0);
+         result.succeeded = true;
+      } else {
+         result.error = std_err.to_string();
+         std_err.clear();
+         database::get().restore(db_revision);
+         _deferred = deferred_backup;
+      }
+      database::get().release(db_revision);
+      ___env_ptr = prev_env;
+      intrinsics::get().funcs = prev_intrinsics;
+      _ctx = nullptr;
+      result.traces = std::move(_traces);
+      return result;
+   }
+
+   std::vector<transaction_result> simulator::advance( eosio::microseconds delta ) {
+      auto& clock = virtual_clock::get();
+      const eosio::time_point target = clock.now() + delta;
+      std::vector<transaction_result> results;
+      for (;;) {
+         // the first of several equally due transactions is the one sent first
+         auto next = std::min_element(_deferred.begin(), _deferred.end(), [](const auto& a, const auto& b) {
+               return a.delay_until < b.delay_until;
+            });
+         if (next == _deferred.end() || next->delay_until > target)
+            break;
+         const deferred_transaction due = std::move(*next);
+         _deferred.erase(next);
+         if (due.delay_until > clock.now())
+            clock.set(due.delay_until);
+         results.push_back(push_transaction(due.trx.actions));
+      }
+      clock.set(target);
+      return results;
+   }
+
+   state_snapshot simulator::snapshot() {
+      return {database::get().snapshot(), virtual_clock::get().now(), _accounts, _deferred};
+   }
+
+   void simulator::restore( const state_snapshot& s ) {
+      database::get().restore(s.db_revision);
+      virtual_clock::get().restore(s.time);
+      _accounts = s.accounts;
+      _deferred = s.deferred;
+   }
+
+   void simulator::release( const state_snapshot& s ) {
+      database::get().release(s.db_revision);
+   }
+
+   std::vector<deferred_transaction>::iterator simulator::find_deferred( eosio::name sender, const uint128_t& sender_id ) {
+      return std::find_if(_deferred.begin(), _deferred.end(), [&](const auto& d) {
+            return d.sender == sender && d.sender_id == sender_id;
+         });
+   }
+
+   void simulator::execute( const eosio::action& act, uint32_t depth ) {
+      if (!is_account(act.account))
+         eosio_assert(false, ("action's receiving account "+act.account.to_string()+" does not exist").c_str());
+
+      apply_context ctx{act, act.account, depth, {act.account}, {}, {}};
+      // notified grows while the receivers run
+      for (size_t i = 0; i < ctx.notified.size(); i++)
+         exec_one(ctx, ctx.notified[i]);
+
+      // as in nodeos, an action at the maximum depth runs and only fails if it sends inline actions
+      if (!ctx.cfa_inline_actions.empty() || !ctx.inline_actions.empty())
+         eosio_assert(depth < max_inline_action_depth, "max inline action depth per transaction reached");
+      for (const auto& inline_action : ctx.cfa_inline_actions)
+         execute(inline_action, depth + 1);
+      for (const auto& inline_action : ctx.inline_actions)
+         execute(inline_action, depth + 1);
+   }
+
+   void simulator::exec_one( apply_context& ctx, eosio::name receiver ) {
+      auto itr = _accounts.find(receiver);
+      if (itr == _accounts.end())
+         eosio_assert(false, ("notified account "+receiver.to_string()+" does not exist").c_str());
+      ctx.receiver = receiver;
+      _traces.push_back({receiver, ctx.act, ctx.depth});
+
+      const auto& apply = itr->second;
+      if (!apply)
+         return;
+      // every receiver starts with a fresh iterator cache, as in nodeos
+      database::get().reset_iterators();
+      _ctx = &ctx;
+      apply(receiver.value, ctx.act.account.value, ctx.act.name.value);
+      _ctx = nullptr;
+   }
+
+   bool simulator::has_authorization( eosio::name actor, eosio::name permission )const {
+      return std::any_of(_ctx->act.authorization.begin(), _ctx->act.authorization.end(), [&](const auto& auth) {
+            return auth.actor == actor && (permission == eosio::name{} || auth.permission == permission);
+         });
+   }
+
+   void simulator::install_intrinsics() {
+      intrinsics::set_intrinsic<intrinsics::current_receiver>([this]() {
+            eosio_assert(_ctx != nullptr, "current_receiver called outside of an action");
+            return _ctx->receiver.value;
+         });
+      intrinsics::set_intrinsic<intrinsics::action_data_size>([this]() {
+            return (uint32_t)_ctx->act.data.size();
+         });
+      intrinsics::set_intrinsic<intrinsics::read_action_data>([this](void* msg, uint32_t len) {
+            const uint32_t size = _ctx->act.data.size();
+            if (len == 0)
+               return size;
+            const uint32_t copy_size = std::min(len, size);
+            memcpy(msg, _ctx->act.data.data(), copy_size);
+            return copy_size;
+         });
+      intrinsics::set_intrinsic<intrinsics::is_inline>([this]() {
+            return _ctx->depth > 0;
+         });
+      intrinsics::set_intrinsic<intrinsics::is_account>([this](capi_name account) {
+            return is_account(eosio::name{account});
+         });
+      intrinsics::set_intrinsic<intrinsics::require_recipient>([this](capi_name recipient) {
+            auto& notified = _ctx->notified;
+            if (std::find(notified.begin(), notified.end(), eosio::name{recipient}) == notified.end())
+               notified.push_back(eosio::name{recipient});
+         });
+      intrinsics::set_intrinsic<intrinsics::has_auth>([this](capi_name account) {
+            return has_authorization(eosio::name{account}, eosio::name{});
+         });
+      intrinsics::set_intrinsic<intrinsics::require_auth>([this](capi_name account) {
+            if (!has_authorization(eosio::name{account}, eosio::name{}))
+               eosio_assert(false, ("missing authority of "+eosio::name{account}.to_string()).c_str());
+         });
+      intrinsics::set_intrinsic<intrinsics::require_auth2>([this](capi_name account, capi_name permission) {
+            if (!has_authorization(eosio::name{account}, eosio::name{permission}))
+               eosio_assert(false, ("missing authority of "+eosio::name{account}.to_string()+"/"+
+                                    eosio::name{permission}.to_string()).c_str());
+         });
+      intrinsics::set_intrinsic<intrinsics::send_inline>([this](char* serialized_action, size_t size) {
+            _ctx->inline_actions.push_back(eosio::unpack<eosio::action>(serialized_action, size));
+         });
+      intrinsics::set_intrinsic<intrinsics::send_context_free_inline>([this](char* serialized_action, size_t size) {
+            auto act = eosio::unpack<eosio::action>(serialized_action, size);
+            eosio_assert(act.authorization.empty(), "context-free actions cannot have authorizations");
+            _ctx->cfa_inline_actions.push_back(std::move(act));
+         });
+      intrinsics::set_intrinsic<intrinsics::send_deferred>([this](const uint128_t& sender_id, capi_name payer, const char* serialized_transaction, size_t size, uint32_t replace_existing) {
+            auto trx = eosio::unpack<eosio::transaction>(serialized_transaction, size);
+            eosio_assert(trx.context_free_actions.empty(), "context free actions are not currently allowed in generated transactions");
+            auto itr = find_deferred(_ctx->receiver, sender_id);
+            if (itr != _deferred.end()) {
+               eosio_assert(replace_existing, "deferred transaction with the same sender_id and payer already exists");
+               _deferred.erase(itr);
+            }
+            const auto delay_until = virtual_clock::get().now() + eosio::seconds(trx.delay_sec.value);
+            _deferred.push_back({_ctx->receiver, sender_id, eosio::name{payer}, delay_until, std::move(trx)});
+         });
+      intrinsics::set_intrinsic<intrinsics::cancel_deferred>([this](const uint128_t& sender_id) {
+            auto itr = find_deferred(_ctx->receiver, sender_id);
+            if (itr == _deferred.end())
+               return 0;
+            _deferred.erase(itr);
+            return 1;
+         });
+   }
+
+}} //ns eosio::native
@@ -0,0 +1,145 @@
+#pragma once
+#include "database.hpp"
+
+#include <eosiolib/action.hpp>
+#include <eosiolib/name.hpp>
+#include <eosiolib/time.hpp>
+#include <eosiolib/transaction.hpp>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace native {
+
+   /**
+    * Entry point of a natively compiled contract, same arguments as `apply`
+    */
+   using apply_handler = std::function<void(uint64_t receiver, uint64_t code, uint64_t action)>;
+
+   /**
+    * One execution of an action by a receiver, in the order the simulator ran them
+    */
+   struct action_trace {
+      eosio::name   receiver;
+      eosio::action act;
+      uint32_t      depth = 0; ///< 0 for actions of the transaction, n for inline actions n levels deep
+   };
+
+   /**
+    * Outcome of simulator::push_transaction()
+    */
+   struct transaction_result {
+      bool                      succeeded = false;
+      std::string               error;  ///< assert message of the failing action, empty on success
+      std::vector<action_trace> traces; ///< every action run, including those of a failed transaction
+   };
+
+   /**
+    * A transaction scheduled with send_deferred() that has not fired yet
+    */
+   struct deferred_transaction {
+      eosio::name        sender;
+      uint128_t          sender_id = 0;
+      eosio::name        payer;
+      eosio::time_point  delay_until;
+      eosio::transaction trx;
+   };
+
+   /**
+    * Chain state saved by simulator::snapshot()
+    */
+   struct state_snapshot {
+      database::revision                   db_revision = 0;
+      eosio::time_point                    time;
+      std::map<eosio::name, apply_handler> accounts;
+      std::vector<deferred_transaction>    deferred;
+   };
+
+   /**
+    * Runs several natively compiled contracts against the in-memory database
+    *
+    * Each account gets its own apply handler. Actions are executed in nodeos order: the receiver, then every
+    * account added with require_recipient() in the order they were added, then the context free and regular
+    * inline actions, each depth first with its own notifications. A failing assert aborts the whole
+    * transaction and restores the database and the deferred queue to the state they had before the transaction.
+    *
+    * Deferred transactions are held until advance() moves the virtual clock past their delay, they then run
+    * in delay order, ties in the order they were sent.
+    *
+    * snapshot() saves the database, the virtual clock, the accounts and the deferred queue. A fixture built once
+    * can then be restored before every test case, restoring only undoes the rows changed since the snapshot.
+    *
+    * Only one contract per test binary can export `apply`, compile the others with `-Dapply=<name>_apply`
+    * or register lambdas built on `eosio::execute_action`.
+    *
+    * Example:
+    * @code
+    * simulator sim;
+    * sim.set_contract("eosio.token"_n, token_apply);
+    * sim.set_contract("exchange"_n, exchange_apply);
+    * sim.create_account("alice"_n);
+    * auto res = sim.push_action(action{{"alice"_n, "active"_n}, "eosio.token"_n, "transfer"_n,
+    *                                   std::make_tuple("alice"_n, "exchange"_n, quantity, memo)});
+    * CHECK_EQUAL( res.succeeded, true );
+    * @endcode
+    */
+   class simulator {
+      public:
+         static constexpr uint32_t max_inline_action_depth = 4;
+
+         void create_account( eosio::name account );
+         void set_contract( eosio::name account, apply_handler apply );
+         bool is_account( eosio::name account )const;
+
+         transaction_result push_action( const eosio::action& act );
+         transaction_result push_transaction( const std::vector<eosio::action>& actions );
+
+         /**
+          * Advance the virtual clock by `delta`, running every deferred transaction that becomes due
+          *
+          * @return the results of the deferred transactions run, in execution order
+          */
+         std::vector<transaction_result> advance( eosio::microseconds delta );
+
+         const std::vector<deferred_transaction>& deferred_transactions()const { return _deferred; }
+
+         /**
+          * Save the chain state, see database::snapshot() for how snapshots nest
+          */
+         state_snapshot snapshot();
+
+         /**
+          * Go back to the state saved in `s`, which stays open and can be restored again
+          */
+         void restore( const state_snapshot& s );
+
+         /**
+          * Close `s` and all newer snapshots, keeping the current state
+          */
+         void release( const state_snapshot& s );
+
+      private:
+         struct apply_context {
+            const eosio::action&       act;
+            eosio::name                receiver;
+            uint32_t                   depth;
+            std::vector<eosio::name>   notified;
+            std::vector<eosio::action> inline_actions;
+            std::vector<eosio::action> cfa_inline_actions;
+         };
+
+         void install_intrinsics();
+         void execute( const eosio::action& act, uint32_t depth );
+         void exec_one( apply_context& ctx, eosio::name receiver );
+         bool has_authorization( eosio::name actor, eosio::name permission )const;
+         std::vector<deferred_transaction>::iterator find_deferred( eosio::name sender, const uint128_t& sender_id );
+
+         std::map<eosio::name, apply_handler> _accounts;
+         apply_context*                       _ctx = nullptr;
+         std::vector<action_trace>            _traces;
+         std::vector<deferred_transaction>    _deferred;
+   };
+
+}} //ns eosio::native
@@ -74,19 +74,19 @@ template <size_t N, typename F, typename... Args>
 inline bool expect_print(bool check, const std::string& li, const char (&expected)[N], F&& func, Args... args) {
    return expect_print(check, li, 
          [&](const std::string& s) { 
-            return std_out.index-1 == N-1 &&
+            return std_out.index == N-1 &&
             memcmp(expected, s.c_str(), N-1) == 0; }, func, args...);
 
 }
 
 #define CHECK_ASSERT(...) \
-   ___has_failed &= expect_assert(true, std::string(__FILE__)+":"+__func__+":"+(std::to_string(__LINE__)), __VA_ARGS__);
+   ___has_failed |= !expect_assert(true, std::string(__FILE__)+":"+__func__+":"+(std::to_string(__LINE__)), __VA_ARGS__);
 
 #define REQUIRE_ASSERT(...) \
    expect_assert(false, std::string(__FILE__)+":"+__func__+":"+(std::to_string(__LINE__)),  __VA_ARGS__);
 
 #define CHECK_PRINT(...) \
-   ___has_failed &= expect_print(true, std::string(__FILE__)+":"+__func__+":"+(std::to_string(__LINE__)), __VA_ARGS__);
+   ___has_failed |= !expect_print(true, std::string(__FILE__)+":"+__func__+":"+(std::to_string(__LINE__)), __VA_ARGS__);
 
 #define REQUIRE_PRINT(...) \
    expect_print(false, std::string(__FILE__)+":"+__func__+":"+(std::to_string(__LINE__)),  __VA_ARGS__);
@@ -105,18 +105,26 @@ inline bool expect_print(bool check, const std::string& li, const char (&expecte
    if ( X ## _ret == 0 ) \
       X(); \
    else { \
+      const bool __disable_output = ___disable_output; \
       silence_output(false); \
       eosio::print("\033[1;37m", #X, " \033[0;37munit test \033[1;31mfailed\033[0m\n"); \
       ___has_failed = true; \
-      silence_output(___disable_output); \
+      silence_output(__disable_output); \
    }
 
 #define EOSIO_TEST_BEGIN(X) \
    void X() { \
-      static constexpr const char* __test_name = #X;
+      static constexpr const char* __test_name = #X; \
+      const bool __failed_before = ___has_failed; \
+      ___has_failed = false;
 
 #define EOSIO_TEST_END \
+      const bool __disable_output = ___disable_output; \
       silence_output(false); \
-      eosio::print("\033[1;37m",__test_name," \033[0;37munit test \033[1;32mpassed\033[0m\n"); \
-      silence_output(___disable_output); \
+      if (___has_failed) \
+         eosio::print("\033[1;37m",__test_name," \033[0;37munit test \033[1;31mfailed\033[0m\n"); \
+      else \
+         eosio::print("\033[1;37m",__test_name," \033[0;37munit test \033[1;32mpassed\033[0m\n"); \
+      silence_output(__disable_output); \
+      ___has_failed |= __failed_before; \
    }
@@ -65,6 +65,7 @@ eosio_tool_install(eosio-ld)
 eosio_tool_install(eosio-abigen)
 eosio_tool_install(eosio-abidiff)
 eosio_tool_install(eosio-init)
+eosio_tool_install(eosio-run)
 eosio_clang_install(../lib/LLVMEosioApply${CMAKE_SHARED_LIBRARY_SUFFIX})
 eosio_clang_install(../lib/LLVMEosioSoftfloat${CMAKE_SHARED_LIBRARY_SUFFIX})
 eosio_clang_install(../lib/eosio_plugin${CMAKE_SHARED_LIBRARY_SUFFIX})
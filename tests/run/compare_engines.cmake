@@ -0,0 +1,71 @@
+# Runs the actions of engines.wat through the interpreter and through the library eosio-run --compile builds from
+# it, and fails unless both engines print the same and fail with the same error.
+#
+# cmake -DEOSIO_RUN=<eosio-run> -DWAST2WASM=<eosio-wast2wasm> -DCONTRACT=<engines.wat> -DWORK_DIR=<dir>
+#       -P compare_engines.cmake
+
+# action|the last lines of its output
+set(cases
+   "print|hello-4218446744073709551615\nsuccess"
+   "float|1.500000e+00-2.500000000000000e-013.125000e+00\nsuccess"
+   "data|0a0b0c\nsuccess"
+   "grow|1-147\nsuccess"
+   "exit|hello\nsuccess"
+   "assert|error: assertion failure with message: assertion failed in the contract"
+   "unreachable|error: wasm trap: unreachable executed"
+   "oob|error: wasm trap: out of bounds memory access"
+   "divzero|error: wasm trap: integer divide by zero"
+   "overflow|error: wasm trap: integer overflow"
+   "conv|error: wasm trap: invalid conversion to integer"
+   "indirect|error: wasm trap: invalid indirect call"
+   "stack|error: wasm trap: call stack exhausted")
+
+function(run_checked)
+   execute_process(COMMAND ${ARGN} RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+   if (NOT result EQUAL 0)
+      message(FATAL_ERROR "${ARGN} failed:\n${output}")
+   endif()
+endfunction()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+set(wasm ${WORK_DIR}/engines.wasm)
+set(library ${WORK_DIR}/engines.so)
+run_checked(${WAST2WASM} ${CONTRACT} -o ${wasm})
+run_checked(${EOSIO_RUN} ${wasm} --compile ${library})
+
+set(failures 0)
+foreach(entry ${cases})
+   string(FIND "${entry}" "|" split)
+   string(SUBSTRING "${entry}" 0 ${split} action)
+   math(EXPR split "${split} + 1")
+   string(SUBSTRING "${entry}" ${split} -1 expected)
+   string(REPLACE "\\n" "\n" expected "${expected}")
+
+   foreach(contract wasm library)
+      execute_process(COMMAND ${EOSIO_RUN} ${${contract}} --receiver engine --action ${action} --data 0a0b0c --time 0
+                      RESULT_VARIABLE ${contract}_result OUTPUT_VARIABLE ${contract}_output
+                      ERROR_VARIABLE ${contract}_output)
+   endforeach()
+
+   # the last lines of the output, compared as text
+   string(LENGTH "\n${expected}\n" tail_length)
+   string(LENGTH "\n${wasm_output}" output_length)
+   set(tail "")
+   if (NOT output_length LESS tail_length)
+      math(EXPR tail_start "${output_length} - ${tail_length}")
+      string(SUBSTRING "\n${wasm_output}" ${tail_start} -1 tail)
+   endif()
+
+   if (NOT "${wasm_output}" STREQUAL "${library_output}" OR NOT "${wasm_result}" STREQUAL "${library_result}")
+      message("${action}: the engines differ\nwasm (${wasm_result}):\n${wasm_output}native (${library_result}):\n${library_output}")
+      math(EXPR failures "${failures} + 1")
+   elseif (NOT "${tail}" STREQUAL "\n${expected}\n")
+      message("${action}: expected the output to end with\n${expected}\nbut it was\n${wasm_output}")
+      math(EXPR failures "${failures} + 1")
+   endif()
+endforeach()
+
+if (failures)
+   message(FATAL_ERROR "${failures} actions failed")
+endif()
@@ -0,0 +1,69 @@
+;; The same actions run through the interpreter and through the library eosio-run --compile builds from this
+;; contract, see compare_engines.cmake. Every action exercises one part of the native glue or one kind of trap.
+(module
+  (type $v (func))
+  (import "env" "prints_l" (func $prints_l (param i32 i32)))
+  (import "env" "printi" (func $printi (param i64)))
+  (import "env" "printui" (func $printui (param i64)))
+  (import "env" "printsf" (func $printsf (param f32)))
+  (import "env" "printdf" (func $printdf (param f64)))
+  (import "env" "printhex" (func $printhex (param i32 i32)))
+  (import "env" "_eosio_f32_promote" (func $promote (param f32) (result f64)))
+  (import "env" "_eosio_f64_demote" (func $demote (param f64) (result f32)))
+  (import "env" "action_data_size" (func $action_data_size (result i32)))
+  (import "env" "read_action_data" (func $read_action_data (param i32 i32) (result i32)))
+  (import "env" "eosio_assert" (func $eosio_assert (param i32 i32)))
+  (import "env" "eosio_exit" (func $eosio_exit (param i32)))
+  (table 2 anyfunc)
+  (elem (i32.const 0) $nothing)
+  (memory 1 4)
+  (data (i32.const 16) "hello\00")
+  (data (i32.const 32) "assertion failed in the contract\00")
+  (func $nothing)
+  (func $recurse (param i64) (result i64)
+    (call $recurse (i64.add (get_local 0) (i64.const 1))))
+  ;; without an exported memory the native engine adds one
+  (func $apply (export "apply") (param i64 i64 i64)
+    ;; print: strings and integers
+    (if (i64.eq (get_local 2) (i64.const 0xaddd3c8000000000)) (then
+      (call $prints_l (i32.const 16) (i32.const 5))
+      (call $printi (i64.const -42))
+      (call $printui (i64.const 0xffffffffffffffff))))
+    ;; float: floats travel through the glue as their bits, in both directions
+    (if (i64.eq (get_local 2) (i64.const 0x5c686c8000000000)) (then
+      (call $printsf (f32.const 1.5))
+      (call $printdf (call $promote (f32.const -0.25)))
+      (call $printsf (call $demote (f64.const 3.125)))))
+    ;; data: the host writes into the memory of the contract
+    (if (i64.eq (get_local 2) (i64.const 0x49b2600000000000)) (then
+      (drop (call $read_action_data (i32.const 1024) (call $action_data_size)))
+      (call $printhex (i32.const 1024) (call $action_data_size))))
+    ;; grow: the memory grows up to its maximum and no further
+    (if (i64.eq (get_local 2) (i64.const 0x65e9c00000000000)) (then
+      (call $printi (i64.extend_s/i32 (grow_memory (i32.const 3))))
+      (call $printi (i64.extend_s/i32 (grow_memory (i32.const 1))))
+      (call $printi (i64.extend_s/i32 (current_memory)))
+      (i32.store (i32.const 0x3fffc) (i32.const 7))
+      (call $printi (i64.extend_u/i32 (i32.load (i32.const 0x3fffc))))))
+    ;; exit: ends the action successfully, the second print never happens
+    (if (i64.eq (get_local 2) (i64.const 0x575d900000000000)) (then
+      (call $prints_l (i32.const 16) (i32.const 5))
+      (call $eosio_exit (i32.const 0))
+      (call $prints_l (i32.const 16) (i32.const 5))))
+    (if (i64.eq (get_local 2) (i64.const 0x3630abe400000000)) (then
+      (call $prints_l (i32.const 16) (i32.const 5))
+      (call $eosio_assert (i32.const 0) (i32.const 32))))
+    (if (i64.eq (get_local 2) (i64.const 0xd4eea321a63c5400)) (then
+      unreachable))
+    (if (i64.eq (get_local 2) (i64.const 0xa50e000000000000)) (then
+      (drop (i32.load (i32.const 0x10000)))))
+    (if (i64.eq (get_local 2) (i64.const 0x4bb7f55e80000000)) (then
+      (drop (i32.div_s (i32.const 1) (i32.const 0)))))
+    (if (i64.eq (get_local 2) (i64.const 0xa6d575c69c000000)) (then
+      (drop (i32.div_s (i32.const 0x80000000) (i32.const -1)))))
+    (if (i64.eq (get_local 2) (i64.const 0x4527b00000000000)) (then
+      (drop (i32.trunc_s/f64 (f64.const nan)))))
+    (if (i64.eq (get_local 2) (i64.const 0x74d2eba919000000)) (then
+      (call_indirect (type $v) (i32.const 1))))
+    (if (i64.eq (get_local 2) (i64.const 0xc64c880000000000)) (then
+      (drop (call $recurse (i64.const 0)))))))
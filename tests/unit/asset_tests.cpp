@@ -0,0 +1,63 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/asset.hpp>
+#include <eosio/native/tester.hpp>
+
+using namespace eosio::native;
+using eosio::asset;
+using eosio::symbol;
+using eosio::symbol_code;
+
+EOSIO_TEST_BEGIN(symbol_literal_test)
+   silence_output(true);
+   constexpr auto eos = "4,EOS"_sym;
+   static_assert( eos.precision() == 4, "symbol precision should be parsed at compile time" );
+   CHECK_EQUAL( eos == symbol(symbol_code("EOS"), 4), true );
+   CHECK_EQUAL( symbol{"18,MAX"}.precision(), 18 );
+
+   CHECK_ASSERT( "symbol string must be of the form precision,CODE", ([]() { symbol{"EOS"}; }) );
+   CHECK_ASSERT( "symbol precision must be a number", ([]() { symbol{"a,EOS"}; }) );
+   CHECK_ASSERT( "symbol precision must be at most 18", ([]() { symbol{"19,EOS"}; }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(asset_parse_test)
+   silence_output(true);
+   constexpr auto one = "1.0000 EOS"_a;
+   static_assert( one.amount == 10000, "asset amount should be parsed at compile time" );
+   CHECK_EQUAL( one.symbol == "4,EOS"_sym, true );
+   CHECK_EQUAL( asset{"-0.0005 EOS"}.amount, -5 );
+   CHECK_EQUAL( asset{"42 SYS"}.symbol == "0,SYS"_sym, true );
+   CHECK_EQUAL( asset{"4611686018427387903 SYS"}.amount, asset::max_amount );
+
+   CHECK_ASSERT( "asset string must contain an amount and a symbol code", ([]() { asset{"1.0000EOS"}; }) );
+   CHECK_ASSERT( "asset amount is missing", ([]() { asset{"-.5 EOS"}; }) );
+   CHECK_ASSERT( "missing decimal fraction after decimal point", ([]() { asset{"1. EOS"}; }) );
+   CHECK_ASSERT( "asset amount has more than one decimal point", ([]() { asset{"1.0.0 EOS"}; }) );
+   CHECK_ASSERT( "invalid character in asset amount", ([]() { asset{"1,0 EOS"}; }) );
+   CHECK_ASSERT( "magnitude of asset amount must be less than 2^62", ([]() { asset{"4611686018427387904 EOS"}; }) );
+   CHECK_ASSERT( "only uppercase letters allowed in symbol_code string", ([]() { asset{"1.0 eos"}; }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(asset_to_string_test)
+   silence_output(true);
+   CHECK_EQUAL( "1.0000 EOS"_a.to_string(), "1.0000 EOS" );
+   CHECK_EQUAL( "-1.2300 EOS"_a.to_string(), "-1.2300 EOS" );
+   CHECK_EQUAL( "-0.0005 EOS"_a.to_string(), "-0.0005 EOS" );
+   CHECK_EQUAL( "42 SYS"_a.to_string(), "42 SYS" );
+   CHECK_EQUAL( asset(asset::max_amount, symbol("ABCDEFG", 18)).to_string(), "4.611686018427387903 ABCDEFG" );
+
+   char buffer[asset::max_string_size];
+   const auto value = "12.345 TOK"_a;
+   CHECK_EQUAL( value.write_as_string(buffer, buffer + 4) == buffer, true );
+   auto end = value.write_as_string( buffer, buffer + sizeof(buffer) );
+   CHECK_EQUAL( std::string(buffer, end), "12.345 TOK" );
+   silence_output(false);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   EOSIO_TEST(symbol_literal_test);
+   EOSIO_TEST(asset_parse_test);
+   EOSIO_TEST(asset_to_string_test);
+   return has_failed();
+}
@@ -0,0 +1,82 @@
+#include <eosiolib/eosio.hpp>
+#include <eosio/native/tester.hpp>
+#include <eosio/native/bench.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+EOSIO_BENCH_BEGIN(receiver_bench)
+   EOSIO_BENCH_LOOP {
+      do_not_optimize(current_receiver());
+   }
+EOSIO_BENCH_END
+
+EOSIO_BENCH_BEGIN(asserting_bench)
+   eosio_assert(false, "asserted in benchmark");
+EOSIO_BENCH_END
+
+EOSIO_TEST_BEGIN(bench_test)
+   char* argv[] = { (char*)"bench_tests", (char*)"--samples=5", (char*)"--warmup-ms=1", (char*)"receiver_bench" };
+   bench_runner bench(4, argv);
+   intrinsic_override<intrinsics::current_receiver> receiver([]() { return "bench"_n.value; });
+   EOSIO_BENCH(bench, receiver_bench);
+   EOSIO_BENCH(bench, asserting_bench); // filtered out
+
+   const auto& results = bench.results();
+   CHECK_EQUAL( results.size(), 1 );
+   CHECK_EQUAL( results[0].name, "receiver_bench" );
+   CHECK_EQUAL( results[0].samples, 5 );
+   CHECK_EQUAL( results[0].iterations > 0, true );
+   CHECK_EQUAL( results[0].min_ps <= results[0].median_ps, true );
+   CHECK_EQUAL( results[0].median_ps <= results[0].p99_ps, true );
+   CHECK_EQUAL( results[0].intrinsic_calls.size(), 1 );
+   CHECK_EQUAL( results[0].intrinsic_calls[0].first, "current_receiver" );
+   CHECK_EQUAL( results[0].intrinsic_calls[0].second, 1000 );
+
+   // a failing benchmark is reported and fails the run
+   char* failing_argv[] = { (char*)"bench_tests" };
+   bench_runner failing(1, failing_argv);
+   EOSIO_BENCH(failing, asserting_bench);
+   CHECK_EQUAL( failing.results().size(), 0 );
+   CHECK_EQUAL( failing.finish(), 1 );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(baseline_test)
+   bench_result fast;
+   fast.name       = "fast";
+   fast.iterations = 1000;
+   fast.samples    = 5;
+   fast.median_ps  = 12345;
+   bench_result slow = fast;
+   slow.name      = "slow";
+   slow.median_ps = 2000000;
+   slow.intrinsic_calls.emplace_back("db_find_i64", 2000);
+
+   const std::string json = bench_runner::to_json({fast, slow});
+   CHECK_EQUAL( json.find("\"median_ns\": 12.345") != std::string::npos, true );
+   CHECK_EQUAL( json.find("\"db_find_i64\": 2.000") != std::string::npos, true );
+
+   auto baseline = bench_runner::parse_baseline(json);
+   CHECK_EQUAL( baseline.size(), 2 );
+   CHECK_EQUAL( baseline["fast"], 12345 );
+   CHECK_EQUAL( baseline["slow"], 2000000 );
+   CHECK_EQUAL( bench_runner::regressions({fast, slow}, baseline, 10).empty(), true );
+
+   // 10% slower is within the threshold, 11% is not
+   fast.median_ps = 13579;
+   slow.median_ps = 2220000;
+   auto regressed = bench_runner::regressions({fast, slow}, baseline, 10);
+   CHECK_EQUAL( regressed.size(), 1 );
+   CHECK_EQUAL( regressed[0], "slow" );
+
+   // benchmarks without a baseline are not compared
+   baseline.erase("slow");
+   CHECK_EQUAL( bench_runner::regressions({fast, slow}, baseline, 10).empty(), true );
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(bench_test);
+   EOSIO_TEST(baseline_test);
+   return has_failed();
+}
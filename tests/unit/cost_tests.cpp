@@ -0,0 +1,82 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/asset.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace eosio;
+
+/**
+ * Exercises multi_index, datastream, asset and the dispatcher for the cost suite in cost_tests.json
+ *
+ * eosio-run records what every action of the suite costs on the interpreter and compares it against
+ * cost_tests.baseline.json, so a change to eosiolib that makes contracts more expensive fails the tests.
+ */
+CONTRACT cost_tests : public contract {
+   public:
+      using contract::contract;
+
+      TABLE account {
+         name     owner;
+         uint64_t balance;
+
+         uint64_t primary_key()const { return owner.value; }
+         uint64_t by_balance()const { return balance; }
+      };
+
+      typedef eosio::multi_index<"accounts"_n, account,
+                                 indexed_by<"balance"_n, const_mem_fun<account, uint64_t, &account::by_balance>>> accounts;
+
+      ACTION emplace( name owner, uint64_t balance ) {
+         accounts table(_self, _self.value);
+         table.emplace(_self, [&](auto& row) {
+               row.owner   = owner;
+               row.balance = balance;
+            });
+      }
+
+      ACTION modify( name owner, uint64_t balance ) {
+         accounts table(_self, _self.value);
+         const auto& row = table.get(owner.value, "no such account");
+         table.modify(row, same_payer, [&](auto& r) { r.balance = balance; });
+      }
+
+      ACTION erase( name owner ) {
+         accounts table(_self, _self.value);
+         table.erase(table.get(owner.value, "no such account"));
+      }
+
+      ACTION bysecondary( uint64_t lower ) {
+         accounts table(_self, _self.value);
+         auto by_balance = table.get_index<"balance"_n>();
+         uint64_t total = 0;
+         for (auto itr = by_balance.lower_bound(lower); itr != by_balance.end(); ++itr)
+            total += itr->balance;
+         print(total);
+      }
+
+      ACTION roundtrip( std::vector<uint64_t> values, std::string memo ) {
+         const auto packed = pack(std::make_tuple(values, memo));
+         const auto unpacked = unpack<std::tuple<std::vector<uint64_t>, std::string>>(packed);
+         eosio_assert(std::get<0>(unpacked) == values && std::get<1>(unpacked) == memo, "roundtrip changed the data");
+         print(uint64_t(packed.size()));
+      }
+
+      ACTION assetmath( asset quantity, uint32_t times ) {
+         asset total(0, quantity.symbol);
+         for (uint32_t i = 0; i < times; i++)
+            total += quantity * 2 - quantity;
+         eosio_assert(total == quantity * times, "asset math is off");
+         total.print();
+      }
+
+      ACTION transfer( name from, name to, asset quantity, std::string memo ) {
+         require_auth(from);
+         eosio_assert(quantity.is_valid() && quantity.amount > 0, "invalid quantity");
+         eosio_assert(memo.size() <= 256, "memo has more than 256 bytes");
+         require_recipient(from);
+         require_recipient(to);
+      }
+};
+
+EOSIO_DISPATCH( cost_tests, (emplace)(modify)(erase)(bysecondary)(roundtrip)(assetmath)(transfer) )
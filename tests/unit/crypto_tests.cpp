@@ -0,0 +1,162 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/crypto.hpp>
+#include <eosiolib/merkle.hpp>
+#include <eosio/native/tester.hpp>
+
+#include <cstring>
+#include <string>
+
+using namespace eosio::native;
+
+static std::string hashed_input;
+
+EOSIO_TEST_BEGIN(write_as_bytes_test)
+   silence_output(true);
+   eosio::checksum160 c160 = eosio::checksum160::make_from_word_sequence<uint32_t>(uint32_t(0x01020304), uint32_t(0x05060708), uint32_t(0x090a0b0c),
+                                                                                  uint32_t(0x0d0e0f10), uint32_t(0x11121314));
+   uint8_t out160[20];
+   c160.write_as_bytes( out160 );
+   auto arr160 = c160.extract_as_byte_array();
+   CHECK_EQUAL( memcmp(out160, arr160.data(), sizeof(out160)), 0 );
+   CHECK_EQUAL( out160[0], 0x01 );
+   CHECK_EQUAL( out160[19], 0x14 );
+
+   eosio::checksum256 c256 = eosio::checksum256::make_from_word_sequence<uint64_t>(uint64_t(0x0001020304050607ull), uint64_t(0x08090a0b0c0d0e0full),
+                                                                                   uint64_t(0x1011121314151617ull), uint64_t(0x18191a1b1c1d1e1full));
+   uint8_t out256[32];
+   c256.write_as_bytes( out256 );
+   for( uint8_t i = 0; i < 32; ++i )
+      CHECK_EQUAL( out256[i], i );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(hash_packed_test)
+   silence_output(true);
+   intrinsics::set_intrinsic<intrinsics::sha256>([](const char* data, uint32_t length, capi_checksum256* hash) {
+         hashed_input.assign( data, length );
+         for( uint8_t i = 0; i < 32; ++i )
+            hash->hash[i] = i;
+         });
+
+   auto value = std::make_tuple( eosio::name{"alice"}, uint64_t(42), std::string("memo") );
+   auto digest = eosio::hash_packed<eosio::hash_algo::sha256>( value );
+   auto packed = eosio::pack( value );
+   CHECK_EQUAL( hashed_input == std::string(packed.begin(), packed.end()), true );
+   CHECK_EQUAL( digest.extract_as_byte_array()[31], 31 );
+
+   // larger than the stack buffer, goes through the reusable scratch buffer
+   std::vector<uint64_t> big(100, 7);
+   eosio::hash_packed<eosio::hash_algo::sha256>( big );
+   packed = eosio::pack( big );
+   CHECK_EQUAL( hashed_input == std::string(packed.begin(), packed.end()), true );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(assert_sha256_test)
+   silence_output(true);
+   intrinsics::set_intrinsic<intrinsics::assert_sha256>([](const char* data, uint32_t length, const capi_checksum256* hash) {
+         hashed_input.assign( reinterpret_cast<const char*>(hash->hash), sizeof(hash->hash) );
+         });
+
+   eosio::checksum256 expected = eosio::checksum256::make_from_word_sequence<uint64_t>(uint64_t(1), uint64_t(2), uint64_t(3), uint64_t(4));
+   eosio::assert_sha256( "", 0, expected );
+   auto arr = expected.extract_as_byte_array();
+   CHECK_EQUAL( hashed_input == std::string(arr.begin(), arr.end()), true );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(merkle_test)
+   silence_output(true);
+   // not a real sha256, only needs to be deterministic and order sensitive
+   intrinsics::set_intrinsic<intrinsics::sha256>([](const char* data, uint32_t length, capi_checksum256* hash) {
+         uint64_t h = 0xcbf29ce484222325ull;
+         for( uint32_t i = 0; i < length; ++i )
+            h = (h ^ uint8_t(data[i])) * 0x100000001b3ull;
+         for( uint8_t i = 0; i < 32; ++i ) {
+            h = (h ^ i) * 0x100000001b3ull;
+            hash->hash[i] = uint8_t(h >> 56);
+         }
+         });
+
+   std::vector<eosio::checksum256> leaves;
+   for( uint64_t i = 0; i < 13; ++i )
+      leaves.push_back( eosio::checksum256::make_from_word_sequence<uint64_t>(i + 1) );
+
+   // reference tree built level by level
+   std::vector<std::vector<eosio::checksum256>> levels(1);
+   for( const auto& leaf : leaves )
+      levels[0].push_back( eosio::merkle_hash_leaf(leaf) );
+   while( levels.back().size() > 1 ) {
+      const auto& below = levels.back();
+      std::vector<eosio::checksum256> above;
+      for( size_t i = 0; i < below.size(); i += 2 )
+         above.push_back( i + 1 < below.size() ? eosio::merkle_hash_pair(below[i], below[i+1]) : below[i] );
+      levels.push_back( above );
+   }
+
+   eosio::incremental_merkle acc;
+   CHECK_EQUAL( acc.root() == eosio::checksum256(), true );
+   for( const auto& leaf : leaves )
+      acc.append( leaf );
+   CHECK_EQUAL( acc.leaf_count, 13 );
+   CHECK_EQUAL( acc.frontier.size(), 3 );
+   CHECK_EQUAL( acc.root() == levels.back()[0], true );
+
+   for( uint64_t index = 0; index < leaves.size(); ++index ) {
+      std::vector<eosio::checksum256> path;
+      uint64_t pos = index;
+      for( size_t l = 0; l + 1 < levels.size(); ++l, pos /= 2 ) {
+         const uint64_t sibling = pos ^ 1;
+         if( sibling < levels[l].size() )
+            path.push_back( levels[l][sibling] );
+      }
+      CHECK_EQUAL( eosio::verify_merkle_proof(leaves[index], index, leaves.size(), path, acc.root()), true );
+      CHECK_EQUAL( eosio::verify_merkle_proof(leaves[index], index ^ 1, leaves.size(), path, acc.root()), false );
+   }
+
+   // an interior node does not pass as a leaf of the tree one level up, with the rest of its path as the proof
+   std::vector<eosio::checksum256> interior_path;
+   uint64_t pos = 0;
+   for( size_t l = 1; l + 1 < levels.size(); ++l, pos /= 2 ) {
+      if( (pos ^ 1) < levels[l].size() )
+         interior_path.push_back( levels[l][pos ^ 1] );
+   }
+   CHECK_EQUAL( eosio::verify_merkle_proof(levels[1][0], 0, levels[1].size(), interior_path, acc.root()), false );
+
+   CHECK_ASSERT( "invalid merkle proof", ([&]() {
+      eosio::assert_merkle_proof( leaves[0], 0, leaves.size(), {}, acc.root() );
+   }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(fixed_bytes_compare_test)
+   silence_output(true);
+   std::array<uint8_t, 20> low{}, high{};
+   low[19]  = 1;
+   high[0]  = 1;
+   eosio::checksum160 a(low), b(high);
+   CHECK_EQUAL( a < b, true );
+   CHECK_EQUAL( b > a, true );
+   CHECK_EQUAL( a <= a, true );
+   CHECK_EQUAL( a != b, true );
+   CHECK_EQUAL( a == eosio::checksum160(low), true );
+   CHECK_EQUAL( a.fingerprint() == eosio::checksum160(low).fingerprint(), true );
+   CHECK_EQUAL( a.fingerprint() != b.fingerprint(), true );
+
+   // a short byte array leaves the remaining bytes zero
+   std::array<uint8_t, 4> prefix{ {1, 2, 3, 4} };
+   auto bytes = eosio::checksum256(prefix).extract_as_byte_array();
+   CHECK_EQUAL( bytes[3], 4 );
+   CHECK_EQUAL( bytes[4], 0 );
+   CHECK_EQUAL( bytes[31], 0 );
+   silence_output(false);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   EOSIO_TEST(write_as_bytes_test);
+   EOSIO_TEST(fixed_bytes_compare_test);
+   EOSIO_TEST(hash_packed_test);
+   EOSIO_TEST(assert_sha256_test);
+   EOSIO_TEST(merkle_test);
+   return has_failed();
+}
@@ -0,0 +1,221 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/multi_index.hpp>
+#include <eosio/native/tester.hpp>
+#include <eosio/native/database.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+struct [[eosio::table]] account_row {
+   uint64_t id;
+   uint64_t owner;
+   uint64_t balance;
+   uint64_t primary_key()const { return id; }
+   uint64_t by_owner()const { return owner; }
+   EOSLIB_SERIALIZE( account_row, (id)(owner)(balance) )
+};
+
+using accounts_table = multi_index<"accounts"_n, account_row,
+      indexed_by<"byowner"_n, const_mem_fun<account_row, uint64_t, &account_row::by_owner>>>;
+
+EOSIO_TEST_BEGIN(primary_index_test)
+   database::get().clear();
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return "test"_n.value; });
+
+   // no table yet
+   CHECK_EQUAL( db_end_i64("test"_n.value, 0, "accounts"_n.value), -1 );
+
+   accounts_table accounts("test"_n, 0);
+   for (uint64_t i = 1; i <= 5; i++)
+      accounts.emplace("test"_n, [&](auto& r) { r.id = i * 10; r.owner = 6 - i; r.balance = i; });
+
+   CHECK_EQUAL( accounts.get(30).balance, 3 );
+   CHECK_EQUAL( accounts.find(35) == accounts.end(), true );
+   CHECK_EQUAL( accounts.lower_bound(35)->id, 40 );
+   CHECK_EQUAL( accounts.upper_bound(50) == accounts.end(), true );
+   CHECK_EQUAL( (--accounts.end())->id, 50 );
+
+   accounts.modify(accounts.get(20), same_payer, [](auto& r) { r.balance = 99; });
+   CHECK_EQUAL( accounts.get(20).balance, 99 );
+
+   accounts.erase(accounts.get(10));
+   CHECK_EQUAL( accounts.begin()->id, 20 );
+
+   uint64_t total = 0;
+   for (const auto& r : accounts)
+      total += r.id;
+   CHECK_EQUAL( total, 140 );
+
+   // rows live in the database, not in the multi_index object
+   accounts_table again("test"_n, 0);
+   CHECK_EQUAL( again.get(40).balance, 4 );
+
+   // raw iterator semantics: the end iterator can be decremented but not incremented
+   uint64_t pk = 0;
+   int32_t end_itr = db_end_i64("test"_n.value, 0, "accounts"_n.value);
+   CHECK_EQUAL( end_itr < -1, true );
+   CHECK_EQUAL( db_next_i64(end_itr, &pk), -1 );
+   CHECK_EQUAL( db_previous_i64(end_itr, &pk) >= 0, true );
+   CHECK_EQUAL( pk, 50 );
+
+   REQUIRE_ASSERT( "unable to find key", [&]() { accounts.get(10); } );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(secondary_index_test)
+   database::get().clear();
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return "test"_n.value; });
+
+   accounts_table accounts("test"_n, 0);
+   for (uint64_t i = 1; i <= 5; i++)
+      accounts.emplace("test"_n, [&](auto& r) { r.id = i; r.owner = 100 - i * 10; r.balance = 0; });
+
+   auto by_owner = accounts.get_index<"byowner"_n>();
+   CHECK_EQUAL( by_owner.begin()->id, 5 );
+   CHECK_EQUAL( (--by_owner.end())->id, 1 );
+   CHECK_EQUAL( by_owner.find(70)->id, 3 );
+   CHECK_EQUAL( by_owner.find(75) == by_owner.end(), true );
+   CHECK_EQUAL( by_owner.lower_bound(75)->id, 2 );
+   CHECK_EQUAL( by_owner.upper_bound(80)->id, 1 );
+
+   by_owner.modify(by_owner.find(70), same_payer, [](auto& r) { r.owner = 1; });
+   CHECK_EQUAL( by_owner.begin()->id, 3 );
+
+   uint64_t expected[] = {3, 5, 4, 2, 1};
+   size_t i = 0;
+   for (const auto& r : by_owner)
+      CHECK_EQUAL( r.id, expected[i++] );
+   CHECK_EQUAL( i, 5 );
+
+   by_owner.erase(by_owner.begin());
+   CHECK_EQUAL( accounts.find(3) == accounts.end(), true );
+   CHECK_EQUAL( by_owner.begin()->id, 5 );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(access_violation_test)
+   database::get().clear();
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return "test"_n.value; });
+
+   uint64_t value = 7;
+   db_store_i64(0, "accounts"_n.value, "test"_n.value, 1, &value, sizeof(value));
+
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return "other"_n.value; });
+   int32_t itr = db_find_i64("test"_n.value, 0, "accounts"_n.value, 1);
+   CHECK_EQUAL( db_get_i64(itr, nullptr, 0), sizeof(value) );
+   REQUIRE_ASSERT( "db access violation", [&]() { db_remove_i64(itr); } );
+   REQUIRE_ASSERT( "must specify a valid account to pay for new record", [&]() {
+         db_store_i64(0, "accounts"_n.value, 0, 2, &value, sizeof(value));
+      });
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(ram_usage_test)
+   database::get().clear();
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return "test"_n.value; });
+   constexpr int64_t row_size     = 3 * sizeof(uint64_t);
+   constexpr int64_t primary_row  = ram_ledger::key_value_overhead + row_size;
+   constexpr int64_t secondary_row = ram_ledger::secondary_overhead<uint64_t>;
+   CHECK_EQUAL( primary_row, 132 );
+   CHECK_EQUAL( secondary_row, 128 );
+
+   // the first row also pays for the primary table and the byowner index table
+   accounts_table accounts("test"_n, 0);
+   auto before = database::get().ram_usage();
+   accounts.emplace("alice"_n, [](auto& r) { r.id = 1; r.owner = 1; r.balance = 10; });
+   auto diff = database::ram_diff(before, database::get().ram_usage());
+   CHECK_EQUAL( diff.size(), 1 );
+   CHECK_EQUAL( diff["alice"_n.value], 2 * ram_ledger::table_overhead + primary_row + secondary_row );
+
+   before = database::get().ram_usage();
+   accounts.emplace("bob"_n, [](auto& r) { r.id = 2; r.owner = 2; r.balance = 20; });
+   diff = database::ram_diff(before, database::get().ram_usage());
+   CHECK_EQUAL( diff["bob"_n.value], primary_row + secondary_row );
+   CHECK_EQUAL( diff.count("alice"_n.value), 0 );
+
+   // changing the payer moves the row, multi_index leaves the index entry alone while its key is unchanged
+   before = database::get().ram_usage();
+   accounts.modify(accounts.get(1), "bob"_n, [](auto& r) { r.balance = 11; });
+   diff = database::ram_diff(before, database::get().ram_usage());
+   CHECK_EQUAL( diff["alice"_n.value], -primary_row );
+   CHECK_EQUAL( diff["bob"_n.value], primary_row );
+
+   before = database::get().ram_usage();
+   accounts.modify(accounts.get(1), "bob"_n, [](auto& r) { r.owner = 3; });
+   diff = database::ram_diff(before, database::get().ram_usage());
+   CHECK_EQUAL( diff["alice"_n.value], -secondary_row );
+   CHECK_EQUAL( diff["bob"_n.value], secondary_row );
+   CHECK_EQUAL( database::get().ram_usage("alice"_n.value), 2 * ram_ledger::table_overhead );
+
+   // the tables are refunded to alice together with the last row
+   accounts.erase(accounts.get(1));
+   accounts.erase(accounts.get(2));
+   CHECK_EQUAL( database::get().ram_usage().empty(), true );
+
+   // copies, as used by the simulator to roll back failed transactions, carry the counters along
+   uint64_t value = 7;
+   db_store_i64(0, "raw"_n.value, "carol"_n.value, 1, &value, sizeof(value));
+   CHECK_EQUAL( database::get().ram_usage("carol"_n.value), ram_ledger::table_overhead + ram_ledger::key_value_overhead + 8 );
+   database copy = database::get();
+   CHECK_EQUAL( copy.ram_usage() == database::get().ram_usage(), true );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(snapshot_test)
+   database::get().clear();
+   intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return "test"_n.value; });
+   {
+      accounts_table accounts("test"_n, 0);
+      for (uint64_t i = 1; i <= 3; i++)
+         accounts.emplace("test"_n, [&](auto& r) { r.id = i; r.owner = i; r.balance = 100; });
+   }
+   const auto fixture_ram = database::get().ram_usage();
+
+   // multi_index caches iterators, each step after a restore works on a fresh table object
+   const auto fixture = database::get().snapshot();
+   for (int round = 0; round < 2; round++) {
+      accounts_table accounts("test"_n, 0);
+      accounts.modify(accounts.get(1), "alice"_n, [](auto& r) { r.balance = 0; r.owner = 9; });
+      accounts.erase(accounts.get(2));
+      accounts.emplace("bob"_n, [](auto& r) { r.id = 4; r.owner = 4; r.balance = 1; });
+
+      // nested snapshots only undo what happened after them
+      const auto inner = database::get().snapshot();
+      accounts.erase(accounts.get(3));
+      database::get().restore(inner);
+      database::get().release(inner);
+      accounts_table after_inner("test"_n, 0);
+      CHECK_EQUAL( after_inner.get(3).balance, 100 );
+      CHECK_EQUAL( after_inner.find(2) == after_inner.end(), true );
+
+      // the fixture can be restored any number of times
+      database::get().restore(fixture);
+      accounts_table restored("test"_n, 0);
+      CHECK_EQUAL( restored.get(1).balance, 100 );
+      CHECK_EQUAL( restored.get(2).owner, 2 );
+      CHECK_EQUAL( restored.find(4) == restored.end(), true );
+      auto by_owner = restored.get_index<"byowner"_n>();
+      CHECK_EQUAL( by_owner.find(9) == by_owner.end(), true );
+      CHECK_EQUAL( by_owner.find(1)->id, 1 );
+      CHECK_EQUAL( database::get().ram_usage() == fixture_ram, true );
+   }
+
+   // a table emptied and dropped comes back on restore
+   {
+      accounts_table accounts("test"_n, 0);
+      for (uint64_t i = 1; i <= 3; i++)
+         accounts.erase(accounts.get(i));
+   }
+   CHECK_EQUAL( db_end_i64("test"_n.value, 0, "accounts"_n.value), -1 );
+   database::get().restore(fixture);
+   CHECK_EQUAL( accounts_table("test"_n, 0).get(3).id, 3 );
+
+   database::get().release(fixture);
+   REQUIRE_ASSERT( "unknown database snapshot", []() { database::get().restore(0); } );
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(primary_index_test);
+   EOSIO_TEST(secondary_index_test);
+   EOSIO_TEST(access_violation_test);
+   EOSIO_TEST(ram_usage_test);
+   EOSIO_TEST(snapshot_test);
+   return has_failed();
+}
@@ -0,0 +1,95 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/icp.hpp>
+#include <eosio/native/tester.hpp>
+
+#include <limits>
+
+using namespace eosio::native;
+
+EOSIO_TEST_BEGIN(seq_range_set_test)
+   silence_output(true);
+   eosio::seq_range_set set;
+   set.insert(5);
+   set.insert(7);
+   set.insert(10, 12);
+   CHECK_EQUAL( set.ranges.size(), 3 );
+   CHECK_EQUAL( set.contains(5), true );
+   CHECK_EQUAL( set.contains(6), false );
+   CHECK_EQUAL( set.contains(11), true );
+   CHECK_EQUAL( set.contains(13), false );
+
+   // filling the gap merges the neighbours, adjacent ranges are joined
+   set.insert(6);
+   set.insert(8, 9);
+   CHECK_EQUAL( set.ranges.size(), 1 );
+   CHECK_EQUAL( set.ranges[0].first, 5 );
+   CHECK_EQUAL( set.ranges[0].last, 12 );
+
+   set.insert(20, 30);
+   set.insert(1, 25);
+   CHECK_EQUAL( set.ranges.size(), 1 );
+   CHECK_EQUAL( set.ranges[0].last, 30 );
+
+   eosio::seq_range_set acks;
+   acks.insert(3, 4);
+   acks.insert(8);
+   CHECK_EQUAL( acks.pop_contiguous(1), 0 );
+   CHECK_EQUAL( acks.ranges.size(), 2 );
+   acks.insert(1, 2);
+   CHECK_EQUAL( acks.pop_contiguous(1), 4 );
+   CHECK_EQUAL( acks.ranges.size(), 1 );
+   CHECK_EQUAL( acks.pop_contiguous(9), 8 );
+   CHECK_EQUAL( acks.empty(), true );
+
+   CHECK_ASSERT( "invalid sequence range", ([&]() { acks.insert(4, 3); }) );
+
+   // insert reports whether the set changed, finalise_receipts skips the write otherwise
+   CHECK_EQUAL( acks.insert(20, 22), true );
+   CHECK_EQUAL( acks.insert(21), false );
+   CHECK_EQUAL( acks.insert(22, 23), true );
+
+   // a range ending at the largest sequence number does not wrap around to 0
+   const uint64_t max_seq = std::numeric_limits<uint64_t>::max();
+   eosio::seq_range_set edges;
+   edges.insert(max_seq);
+   edges.insert(0);
+   CHECK_EQUAL( edges.ranges.size(), 2 );
+   edges.insert(max_seq - 1);
+   CHECK_EQUAL( edges.ranges.size(), 2 );
+   CHECK_EQUAL( edges.ranges[1].first, max_seq - 1 );
+   edges.insert(1, max_seq - 2);
+   CHECK_EQUAL( edges.ranges.size(), 1 );
+
+   // sets unpacked from action data are not trusted to be well formed
+   eosio::seq_range_set untrusted;
+   untrusted.ranges = { {1, 3}, {5, 9} };
+   untrusted.validate();
+   untrusted.ranges = { {5, 9}, {1, 3} };
+   CHECK_ASSERT( "sequence ranges are not sorted and disjoint", ([&]() { untrusted.validate(); }) );
+   untrusted.ranges = { {1, 5}, {5, 9} };
+   CHECK_ASSERT( "sequence ranges are not sorted and disjoint", ([&]() { untrusted.validate(); }) );
+   untrusted.ranges = { {1, 3}, {9, 5} };
+   CHECK_ASSERT( "invalid sequence range", ([&]() { untrusted.validate(); }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(packet_batch_test)
+   silence_output(true);
+   eosio::icp_packet_batch batch;
+   batch.first_seq = 10;
+   for( uint64_t seq = 10; seq < 14; ++seq )
+      batch.packets.push_back( eosio::icp_sendaction{seq, {}, 0, {}} );
+   batch.validate();
+   CHECK_EQUAL( batch.last_seq(), 13 );
+
+   batch.packets[2].seq = 15;
+   CHECK_ASSERT( "packet batch sequence is not contiguous", ([&]() { batch.validate(); }) );
+   CHECK_ASSERT( "empty packet batch", ([]() { eosio::icp_packet_batch{}.validate(); }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   EOSIO_TEST(seq_range_set_test);
+   EOSIO_TEST(packet_batch_test);
+   return has_failed();
+}
@@ -0,0 +1,69 @@
+#include <eosiolib/eosio.hpp>
+#include <eosio/native/tester.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+EOSIO_TEST_BEGIN(override_test)
+   REQUIRE_ASSERT( "unsupported intrinsic", []() { current_receiver(); } );
+   {
+      intrinsic_override<intrinsics::current_receiver> receiver([]() { return "outer"_n.value; });
+      CHECK_EQUAL( current_receiver(), "outer"_n.value );
+      {
+         // captures too large to live in the slot go to the heap
+         std::string suffix = "inner";
+         intrinsic_override<intrinsics::current_receiver> inner([suffix]() { return eosio::name(suffix).value; });
+         CHECK_EQUAL( current_receiver(), "inner"_n.value );
+      }
+      CHECK_EQUAL( current_receiver(), "outer"_n.value );
+   }
+   REQUIRE_ASSERT( "unsupported intrinsic", []() { current_receiver(); } );
+
+   // set_intrinsic keeps its effect past the scope it is called in, the guard puts the default back before
+   // `calls` goes away
+   uint64_t calls = 0;
+   {
+      intrinsic_override<intrinsics::is_account> restore([](capi_name) { return false; });
+      {
+         intrinsics::set_intrinsic<intrinsics::is_account>([&calls](capi_name account) { calls++; return account == "alice"_n.value; });
+      }
+      auto saved = intrinsics::get_intrinsic<intrinsics::is_account>();
+      CHECK_EQUAL( is_account("alice"_n), true );
+      CHECK_EQUAL( is_account("bob"_n), false );
+      CHECK_EQUAL( saved("alice"_n.value), true );
+      CHECK_EQUAL( calls, 3 );
+   }
+   REQUIRE_ASSERT( "unsupported intrinsic", []() { is_account("alice"_n); } );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(call_count_test)
+   intrinsic_override<intrinsics::current_receiver> receiver([]() { return "test"_n.value; });
+   intrinsic_override<intrinsics::has_auth> auth([](capi_name) { return true; });
+
+   current_receiver();
+   CHECK_EQUAL( intrinsics::call_count<intrinsics::current_receiver>(), 0 );
+
+   intrinsics::reset_call_counts();
+   intrinsics::count_calls(true);
+   for (int i = 0; i < 3; i++)
+      current_receiver();
+   has_auth("test"_n.value);
+   intrinsics::count_calls(false);
+   current_receiver();
+
+   CHECK_EQUAL( intrinsics::call_count<intrinsics::current_receiver>(), 3 );
+   CHECK_EQUAL( intrinsics::call_count<intrinsics::has_auth>(), 1 );
+   auto counts = intrinsics::call_counts();
+   CHECK_EQUAL( counts.size(), 2 );
+   CHECK_EQUAL( std::string(counts[0].first) == "has_auth" || std::string(counts[1].first) == "has_auth", true );
+
+   intrinsics::reset_call_counts();
+   CHECK_EQUAL( intrinsics::call_counts().empty(), true );
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(override_test);
+   EOSIO_TEST(call_count_test);
+   return has_failed();
+}
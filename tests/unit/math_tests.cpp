@@ -0,0 +1,135 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/asset.hpp>
+#include <eosiolib/math.hpp>
+#include <eosiolib/fixedpoint.hpp>
+#include <eosiolib/fixed_math.hpp>
+#include <eosio/native/tester.hpp>
+
+using namespace eosio::native;
+using eosio::rounding;
+
+EOSIO_TEST_BEGIN(mul_div_test)
+   silence_output(true);
+   CHECK_EQUAL( eosio::mul_div(uint64_t(7), uint64_t(3), uint64_t(2)), 10 );
+   CHECK_EQUAL( eosio::mul_div(uint64_t(7), uint64_t(3), uint64_t(2), rounding::down), 10 );
+   CHECK_EQUAL( eosio::mul_div(uint64_t(7), uint64_t(3), uint64_t(2), rounding::up), 11 );
+   CHECK_EQUAL( eosio::mul_div(uint64_t(7), uint64_t(3), uint64_t(2), rounding::nearest), 11 );
+   CHECK_EQUAL( eosio::mul_div(uint64_t(7), uint64_t(2), uint64_t(3), rounding::nearest), 5 );
+
+   // intermediate product does not fit in 64 bits
+   CHECK_EQUAL( eosio::mul_div(uint64_t(1ull << 62), uint64_t(1ull << 62), uint64_t(1ull << 61)), (1ull << 63) );
+   CHECK_EQUAL( eosio::mul_div(std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max()),
+                std::numeric_limits<uint64_t>::max() );
+   CHECK_EQUAL( eosio::mul_div(uint64_t(10000000000000000000ull), uint64_t(3), uint64_t(7)), 4285714285714285714ull );
+
+   // signed rounding follows the sign of the exact quotient
+   CHECK_EQUAL( eosio::mul_div(int64_t(-7), int64_t(3), int64_t(2)), -10 );
+   CHECK_EQUAL( eosio::mul_div(int64_t(-7), int64_t(3), int64_t(2), rounding::down), -11 );
+   CHECK_EQUAL( eosio::mul_div(int64_t(-7), int64_t(3), int64_t(2), rounding::up), -10 );
+   CHECK_EQUAL( eosio::mul_div(int64_t(7), int64_t(3), int64_t(-2), rounding::nearest), -11 );
+   CHECK_EQUAL( eosio::mul_div(std::numeric_limits<int64_t>::min(), int64_t(1), int64_t(1)), std::numeric_limits<int64_t>::min() );
+
+   CHECK_ASSERT( "divide by zero", ([]() { eosio::mul_div(uint64_t(1), uint64_t(1), uint64_t(0)); }) );
+   CHECK_ASSERT( "mul_div overflow", ([]() { eosio::mul_div(uint64_t(1ull << 63), uint64_t(4), uint64_t(2)); }) );
+   CHECK_ASSERT( "mul_div overflow", ([]() { eosio::mul_div(std::numeric_limits<int64_t>::min(), int64_t(-1), int64_t(1)); }) );
+   CHECK_ASSERT( "mul_div overflow", ([]() { eosio::mul_div(uint32_t(1u << 31), uint32_t(4), uint32_t(2)); }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(asset_mul_div_test)
+   silence_output(true);
+   const eosio::symbol eos{"EOS", 4};
+   const eosio::symbol sys{"SYS", 4};
+
+   CHECK_EQUAL( eosio::asset(10000, eos).mul_div(30, 10000).amount, 30 );
+   CHECK_EQUAL( eosio::asset(10001, eos).mul_div(30, 10000).amount, 30 );
+   CHECK_EQUAL( eosio::asset(10001, eos).mul_div(30, 10000, rounding::up).amount, 31 );
+   CHECK_EQUAL( eosio::asset(eosio::asset::max_amount, eos).mul_div(eosio::asset::max_amount, eosio::asset::max_amount).amount,
+                eosio::asset::max_amount );
+
+   auto out = mul_div( eosio::asset(50000, eos), eosio::asset(3000000, sys), eosio::asset(1000000, eos) );
+   CHECK_EQUAL( out.amount, 150000 );
+   CHECK_EQUAL( out.symbol == sys, true );
+
+   CHECK_ASSERT( "mul_div result out of range", ([&]() { eosio::asset(eosio::asset::max_amount, eos).mul_div(2, 1); }) );
+   CHECK_ASSERT( "attempt to divide assets with different symbols",
+                 ([&]() { mul_div( eosio::asset(1, eos), eosio::asset(1, sys), eosio::asset(1, sys) ); }) );
+
+   eosio::asset a(eosio::asset::max_amount, eos);
+   CHECK_ASSERT( "multiplication overflow", ([&]() { a *= 2; }) );
+   CHECK_ASSERT( "multiplication underflow", ([&]() { a *= -2; }) );
+   a = eosio::asset(-3, eos);
+   a *= 7;
+   CHECK_EQUAL( a.amount, -21 );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(fixed_point_test)
+   silence_output(true);
+   using eosio::fixed_point64;
+   using eosio::fixed_point128;
+   using eosio::fixed_point256;
+
+   CHECK_EQUAL( (fixed_point64<0>(-6) * fixed_point64<0>(7)).val, -42 );
+   CHECK_EQUAL( (fixed_point64<0>(1) / fixed_point64<0>(4)).val, (int128_t(1) << 62) );
+   CHECK_EQUAL( (fixed_point64<0>(-1) / fixed_point64<0>(4)).val, -(int128_t(1) << 62) );
+   CHECK_EQUAL( (fixed_point64<0>(std::numeric_limits<int64_t>::max()) / fixed_point64<0>(1)).int_part(),
+                std::numeric_limits<int64_t>::max() );
+
+   // 128 x 128 products widen into fixed_point256 without truncation
+   const int128_t big = int128_t(1) << 100;
+   auto p = fixed_point128<0>(big) * fixed_point128<0>(-big);
+   CHECK_EQUAL( (p / fixed_point256<0>(big)).int_part(), -big );
+   CHECK_EQUAL( (fixed_point128<0>(3) / fixed_point128<0>(2)).int_part(), 1 );
+   CHECK_EQUAL( (fixed_point256<64>(fixed_point64<0>(3)) / fixed_point256<0>(2)).frac_part(), uint128_t(1) << 127 );
+
+   auto sum = fixed_point256<10>(int128_t(5)) + fixed_point256<12>(int128_t(-7));
+   CHECK_EQUAL( sum == fixed_point256<12>(int128_t(5) * 4 - 7), true );
+   CHECK_EQUAL( fixed_point256<0>(int128_t(-1)) < fixed_point256<0>(int128_t(0)), true );
+   CHECK_EQUAL( fixed_point256<0>(fixed_point64<8>(int64_t(-256))).int_part(), -1 );
+
+   CHECK_ASSERT( "divide by zero", ([]() { fixed_point256<0>(int128_t(1)) / fixed_point256<0>(int128_t(0)); }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(fixed_math_test)
+   using eosio::fixed_point128;
+   silence_output(true);
+   typedef fixed_point128<64> fp;
+   const int128_t one = int128_t(1) << 64;
+   auto near = []( int128_t a, int128_t b ) { return (a > b ? a - b : b - a) <= 4; };
+
+   CHECK_EQUAL( eosio::isqrt(uint64_t(99)), 9 );
+   CHECK_EQUAL( eosio::isqrt(std::numeric_limits<uint64_t>::max()), 0xFFFFFFFFull );
+   CHECK_EQUAL( eosio::isqrt(std::numeric_limits<uint128_t>::max()), std::numeric_limits<uint64_t>::max() );
+   CHECK_EQUAL( eosio::fixed_sqrt(fp(4 * one)).val, 2 * one );
+   CHECK_EQUAL( eosio::fixed_sqrt(fp(2 * one)).val, (one | 0x6a09e667f3bcc908ull) );
+
+   CHECK_EQUAL( eosio::fixed_exp2(fp(0)).val, one );
+   CHECK_EQUAL( eosio::fixed_exp2(fp(10 * one)).val, one << 10 );
+   CHECK_EQUAL( eosio::fixed_exp2(fp(-one)).val, one / 2 );
+   CHECK_EQUAL( near(eosio::fixed_exp2(fp(one / 2)).val, eosio::fixed_sqrt(fp(2 * one)).val), true );
+
+   CHECK_EQUAL( eosio::fixed_log2(fp(one)).val, 0 );
+   CHECK_EQUAL( eosio::fixed_log2(fp(8 * one)).val, 3 * one );
+   CHECK_EQUAL( eosio::fixed_log2(fp(one / 4)).val, -2 * one );
+   CHECK_EQUAL( near(eosio::fixed_ln(eosio::fixed_exp(fp(one))).val, one), true );
+
+   CHECK_EQUAL( eosio::fixed_pow(fp(4 * one), 1, 2).val, 2 * one );
+   CHECK_EQUAL( eosio::fixed_pow(fp(2 * one), fp(10 * one)).val, one << 10 );
+   CHECK_EQUAL( near(eosio::fixed_pow(fp(9 * one), -1, 2).val, one / 3), true );
+
+   CHECK_ASSERT( "fixed_sqrt of negative value", ([]() { eosio::fixed_sqrt(fp(-1)); }) );
+   CHECK_ASSERT( "fixed_log2 of non-positive value", ([]() { eosio::fixed_log2(fp(0)); }) );
+   CHECK_ASSERT( "fixed_exp2 overflow", ([=]() { eosio::fixed_exp2(fp(63 * one)); }) );
+   CHECK_ASSERT( "divide by zero", ([=]() { eosio::fixed_pow(fp(one), 1, 0); }) );
+   silence_output(false);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   EOSIO_TEST(mul_div_test);
+   EOSIO_TEST(asset_mul_div_test);
+   EOSIO_TEST(fixed_point_test);
+   EOSIO_TEST(fixed_math_test);
+   return has_failed();
+}
@@ -0,0 +1,154 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/crypto.hpp>
+#include <eosio/native/tester.hpp>
+#include <eosio/native/crypto.hpp>
+
+#include <string>
+
+using namespace eosio::native;
+
+static std::string to_hex( const void* data, size_t size ) {
+   static const char digits[] = "0123456789abcdef";
+   std::string hex;
+   for (size_t i = 0; i < size; i++) {
+      const uint8_t b = static_cast<const uint8_t*>(data)[i];
+      hex += digits[b >> 4];
+      hex += digits[b & 0xf];
+   }
+   return hex;
+}
+
+static std::vector<char> from_hex( const std::string& hex ) {
+   std::vector<char> bytes;
+   for (size_t i = 0; i + 1 < hex.size(); i += 2)
+      bytes.push_back(char(std::stoi(hex.substr(i, 2), nullptr, 16)));
+   return bytes;
+}
+
+static std::string sha1_hex( const std::string& s ) {
+   capi_checksum160 hash;
+   ::sha1(s.data(), s.size(), &hash);
+   return to_hex(hash.hash, sizeof(hash.hash));
+}
+
+static std::string sha256_hex( const std::string& s ) {
+   capi_checksum256 hash;
+   ::sha256(s.data(), s.size(), &hash);
+   return to_hex(hash.hash, sizeof(hash.hash));
+}
+
+static std::string sha512_hex( const std::string& s ) {
+   capi_checksum512 hash;
+   ::sha512(s.data(), s.size(), &hash);
+   return to_hex(hash.hash, sizeof(hash.hash));
+}
+
+static std::string ripemd160_hex( const std::string& s ) {
+   capi_checksum160 hash;
+   ::ripemd160(s.data(), s.size(), &hash);
+   return to_hex(hash.hash, sizeof(hash.hash));
+}
+
+static std::string counting_bytes( size_t size ) {
+   std::string s;
+   for (size_t i = 0; i < size; i++)
+      s += char(i & 0xff);
+   return s;
+}
+
+EOSIO_TEST_BEGIN(hash_test)
+   for (bool accelerated : {true, false}) {
+      crypto::enable_hardware_acceleration(accelerated);
+      CHECK_EQUAL( sha1_hex(""), "da39a3ee5e6b4b0d3255bfef95601890afd80709" );
+      CHECK_EQUAL( sha1_hex("abc"), "a9993e364706816aba3e25717850c26c9cd0d89d" );
+      CHECK_EQUAL( sha1_hex(counting_bytes(1000)), "af0b191c2de46fe13fe0908f5a6a4e90e0cafc46" );
+      CHECK_EQUAL( sha256_hex(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" );
+      CHECK_EQUAL( sha256_hex("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" );
+      CHECK_EQUAL( sha256_hex(counting_bytes(1000)), "a8af099bf2e878609558dbf69d8f88f4a31040a8cf84b549a0cfa912f12ffc3f" );
+   }
+   crypto::enable_hardware_acceleration(true);
+
+   CHECK_EQUAL( sha512_hex(""), "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+                                "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e" );
+   CHECK_EQUAL( sha512_hex("abc"), "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                                   "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f" );
+   CHECK_EQUAL( sha512_hex(counting_bytes(1000)), "6cd2eda9bf9c0597129029b0054b81e433f6b8b7b499a75eb705efd74bac1941"
+                                                  "49835b1d1a14c48be696e4d588456d512a22eae7aa1b57be2b56eae7d35e08cb" );
+   CHECK_EQUAL( ripemd160_hex(""), "9c1185a5c5e9fc54612808977ee8f548b2258d31" );
+   CHECK_EQUAL( ripemd160_hex("abc"), "8eb208f7e05d987a9b044a8e98c6b087f15a0bfc" );
+   CHECK_EQUAL( ripemd160_hex(counting_bytes(1000)), "603d0d8e28f2d5f4f1dd75118d90f209d44f23d2" );
+EOSIO_TEST_END
+
+// the SHA extensions must agree with the portable code around every padding boundary
+EOSIO_TEST_BEGIN(acceleration_test)
+   for (size_t size = 0; size < 300; size++) {
+      const std::string data = counting_bytes(size);
+      crypto::enable_hardware_acceleration(true);
+      const std::string sha1_accelerated   = sha1_hex(data);
+      const std::string sha256_accelerated = sha256_hex(data);
+      crypto::enable_hardware_acceleration(false);
+      CHECK_EQUAL( sha1_hex(data), sha1_accelerated );
+      CHECK_EQUAL( sha256_hex(data), sha256_accelerated );
+   }
+   crypto::enable_hardware_acceleration(true);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(assert_hash_test)
+   const std::string data = "abc";
+   capi_checksum256 hash;
+   ::sha256(data.data(), data.size(), &hash);
+   ::assert_sha256(data.data(), data.size(), &hash);
+   CHECK_ASSERT( "hash mismatch", [&]() {
+         ::assert_sha256("abd", 3, &hash);
+      });
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(recover_key_test)
+   struct vector {
+      const char* message;
+      const char* signature;
+      const char* key;
+   };
+   // signed with python, private keys 1, 0xc0ffee1234...5678 and 0x1f2e3d4c...6a7988
+   const vector vectors[] = {
+      { "abc",
+        "0020f01d6b9018ab421dd410404cb869072065522bf85734008f105cf385a023a80f0ae14ce764372771895803d8ca206f4ca33b57423b6ee5344333ae66d3a9abbf",
+        "000279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798" },
+      { "eosio.token transfer",
+        "0020cc69e74d1301865f3ac3f718ef2bc4dab4ac2bec5a6fabebb76b3689e89c51b85c87c8c8e7f2c42807443b2f04a4551dbf44309c932f20a1d5b60a2e985fb25d",
+        "000336a1cf15ee33c4a1d5cf318e89ba8afece37aa9069dbe10048b63bd2b7fcba9a" },
+      { "native tester",
+        "001fd47592cec61cc5c4903ac21abf747890d7ad58c8ff434d8a4a25a64cf21572d316bd40ecf872260250ff45d3dcc8c861437008d5031b85b3e7c3c06847c1feb3",
+        "0002085fe2ca7a5758957ea811bd8e743d9cee6bc20072f1470a888c43a1091a8e8b" } };
+
+   for (const auto& v : vectors) {
+      const std::string message = v.message;
+      const auto digest = eosio::sha256(message.data(), message.size());
+      const auto sig = eosio::unpack<eosio::signature>(from_hex(v.signature));
+      const auto expected = eosio::unpack<eosio::public_key>(from_hex(v.key));
+      CHECK_EQUAL( eosio::recover_key(digest, sig) == expected, true );
+      eosio::assert_recover_key(digest, sig, expected);
+   }
+
+   const auto digest = eosio::sha256("other", 5);
+   const auto sig = eosio::unpack<eosio::signature>(from_hex(vectors[0].signature));
+   const auto key = eosio::unpack<eosio::public_key>(from_hex(vectors[0].key));
+   CHECK_ASSERT( "Error expected key different than recovered key", [&]() {
+         eosio::assert_recover_key(digest, sig, key);
+      });
+
+   auto bad_recovery_id = sig;
+   bad_recovery_id.data[0] = 26;
+   CHECK_ASSERT( "unable to reconstruct public key from signature", [&]() {
+         eosio::recover_key(digest, bad_recovery_id);
+      });
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(hash_test);
+   EOSIO_TEST(acceleration_test);
+   EOSIO_TEST(assert_hash_test);
+   EOSIO_TEST(recover_key_test);
+   return has_failed();
+}
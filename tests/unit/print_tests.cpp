@@ -1,4 +1,5 @@
 #include <eosiolib/eosio.hpp>
+#include <eosiolib/charconv.hpp>
 #include <eosio/native/tester.hpp>
 
 using namespace eosio::native;
@@ -8,7 +9,7 @@ EOSIO_TEST_BEGIN(print_test)
    CHECK_PRINT("27", [](){ eosio::print((uint8_t)27); });
    CHECK_PRINT("34", [](){ eosio::print((int)34); });
    CHECK_PRINT([](std::string s){return s[0] == 'a';},  [](){ eosio::print((char)'a'); });
-   CHECK_PRINT([](std::string s){return s[0] == 'b';},  [](){ eosio::print((int8_t)'b'); });
+   CHECK_PRINT("98", [](){ eosio::print((int8_t)'b'); });
    CHECK_PRINT("202", [](){ eosio::print((unsigned int)202); });
    CHECK_PRINT("-202", [](){ eosio::print((int)-202); });
    CHECK_PRINT("707", [](){ eosio::print((unsigned long)707); });
@@ -19,12 +20,57 @@ EOSIO_TEST_BEGIN(print_test)
    CHECK_PRINT("-404", [](){ eosio::print((int32_t)-404); });
    CHECK_PRINT("404000000", [](){ eosio::print((uint64_t)404000000); });
    CHECK_PRINT("-404000000", [](){ eosio::print((int64_t)-404000000); });
-   CHECK_PRINT("0x0066000000000000", [](){ eosio::print((uint128_t)102); });
-   CHECK_PRINT("0xffffff9affffffffffffffffffffffff", [](){ eosio::print((int128_t)-102); });
+   CHECK_PRINT("102", [](){ eosio::print((uint128_t)102); });
+   CHECK_PRINT("-102", [](){ eosio::print((int128_t)-102); });
+   CHECK_PRINT("1.500000e+00", [](){ eosio::print(1.5f); });
+   CHECK_PRINT("-2.500000000000000e-01", [](){ eosio::print(-0.25); });
+   CHECK_PRINT("00ff7f", [](){ uint8_t data[] = {0x00, 0xff, 0x7f}; printhex(data, sizeof(data)); });
    silence_output(false);
 EOSIO_TEST_END
 
+EOSIO_TEST_BEGIN(output_capture_test)
+   silence_output(true);
+   // spans several capture chunks and printhex blocks
+   std::vector<uint8_t> data(5000);
+   for (size_t i = 0; i < data.size(); i++)
+      data[i] = i;
+   std::string expected;
+   for (uint8_t c : data) {
+      expected += "0123456789abcdef"[c >> 4];
+      expected += "0123456789abcdef"[c & 0xf];
+   }
+   CHECK_PRINT([&](std::string s){ return s == expected; }, [&](){ printhex(data.data(), data.size()); });
+
+   std::string line(999, 'x');
+   CHECK_PRINT([&](std::string s){ return s.size() == 10 * line.size() && s.substr(8991) == line; }, [&](){
+      for (int i = 0; i < 10; i++)
+         eosio::print(line.c_str());
+   });
+   silence_output(false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(to_chars_test)
+   char buffer[eosio::max_integer_chars];
+   auto str = [&](auto v) {
+      return std::string( buffer, eosio::to_chars( buffer, buffer + sizeof(buffer), v ) );
+   };
+   CHECK_EQUAL( str(uint8_t(0)), "0" );
+   CHECK_EQUAL( str(int8_t(-128)), "-128" );
+   CHECK_EQUAL( str(uint64_t(9999999999999999999ull)), "9999999999999999999" );
+   CHECK_EQUAL( str(uint64_t(10000000000000000000ull)), "10000000000000000000" );
+   CHECK_EQUAL( str(std::numeric_limits<int64_t>::min()), "-9223372036854775808" );
+   CHECK_EQUAL( str(uint128_t(1) << 64), "18446744073709551616" );
+   CHECK_EQUAL( str(~uint128_t(0)), "340282366920938463463374607431768211455" );
+   CHECK_EQUAL( str(int128_t(uint128_t(1) << 127)), "-170141183460469231731687303715884105728" );
+
+   // a buffer that is too small is left untouched
+   CHECK_EQUAL( eosio::to_chars( buffer, buffer + 3, 1234 ) == buffer, true );
+   CHECK_EQUAL( eosio::to_chars( buffer, buffer + 3, -12 ) == buffer + 3, true );
+EOSIO_TEST_END
+
 int main(int argc, char** argv) {
    EOSIO_TEST(print_test);
+   EOSIO_TEST(to_chars_test);
+   EOSIO_TEST(output_capture_test);
    return has_failed();
 }
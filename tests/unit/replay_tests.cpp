@@ -0,0 +1,120 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/multi_index.hpp>
+#include <eosio/native/tester.hpp>
+#include <eosio/native/database.hpp>
+#include <eosio/native/replay.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+struct [[eosio::table]] counter_row {
+   uint64_t id;
+   name     owner;
+   uint64_t count;
+   uint64_t primary_key()const { return id; }
+   uint64_t by_owner()const { return owner.value; }
+   EOSLIB_SERIALIZE( counter_row, (id)(owner)(count) )
+};
+
+using counters_table = multi_index<"counters"_n, counter_row,
+                                   indexed_by<"byowner"_n, const_mem_fun<counter_row, uint64_t, &counter_row::by_owner>>>;
+
+// bump(owner) increments the counter of `owner`, which must already exist, and notifies the owner
+static void counter_apply( uint64_t receiver, uint64_t code, uint64_t act ) {
+   const name owner = unpack_action_data<name>();
+   require_auth(owner);
+   counters_table counters(name(receiver), receiver);
+   auto by_owner = counters.get_index<"byowner"_n>();
+   auto itr = by_owner.find(owner.value);
+   check(itr != by_owner.end(), "no counter for owner");
+   check(now() >= 1600000000, "counter is closed");
+   by_owner.modify(itr, owner, [](auto& r) { r.count++; });
+   require_recipient(owner);
+}
+
+static action_capture make_capture() {
+   action_capture capture;
+   capture.time = time_point(seconds(1600000000));
+   capture.accounts = { "alice"_n, "bob"_n };
+
+   const counter_row row{7, "alice"_n, 41};
+   captured_row primary;
+   primary.code        = "counter"_n;
+   primary.scope       = "counter"_n.value;
+   primary.table       = "counters"_n;
+   primary.payer       = "counter"_n;
+   primary.primary_key = row.id;
+   primary.value       = pack(row);
+   capture.rows.push_back(primary);
+
+   captured_index_row secondary;
+   secondary.code        = "counter"_n;
+   secondary.scope       = "counter"_n.value;
+   secondary.table       = name(("counters"_n.value & 0xFFFFFFFFFFFFFFF0ULL) | 0);
+   secondary.payer       = "counter"_n;
+   secondary.primary_key = row.id;
+   secondary.index       = uint8_t(captured_index::idx64);
+   const uint64_t key = row.owner.value;
+   secondary.secondary.assign(reinterpret_cast<const char*>(&key), reinterpret_cast<const char*>(&key) + sizeof(key));
+   capture.index_rows.push_back(secondary);
+
+   capture.act = action({"alice"_n, "active"_n}, "counter"_n, "bump"_n, "alice"_n);
+   return capture;
+}
+
+EOSIO_TEST_BEGIN(replay_test)
+   // goes through the binary format
+   const auto capture = unpack<action_capture>(pack(make_capture()));
+
+   replayer rep(counter_apply);
+   rep.load(capture);
+   const auto r = rep.replay(capture, 5);
+   CHECK_EQUAL( r.result.succeeded, true );
+   CHECK_EQUAL( r.durations_ns.size(), 5 );
+   CHECK_EQUAL( r.result.traces.size(), 2 );
+   CHECK_EQUAL( r.result.traces[1].receiver, "alice"_n );
+
+   // every run starts from the captured row, so the count went up only once
+   counters_table counters("counter"_n, "counter"_n.value);
+   CHECK_EQUAL( counters.get(7).count, 42 );
+
+   // the payer moved from the contract to alice
+   CHECK_EQUAL( r.ram_delta.count("alice"_n.value), 1 );
+   CHECK_EQUAL( r.ram_delta.at("alice"_n.value), -r.ram_delta.at("counter"_n.value) );
+
+   bool counted_lowerbound = false;
+   for (const auto& calls : r.intrinsic_calls)
+      if (calls.first == "db_idx64_lowerbound")
+         counted_lowerbound = calls.second == 1;
+   CHECK_EQUAL( counted_lowerbound, true );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(replay_failure_test)
+   auto capture = make_capture();
+   capture.time = time_point(seconds(1500000000));
+   replayer rep(counter_apply);
+   rep.load(capture);
+   auto r = rep.replay(capture);
+   CHECK_EQUAL( r.result.succeeded, false );
+   CHECK_EQUAL( r.result.error, "counter is closed" );
+
+   // a missing row is the capture's fault, not the contract's
+   capture = make_capture();
+   capture.index_rows.clear();
+   rep.load(capture);
+   r = rep.replay(capture);
+   CHECK_EQUAL( r.result.error, "no counter for owner" );
+
+   capture.index_rows = make_capture().index_rows;
+   capture.index_rows[0].secondary.pop_back();
+   CHECK_ASSERT( "captured secondary key has the wrong size", [&]() {
+         rep.load(capture);
+      });
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(replay_test);
+   EOSIO_TEST(replay_failure_test);
+   return has_failed();
+}
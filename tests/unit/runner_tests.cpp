@@ -0,0 +1,72 @@
+#include <eosiolib/eosio.hpp>
+#include <eosio/native/tester.hpp>
+#include <eosio/native/database.hpp>
+#include <eosio/native/runner.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+static int shared_counter = 0;
+
+static void passing_case() {
+   CHECK_EQUAL( shared_counter, 0 );
+   shared_counter++;
+   uint64_t value = 1;
+   database::get().store_i64("test"_n.value, 0, "rows"_n.value, "test"_n.value, 1, &value, sizeof(value));
+   eosio::print("passing output");
+}
+
+// sees neither the counter nor the row written by passing_case
+static void isolated_case() {
+   CHECK_EQUAL( shared_counter, 0 );
+   CHECK_EQUAL( database::get().find_i64("test"_n.value, 0, "rows"_n.value, 1), -1 );
+}
+
+static void check_failure_case() {
+   CHECK_EQUAL( 1, 2 );
+}
+
+static void assert_case() {
+   eosio_assert(false, "asserted in worker");
+}
+
+static void crash_case() {
+   __builtin_trap();
+}
+
+EOSIO_TEST_BEGIN(runner_test)
+   test_runner runner;
+   EOSIO_TEST_ADD(runner, passing_case);
+   EOSIO_TEST_ADD(runner, check_failure_case);
+   EOSIO_TEST_ADD(runner, isolated_case);
+   EOSIO_TEST_ADD(runner, assert_case);
+   EOSIO_TEST_ADD(runner, crash_case);
+
+   for (uint32_t jobs : {1u, 4u}) {
+      auto results = runner.run_all(jobs);
+      CHECK_EQUAL( results.size(), 5 );
+      CHECK_EQUAL( results[0].name, "passing_case" );
+      CHECK_EQUAL( results[0].passed, true );
+      CHECK_EQUAL( results[0].output, "passing output" );
+      CHECK_EQUAL( results[1].passed, false );
+      CHECK_EQUAL( results[1].output.find("CHECK_EQUAL failed (1 != 2)") != std::string::npos, true );
+      CHECK_EQUAL( results[2].passed, true );
+      CHECK_EQUAL( results[3].passed, false );
+      CHECK_EQUAL( results[3].output, "asserted in worker\n" );
+      CHECK_EQUAL( results[4].passed, false );
+      CHECK_EQUAL( results[4].output.find("worker killed by signal") != std::string::npos, true );
+   }
+
+   // nothing run in the workers leaks into the runner
+   CHECK_EQUAL( shared_counter, 0 );
+
+   auto selected = runner.run_all(2, {"isolated_case"});
+   CHECK_EQUAL( selected.size(), 1 );
+   CHECK_EQUAL( selected[0].passed, true );
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(runner_test);
+   return has_failed();
+}
@@ -0,0 +1,239 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/multi_index.hpp>
+#include <eosio/native/tester.hpp>
+#include <eosio/native/database.hpp>
+#include <eosio/native/simulator.hpp>
+#include <eosio/native/clock.hpp>
+
+using namespace eosio;
+using namespace eosio::native;
+
+struct deposit {
+   name     from;
+   uint64_t amount;
+   EOSLIB_SERIALIZE( deposit, (from)(amount) )
+};
+
+struct [[eosio::table]] balance_row {
+   name     owner;
+   uint64_t amount;
+   uint64_t primary_key()const { return owner.value; }
+   EOSLIB_SERIALIZE( balance_row, (owner)(amount) )
+};
+
+using balances_table = multi_index<"balances"_n, balance_row>;
+
+static std::vector<std::string> events;
+
+// credits the depositor, notifies the watcher and logs through an inline action
+static void bank_apply( uint64_t receiver, uint64_t code, uint64_t act ) {
+   auto d = unpack_action_data<deposit>();
+   require_auth(d.from);
+   balances_table balances(name(receiver), receiver);
+   auto itr = balances.find(d.from.value);
+   if (itr == balances.end())
+      balances.emplace(name(receiver), [&](auto& r) { r.owner = d.from; r.amount = d.amount; });
+   else
+      balances.modify(itr, same_payer, [&](auto& r) { r.amount += d.amount; });
+   check(d.amount != 13, "unlucky deposit");
+   require_recipient("watcher"_n);
+   action({name(receiver), "active"_n}, "logger"_n, "log"_n, d).send();
+   events.push_back("bank");
+}
+
+static void watcher_apply( uint64_t receiver, uint64_t code, uint64_t act ) {
+   check(code == "bank"_n.value && !is_inline(), "watcher only expects deposit notifications");
+   action({name(receiver), "active"_n}, "logger"_n, "log"_n, unpack_action_data<deposit>()).send();
+   events.push_back("watcher");
+}
+
+static void logger_apply( uint64_t receiver, uint64_t code, uint64_t act ) {
+   check(is_inline(), "log is only sent inline");
+   events.push_back("logger");
+}
+
+// relay(n) sends relay(n - 1) inline until n reaches 0
+static void relay_apply( uint64_t receiver, uint64_t code, uint64_t act ) {
+   const uint64_t n = unpack_action_data<uint64_t>();
+   if (n > 0)
+      action({name(receiver), "active"_n}, name(receiver), "relay"_n, n - 1).send();
+}
+
+static std::vector<uint32_t> ticks;
+
+// schedule(n) fires tick(n) n seconds later, cancel(n) drops it again
+static void scheduler_apply( uint64_t receiver, uint64_t code, uint64_t act ) {
+   const uint64_t n = unpack_action_data<uint64_t>();
+   if (act == "schedule"_n.value) {
+      transaction trx;
+      trx.actions.emplace_back(permission_level{name(receiver), "active"_n}, name(receiver), "tick"_n, n);
+      trx.delay_sec = n;
+      trx.send(n, name(receiver), true);
+   } else if (act == "cancel"_n.value) {
+      check(cancel_deferred(n) == 1, "nothing to cancel");
+   } else if (act == "tick"_n.value) {
+      check(n != 13, "unlucky tick");
+      ticks.push_back(now());
+   }
+}
+
+static simulator make_simulator() {
+   simulator sim;
+   sim.set_contract("bank"_n, bank_apply);
+   sim.set_contract("watcher"_n, watcher_apply);
+   sim.set_contract("logger"_n, logger_apply);
+   sim.set_contract("scheduler"_n, scheduler_apply);
+   sim.set_contract("relay"_n, relay_apply);
+   sim.create_account("alice"_n);
+   return sim;
+}
+
+static uint64_t balance_of( name owner ) {
+   uint64_t value[2] = {};
+   int32_t itr = db_find_i64("bank"_n.value, "bank"_n.value, "balances"_n.value, owner.value);
+   if (itr < 0)
+      return 0;
+   db_get_i64(itr, value, sizeof(value));
+   return value[1];
+}
+
+EOSIO_TEST_BEGIN(notification_order_test)
+   database::get().clear();
+   events.clear();
+   simulator sim = make_simulator();
+
+   auto res = sim.push_action(action({"alice"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"alice"_n, 5}));
+   CHECK_EQUAL( res.succeeded, true );
+   CHECK_EQUAL( res.error, "" );
+
+   // receiver, notified accounts, then the inline actions in the order they were sent
+   std::vector<std::string> expected_events = {"bank", "watcher", "logger", "logger"};
+   CHECK_EQUAL( events == expected_events, true );
+   CHECK_EQUAL( res.traces.size(), 4 );
+   CHECK_EQUAL( res.traces[0].receiver, "bank"_n );
+   CHECK_EQUAL( res.traces[1].receiver, "watcher"_n );
+   CHECK_EQUAL( res.traces[1].act.account, "bank"_n );
+   CHECK_EQUAL( res.traces[2].receiver, "logger"_n );
+   CHECK_EQUAL( res.traces[2].depth, 1 );
+   CHECK_EQUAL( balance_of("alice"_n), 5 );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(rollback_test)
+   database::get().clear();
+   events.clear();
+   simulator sim = make_simulator();
+
+   CHECK_EQUAL( sim.push_action(action({"alice"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"alice"_n, 5})).succeeded, true );
+
+   // the second action fails after the first one already wrote, both are undone
+   auto res = sim.push_transaction({
+         action({"alice"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"alice"_n, 7}),
+         action({"alice"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"alice"_n, 13})
+      });
+   CHECK_EQUAL( res.succeeded, false );
+   CHECK_EQUAL( res.error, "unlucky deposit" );
+   CHECK_EQUAL( balance_of("alice"_n), 5 );
+
+   res = sim.push_action(action({"bob"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"alice"_n, 1}));
+   CHECK_EQUAL( res.succeeded, false );
+   CHECK_EQUAL( res.error, "missing authority of alice" );
+
+   res = sim.push_action(action({"alice"_n, "active"_n}, "logger"_n, "log"_n, deposit{"alice"_n, 1}));
+   CHECK_EQUAL( res.error, "log is only sent inline" );
+
+   res = sim.push_action(action({"alice"_n, "active"_n}, "nobody"_n, "log"_n, deposit{"alice"_n, 1}));
+   CHECK_EQUAL( res.error, "action's receiving account nobody does not exist" );
+
+   // the action at the maximum inline depth still runs, only sending one more inline action fails
+   res = sim.push_action(action({"relay"_n, "active"_n}, "relay"_n, "relay"_n, uint64_t(simulator::max_inline_action_depth)));
+   CHECK_EQUAL( res.succeeded, true );
+   CHECK_EQUAL( res.traces.size(), simulator::max_inline_action_depth + 1 );
+   CHECK_EQUAL( res.traces.back().depth, simulator::max_inline_action_depth );
+   res = sim.push_action(action({"relay"_n, "active"_n}, "relay"_n, "relay"_n, uint64_t(simulator::max_inline_action_depth + 1)));
+   CHECK_EQUAL( res.error, "max inline action depth per transaction reached" );
+
+   // the simulator restores the intrinsics it replaced
+   REQUIRE_ASSERT( "unsupported intrinsic", []() { current_receiver(); } );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(clock_test)
+   virtual_clock::get().reset();
+   const uint32_t genesis = now();
+   CHECK_EQUAL( tapos_block_num(), 1 );
+   virtual_clock::get().advance(eosio::seconds(3600));
+   CHECK_EQUAL( now(), genesis + 3600 );
+   CHECK_EQUAL( tapos_block_num(), 7201 );
+   CHECK_EQUAL( expiration(), now() + virtual_clock::default_expiration_sec );
+   REQUIRE_ASSERT( "virtual clock cannot go backwards", []() {
+         virtual_clock::get().set(eosio::time_point(eosio::seconds(0)));
+      });
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(deferred_test)
+   database::get().clear();
+   virtual_clock::get().reset();
+   ticks.clear();
+   simulator sim = make_simulator();
+   const uint32_t start = now();
+   auto schedule = [&](const char* act, uint64_t n) {
+      return sim.push_action(action({"scheduler"_n, "active"_n}, "scheduler"_n, name(act), n));
+   };
+
+   CHECK_EQUAL( schedule("schedule", 30).succeeded, true );
+   CHECK_EQUAL( schedule("schedule", 10).succeeded, true );
+   CHECK_EQUAL( schedule("schedule", 20).succeeded, true );
+   CHECK_EQUAL( schedule("schedule", 13).succeeded, true );
+   CHECK_EQUAL( schedule("cancel", 20).succeeded, true );
+   CHECK_EQUAL( schedule("cancel", 20).error, "nothing to cancel" );
+   CHECK_EQUAL( sim.deferred_transactions().size(), 3 );
+
+   // nothing is due yet
+   CHECK_EQUAL( sim.advance(eosio::seconds(5)).size(), 0 );
+
+   // due transactions run in delay order at their own time, a failing one does not stop the others
+   auto results = sim.advance(eosio::days(7));
+   CHECK_EQUAL( results.size(), 3 );
+   CHECK_EQUAL( results[0].succeeded, true );
+   CHECK_EQUAL( results[1].error, "unlucky tick" );
+   CHECK_EQUAL( results[2].succeeded, true );
+   std::vector<uint32_t> expected_ticks = {start + 10, start + 30};
+   CHECK_EQUAL( ticks == expected_ticks, true );
+   CHECK_EQUAL( now(), start + 5 + 7 * 24 * 3600 );
+   CHECK_EQUAL( sim.deferred_transactions().size(), 0 );
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(fixture_test)
+   database::get().clear();
+   virtual_clock::get().reset();
+   ticks.clear();
+   simulator sim = make_simulator();
+   CHECK_EQUAL( sim.push_action(action({"alice"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"alice"_n, 5})).succeeded, true );
+   CHECK_EQUAL( sim.push_action(action({"scheduler"_n, "active"_n}, "scheduler"_n, "schedule"_n, uint64_t(10))).succeeded, true );
+   const uint32_t start = now();
+   const auto fixture = sim.snapshot();
+
+   for (int round = 0; round < 2; round++) {
+      sim.create_account("carol"_n);
+      CHECK_EQUAL( sim.push_action(action({"carol"_n, "active"_n}, "bank"_n, "deposit"_n, deposit{"carol"_n, 3})).succeeded, true );
+      CHECK_EQUAL( sim.advance(eosio::seconds(60)).size(), 1 );
+      CHECK_EQUAL( balance_of("carol"_n), 3 );
+
+      sim.restore(fixture);
+      CHECK_EQUAL( sim.is_account("carol"_n), false );
+      CHECK_EQUAL( balance_of("carol"_n), 0 );
+      CHECK_EQUAL( balance_of("alice"_n), 5 );
+      CHECK_EQUAL( now(), start );
+      CHECK_EQUAL( sim.deferred_transactions().size(), 1 );
+   }
+   sim.release(fixture);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   EOSIO_TEST(notification_order_test);
+   EOSIO_TEST(rollback_test);
+   EOSIO_TEST(clock_test);
+   EOSIO_TEST(deferred_test);
+   EOSIO_TEST(fixture_test);
+   return has_failed();
+}
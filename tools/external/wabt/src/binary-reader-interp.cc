@@ -1599,6 +1599,7 @@ wabt::Result BinaryReaderInterp::EndModule() {
   for (DataSegmentInfo& info : data_segment_infos_) {
     memcpy(info.dst_data, info.src_data, info.size);
   }
+  module_->func_indexes = func_index_mapping_;
   return wabt::Result::Ok;
 }
 
@@ -1443,6 +1443,7 @@ Result Thread::Run(int num_instructions) {
   for (int i = 0; i < num_instructions; ++i) {
     Opcode opcode = ReadOpcode(&pc);
     assert(!opcode.IsInvalid());
+    ++instruction_count_;
     switch (opcode) {
       case Opcode::Select: {
         uint32_t cond = Pop<uint32_t>();
@@ -1481,6 +1482,9 @@ Result Thread::Run(int num_instructions) {
       }
 
       case Opcode::Return:
+        if (observer_) {
+          observer_->OnReturn(instruction_count_);
+        }
         if (call_stack_top_ == 0) {
           result = Result::Returned;
           goto exit_loop;
@@ -1541,6 +1545,9 @@ Result Thread::Run(int num_instructions) {
       case Opcode::Call: {
         IstreamOffset offset = ReadU32(&pc);
         CHECK_TRAP(PushCall(pc));
+        if (observer_) {
+          observer_->OnCall(offset, instruction_count_);
+        }
         GOTO(offset);
         break;
       }
@@ -1557,9 +1564,13 @@ Result Thread::Run(int num_instructions) {
         TRAP_UNLESS(env_->FuncSignaturesAreEqual(func->sig_index, sig_index),
                     IndirectCallSignatureMismatch);
         if (func->is_host) {
-          CallHost(cast<HostFunc>(func));
+          CHECK_TRAP(CallHost(cast<HostFunc>(func)));
         } else {
           CHECK_TRAP(PushCall(pc));
+          if (observer_) {
+            observer_->OnCall(cast<DefinedFunc>(func)->offset,
+                              instruction_count_);
+          }
           GOTO(cast<DefinedFunc>(func)->offset);
         }
         break;
@@ -1567,7 +1578,7 @@ Result Thread::Run(int num_instructions) {
 
       case Opcode::InterpCallHost: {
         Index func_index = ReadU32(&pc);
-        CallHost(cast<HostFunc>(env_->funcs_[func_index].get()));
+        CHECK_TRAP(CallHost(cast<HostFunc>(env_->funcs_[func_index].get())));
         break;
       }
 
@@ -4493,6 +4504,10 @@ ExecResult Executor::RunExportByName(Module* module,
 Result Executor::RunDefinedFunction(IstreamOffset function_offset) {
   Result result = Result::Ok;
   thread_.set_pc(function_offset);
+  ThreadObserver* observer = thread_.observer();
+  if (observer) {
+    observer->OnCall(function_offset, thread_.instruction_count());
+  }
   if (trace_stream_) {
     const int kNumInstructions = 1;
     while (result == Result::Ok) {
@@ -4506,6 +4521,9 @@ Result Executor::RunDefinedFunction(IstreamOffset function_offset) {
     }
   }
   if (result != Result::Returned) {
+    if (observer) {
+      observer->OnTrap(thread_.instruction_count());
+    }
     return result;
   }
   // Use OK instead of RETURNED for consistency.
@@ -321,6 +321,8 @@ struct DefinedModule : Module {
   std::vector<GlobalImport> global_imports;
   std::vector<ExceptImport> except_imports;
   Index start_func_index; /* kInvalidIndex if not defined */
+  // Environment index of each function of the module, imports first.
+  std::vector<Index> func_indexes;
   IstreamOffset istream_start;
   IstreamOffset istream_end;
 };
@@ -463,6 +465,18 @@ class Environment {
   BindingHash registered_module_bindings_;
 };
 
+// Notified as a thread enters and leaves defined functions, e.g. to profile
+// where instructions are executed. Instruction counts are the running total of
+// the thread.
+class ThreadObserver {
+ public:
+  virtual ~ThreadObserver() {}
+  virtual void OnCall(IstreamOffset func_offset, uint64_t instructions) = 0;
+  virtual void OnReturn(uint64_t instructions) = 0;
+  // Called instead of the remaining returns when execution stops with a trap.
+  virtual void OnTrap(uint64_t instructions) = 0;
+};
+
 class Thread {
  public:
   struct Options {
@@ -483,6 +497,10 @@ class Thread {
   void set_pc(IstreamOffset offset) { pc_ = offset; }
   IstreamOffset pc() const { return pc_; }
 
+  void set_observer(ThreadObserver* observer) { observer_ = observer; }
+  ThreadObserver* observer() const { return observer_; }
+  uint64_t instruction_count() const { return instruction_count_; }
+
   void Reset();
   Index NumValues() const { return value_stack_top_; }
   Result Push(Value) WABT_WARN_UNUSED;
@@ -568,6 +586,8 @@ class Thread {
   uint32_t value_stack_top_ = 0;
   uint32_t call_stack_top_ = 0;
   IstreamOffset pc_ = 0;
+  ThreadObserver* observer_ = nullptr;
+  uint64_t instruction_count_ = 0;
 };
 
 struct ExecResult {
@@ -593,6 +613,9 @@ class Executor {
                              string_view name,
                              const TypedValues& args);
 
+  void set_observer(ThreadObserver* observer) { thread_.set_observer(observer); }
+  uint64_t instruction_count() const { return thread_.instruction_count(); }
+
  private:
   Result RunDefinedFunction(IstreamOffset function_offset);
   Result PushArgs(const FuncSignature*, const TypedValues& args);
@@ -41,6 +41,7 @@ static std::string s_infile;
 static std::string s_outfile;
 static Features s_features;
 static WriteBinaryOptions s_write_binary_options;
+static bool s_keep_names = false;
 static std::unique_ptr<FileStream> s_log_stream;
 
 static const char s_description[] =
@@ -67,6 +68,10 @@ static void ParseOptions(int argc, char** argv) {
         s_outfile = argument;
         ConvertBackslashToSlash(&s_outfile);
       });
+  parser.AddOption("keep-names", "Keep the name section", []() {
+    s_keep_names = true;
+    s_write_binary_options.write_debug_names = true;
+  });
   parser.AddArgument("filename", OptionParser::ArgumentCount::One,
                      [](const char* argument) {
                        s_infile = argument;
@@ -109,7 +114,7 @@ int ProgramMain(int argc, char** argv) {
     Module module;
     const bool kStopOnFirstError = true;
     ReadBinaryOptions options(s_features, s_log_stream_s.get(),
-                              stub, kStopOnFirstError,
+                              s_keep_names, kStopOnFirstError,
                               stub);
     result = ReadBinaryIr(s_infile.c_str(), file_data.data(),
                           file_data.size(), &options, &error_handler, &module);
@@ -0,0 +1,181 @@
+#include "apply_context.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+namespace eosio { namespace cdt {
+
+   namespace {
+      uint64_t char_to_symbol( char c ) {
+         if (c >= 'a' && c <= 'z')
+            return (c - 'a') + 6;
+         if (c >= '1' && c <= '5')
+            return (c - '1') + 1;
+         return 0;
+      }
+
+      uint32_t read_varuint32( const char*& pos, const char* end ) {
+         uint32_t value = 0;
+         for (int shift = 0; shift < 35; shift += 7) {
+            if (pos == end)
+               fail("read datastream of length past the end");
+            const uint8_t b = *pos++;
+            value |= uint32_t(b & 0x7f) << shift;
+            if (!(b & 0x80))
+               return value;
+         }
+         fail("varuint32 is too long");
+      }
+
+      void read( const char*& pos, const char* end, void* out, size_t size ) {
+         if (size_t(end - pos) < size)
+            fail("read datastream of length past the end");
+         memcpy(out, pos, size);
+         pos += size;
+      }
+   }
+
+   uint64_t string_to_name( const std::string& str ) {
+      uint64_t name = 0;
+      size_t i = 0;
+      for (; i < str.size() && i < 12; ++i)
+         name |= (char_to_symbol(str[i]) & 0x1f) << (64 - 5 * (i + 1));
+      if (i == 12 && str.size() > 12)
+         name |= char_to_symbol(str[12]) & 0x0f;
+      return name;
+   }
+
+   std::string name_to_string( uint64_t name ) {
+      static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+      std::string str(13, '.');
+      uint64_t tmp = name;
+      for (uint32_t i = 0; i <= 12; ++i) {
+         str[12 - i] = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+         tmp >>= (i == 0 ? 4 : 5);
+      }
+      str.erase(str.find_last_not_of('.') + 1);
+      return str;
+   }
+
+   permission_level string_to_permission_level( const std::string& str ) {
+      const auto at = str.find('@');
+      if (at == std::string::npos)
+         return {string_to_name(str), string_to_name("active")};
+      return {string_to_name(str.substr(0, at)), string_to_name(str.substr(at + 1))};
+   }
+
+   std::vector<char> from_hex( const std::string& hex ) {
+      auto nibble = [&](char c) -> int {
+         if (c >= '0' && c <= '9') return c - '0';
+         if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+         if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+         throw std::invalid_argument("not a hex string: " + hex);
+      };
+      if (hex.size() % 2)
+         throw std::invalid_argument("odd number of hex digits: " + hex);
+      std::vector<char> data(hex.size() / 2);
+      for (size_t i = 0; i < data.size(); i++)
+         data[i] = char(nibble(hex[2 * i]) << 4 | nibble(hex[2 * i + 1]));
+      return data;
+   }
+
+   void fail( const std::string& msg ) {
+      throw action_failure(msg);
+   }
+
+   action action::unpack( const char* data, size_t size ) {
+      const char* pos = data;
+      const char* end = data + size;
+      action act;
+      read(pos, end, &act.account, sizeof(act.account));
+      read(pos, end, &act.name, sizeof(act.name));
+      act.authorization.resize(read_varuint32(pos, end));
+      for (auto& auth : act.authorization) {
+         read(pos, end, &auth.actor, sizeof(auth.actor));
+         read(pos, end, &auth.permission, sizeof(auth.permission));
+      }
+      act.data.resize(read_varuint32(pos, end));
+      read(pos, end, act.data.data(), act.data.size());
+      return act;
+   }
+
+   std::string action::to_string()const {
+      static const char* digits = "0123456789abcdef";
+      std::string str = name_to_string(account) + "::" + name_to_string(name) + " [";
+      for (size_t i = 0; i < authorization.size(); i++)
+         str += (i ? ", " : "") + name_to_string(authorization[i].actor) + "@" +
+                name_to_string(authorization[i].permission);
+      str += "] ";
+      for (char c : data) {
+         str += digits[uint8_t(c) >> 4];
+         str += digits[uint8_t(c) & 0xf];
+      }
+      return str;
+   }
+
+   const char* wasm_memory::c_str( uint32_t ptr )const {
+      const char* str = bytes(ptr, 0);
+      if (!memchr(str, 0, _size - ptr))
+         fail("access violation");
+      return str;
+   }
+
+   bool float128_key::is_nan()const {
+      return (high & 0x7fff000000000000ull) == 0x7fff000000000000ull &&
+             ((high & 0x0000ffffffffffffull) != 0 || low != 0);
+   }
+
+   bool operator<( const float128_key& a, const float128_key& b ) {
+      const bool a_negative = a.high >> 63;
+      const bool b_negative = b.high >> 63;
+      const auto a_magnitude = std::make_tuple(a.high & ~(1ull << 63), a.low);
+      const auto b_magnitude = std::make_tuple(b.high & ~(1ull << 63), b.low);
+      const auto zero = std::make_tuple(uint64_t(0), uint64_t(0));
+      if (a_magnitude == zero && b_magnitude == zero)
+         return false; // -0 == +0
+      if (a_negative != b_negative)
+         return a_negative;
+      return a_negative ? b_magnitude < a_magnitude : a_magnitude < b_magnitude;
+   }
+
+   void apply_context::start_action( uint64_t recv, const action& a, uint32_t d ) {
+      receiver = recv;
+      act      = a;
+      depth    = d;
+      console.clear();
+      notified.clear();
+      inline_actions.clear();
+      context_free_inline_actions.clear();
+      db.reset_iterators();
+      idx_long_double.reset_iterators();
+   }
+
+   bool apply_context::has_auth( uint64_t account )const {
+      return std::any_of(act.authorization.begin(), act.authorization.end(),
+                         [&](const permission_level& auth) { return auth.actor == account; });
+   }
+
+   void apply_context::require_auth( uint64_t account )const {
+      if (!has_auth(account))
+         fail("missing authority of " + name_to_string(account));
+   }
+
+   void apply_context::require_auth( uint64_t account, uint64_t permission )const {
+      for (const auto& auth : act.authorization)
+         if (auth.actor == account && auth.permission == permission)
+            return;
+      fail("missing authority of " + name_to_string(account) + "/" + name_to_string(permission));
+   }
+
+   void apply_context::require_recipient( uint64_t recipient ) {
+      if (recipient != receiver && std::find(notified.begin(), notified.end(), recipient) == notified.end())
+         notified.push_back(recipient);
+   }
+
+}} //ns eosio::cdt
+
+// the native database and crypto code report failures with eosio_assert, as they would inside a contract
+extern "C" void eosio_assert( uint32_t test, const char* msg ) {
+   if (!test)
+      eosio::cdt::fail(std::string("assertion failure with message: ") + msg);
+}
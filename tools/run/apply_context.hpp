@@ -0,0 +1,150 @@
+#pragma once
+#include "compat.hpp"
+
+#include <native/database.hpp>
+
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   uint64_t    string_to_name( const std::string& str );
+   std::string name_to_string( uint64_t name );
+
+   struct permission_level {
+      uint64_t actor      = 0;
+      uint64_t permission = 0;
+   };
+
+   /**
+    * `actor@permission`, the permission defaults to active
+    */
+   permission_level string_to_permission_level( const std::string& str );
+
+   /**
+    * Bytes of a hex string, throws std::invalid_argument if it is not one
+    */
+   std::vector<char> from_hex( const std::string& hex );
+
+   struct action {
+      uint64_t                      account = 0;
+      uint64_t                      name    = 0;
+      std::vector<permission_level> authorization;
+      std::vector<char>             data;
+
+      /**
+       * Read an action packed by eosio::pack, as send_inline() receives it
+       */
+      static action unpack( const char* data, size_t size );
+
+      /**
+       * `account::name` followed by the authorizations and the data in hex
+       */
+      std::string to_string()const;
+   };
+
+   /**
+    * Thrown when the action fails the way it would fail the transaction in nodeos
+    */
+   struct action_failure : std::runtime_error {
+      using std::runtime_error::runtime_error;
+   };
+
+   /**
+    * Thrown by eosio_exit() to end the action early, successfully
+    */
+   struct action_exit {};
+
+   [[noreturn]] void fail( const std::string& msg );
+
+   /**
+    * The linear memory of the running contract, every access is bounds checked
+    *
+    * Pointers handed to intrinsics are offsets into this memory and may be unaligned, values are copied in
+    * and out with load() and store().
+    */
+   class wasm_memory {
+      public:
+         wasm_memory() = default;
+         wasm_memory( char* data, size_t size ) : _data(data), _size(size) {}
+
+         char* bytes( uint32_t ptr, uint64_t size )const {
+            if (ptr > _size || size > _size - ptr)
+               fail("access violation");
+            return _data + ptr;
+         }
+
+         template <typename T>
+         T load( uint32_t ptr )const {
+            T value;
+            memcpy(&value, bytes(ptr, sizeof(T)), sizeof(T));
+            return value;
+         }
+
+         template <typename T>
+         void store( uint32_t ptr, const T& value )const {
+            memcpy(bytes(ptr, sizeof(T)), &value, sizeof(T));
+         }
+
+         /**
+          * A null terminated string, which must end inside the memory
+          */
+         const char* c_str( uint32_t ptr )const;
+
+         size_t size()const { return _size; }
+
+      private:
+         char*  _data = nullptr;
+         size_t _size = 0;
+   };
+
+   /**
+    * A binary128 long double as the contract stores it, ordered like the softfloat keys of nodeos
+    */
+   struct float128_key {
+      uint64_t low  = 0;
+      uint64_t high = 0;
+
+      bool is_nan()const;
+      friend bool operator<( const float128_key& a, const float128_key& b );
+   };
+
+   /**
+    * The chain state seen by a contract and the context of the action it runs
+    *
+    * Engines (the interpreter of eosio-run, or anything else that executes contract code) set `memory` before
+    * calling an intrinsic and report failures of the contract by throwing action_failure.
+    */
+   class apply_context {
+      public:
+         eosio::native::database                              db;
+         eosio::native::secondary_index<float128_key>         idx_long_double;
+         std::set<uint64_t>                                   accounts;
+         uint64_t                                             time_us = 0; ///< block time in microseconds since 1970
+
+         uint64_t            receiver = 0;
+         action              act;
+         uint32_t            depth = 0; ///< of `act` among the inline actions, 0 for an action of the transaction
+         std::string         console;
+         std::vector<uint64_t> notified;
+         std::vector<action> inline_actions;
+         std::vector<action> context_free_inline_actions;
+         wasm_memory         memory;
+
+         /**
+          * Reset what belongs to one action and make `act` the current action of `receiver`, sent inline at `depth`
+          */
+         void start_action( uint64_t receiver, const action& act, uint32_t depth = 0 );
+
+         bool has_auth( uint64_t account )const;
+         void require_auth( uint64_t account )const;
+         void require_auth( uint64_t account, uint64_t permission )const;
+         void require_recipient( uint64_t recipient );
+         bool is_account( uint64_t account )const { return accounts.count(account) != 0; }
+         void print( const char* str, size_t size ) { console.append(str, size); }
+   };
+
+}} //ns eosio::cdt
@@ -0,0 +1,6 @@
+#pragma once
+#include <cstdint>
+
+// eosio's libc provides these, the native database and crypto sources are shared with the native tester
+typedef __int128          int128_t;
+typedef unsigned __int128 uint128_t;
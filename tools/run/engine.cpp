@@ -0,0 +1,36 @@
+#include "engine.hpp"
+#include "interpreter.hpp"
+#include "native.hpp"
+
+#include <src/binary.h>
+#include <src/common.h>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace eosio { namespace cdt {
+
+   uint64_t apply_stats::total_intrinsic_calls()const {
+      uint64_t total = 0;
+      for (const auto& calls : intrinsic_calls)
+         total += calls.second;
+      return total;
+   }
+
+   std::unique_ptr<engine> load_contract( const std::string& file ) {
+      std::ifstream in(file, std::ios::binary);
+      if (!in)
+         throw std::runtime_error("unable to read " + file);
+      // anything that is not a wasm module must be a library built by compile_native()
+      uint32_t magic = 0;
+      in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+      if (magic != WABT_BINARY_MAGIC)
+         return std::make_unique<native_contract>(file);
+
+      std::vector<uint8_t> code;
+      if (wabt::Failed(wabt::ReadFile(file, &code)))
+         throw std::runtime_error("unable to read " + file);
+      return std::make_unique<interpreter>(std::move(code));
+   }
+
+}} //ns eosio::cdt
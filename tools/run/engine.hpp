@@ -0,0 +1,42 @@
+#pragma once
+#include "apply_context.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace eosio { namespace cdt {
+
+   /**
+    * The work one apply() of a contract did, deterministic for the same contract, state and action
+    */
+   struct apply_stats {
+      uint64_t                        instructions = 0; ///< executed by wabt's interpreter, not counted natively
+      uint32_t                        memory_pages = 0; ///< size of the linear memory when apply() ended
+      std::map<std::string, uint64_t> intrinsic_calls;  ///< by import name
+
+      uint64_t total_intrinsic_calls()const;
+   };
+
+   /**
+    * Executes the code of one contract, interpreted or compiled to native code
+    */
+   class engine {
+      public:
+         virtual ~engine() = default;
+
+         /**
+          * Call `apply(receiver, code, action)` of the contract for `ctx.act`, throws action_failure if it fails
+          *
+          * With `stats` set the work done is added to it, also when the action fails.
+          */
+         virtual void apply( apply_context& ctx, apply_stats* stats = nullptr ) = 0;
+   };
+
+   /**
+    * Load the contract in `file`, a .wasm file or a library built by compile_native(), throws std::runtime_error
+    * if it can not be read
+    */
+   std::unique_ptr<engine> load_contract( const std::string& file );
+
+}} //ns eosio::cdt
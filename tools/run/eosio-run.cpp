@@ -0,0 +1,223 @@
+#include "interpreter.hpp"
+#include "native.hpp"
+#include "profiler.hpp"
+#include "suite.hpp"
+
+#include <src/common.h>
+#include <src/option-parser.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+using namespace eosio::cdt;
+
+namespace {
+   const char description[] =
+      "  Run one action of a contract on the wabt interpreter, with the intrinsics of nodeos backed by an\n"
+      "  in-memory chain state. Prints what the action printed, the accounts it notified and the inline\n"
+      "  actions it sent. With --suite it runs a script of actions instead and reports what each one cost.\n"
+      "\n"
+      "examples:\n"
+      "  $ eosio-run hello.wasm --receiver hello --action hi --data 0000000000ea3055 --auth alice@active\n"
+      "\n"
+      "  # profile the action, link the contract with -fkeep-names to see function names\n"
+      "  $ eosio-run hello.wasm -r hello -a hi -d 0000000000ea3055 -p alice --profile hi.folded\n"
+      "  $ flamegraph.pl hi.folded > hi.svg\n"
+      "\n"
+      "  # run a cost suite and fail if an action got more expensive than in the baseline\n"
+      "  $ eosio-run --suite costs.json --baseline costs.baseline.json\n"
+      "\n"
+      "  # compile the contract to native code with wasm2c and run that instead of the wasm\n"
+      "  $ eosio-run hello.wasm --compile hello.so\n"
+      "  $ eosio-run hello.so -r hello -a hi -d 0000000000ea3055 -p alice\n";
+
+   std::string              wasm_file;
+   std::string              receiver = "eosio";
+   std::string              action_name;
+   std::string              data_hex;
+   std::vector<std::string> auths;
+   std::vector<std::string> accounts;
+   std::string              time_us;
+   std::string              profile_file;
+   std::string              profile_host_file;
+   bool                     suite_mode = false;
+   std::string              contracts_dir;
+   std::string              baseline_file;
+   bool                     update_baseline = false;
+   bool                     allow_missing = false;
+   std::string              tolerance = "0";
+   std::string              compile_file;
+
+   template <typename Write>
+   bool write_profile( const std::string& file, Write&& write ) {
+      if (file.empty())
+         return true;
+      std::ofstream os(file);
+      write(os);
+      if (!os) {
+         std::cerr << "eosio-run: unable to write " << file << "\n";
+         return false;
+      }
+      return true;
+   }
+
+   void parse_options( int argc, char** argv ) {
+      wabt::OptionParser parser("eosio-run", description);
+      parser.AddHelpOption();
+      parser.AddOption('r', "receiver", "ACCOUNT", "Account the contract is deployed to, defaults to eosio",
+                       [](const char* arg) { receiver = arg; });
+      parser.AddOption('a', "action", "NAME", "Name of the action to run",
+                       [](const char* arg) { action_name = arg; });
+      parser.AddOption('d', "data", "HEX", "Packed action data, as a hex string",
+                       [](const char* arg) { data_hex = arg; });
+      parser.AddOption('p', "auth", "ACTOR[@PERMISSION]", "Authorization of the action, can be given more than once",
+                       [](const char* arg) { auths.push_back(arg); });
+      parser.AddOption('\0', "account", "ACCOUNT", "Account that exists on the chain besides the receiver and the actors",
+                       [](const char* arg) { accounts.push_back(arg); });
+      parser.AddOption('\0', "time", "MICROSECONDS", "Value of current_time(), defaults to the time of the host",
+                       [](const char* arg) { time_us = arg; });
+      parser.AddOption('\0', "profile", "FILE", "Write the instructions executed per call stack to FILE, as folded stacks, "
+                       "and print a summary per function", [](const char* arg) { profile_file = arg; });
+      parser.AddOption('\0', "profile-host", "FILE", "Write the nanoseconds spent in host calls per call stack to FILE, "
+                       "as folded stacks", [](const char* arg) { profile_host_file = arg; });
+      parser.AddOption("suite", "Run the cost suite given as filename instead of one action",
+                       []() { suite_mode = true; });
+      parser.AddOption('\0', "contracts", "DIR", "Directory the contracts of the suite are read from, defaults to the "
+                       "directory of the suite", [](const char* arg) { contracts_dir = arg; });
+      parser.AddOption('\0', "baseline", "FILE", "Compare the costs of the suite to the baseline in FILE and fail if "
+                       "one went up", [](const char* arg) { baseline_file = arg; });
+      parser.AddOption("update-baseline", "Write the costs of the suite to the baseline instead of comparing them",
+                       []() { update_baseline = true; });
+      parser.AddOption("allow-missing", "Do not fail on actions missing from the baseline, e.g. when adding them to the "
+                       "suite", []() { allow_missing = true; });
+      parser.AddOption('\0', "tolerance", "PERCENT", "Instructions may exceed the baseline by this much, defaults to 0",
+                       [](const char* arg) { tolerance = arg; });
+      parser.AddOption('\0', "compile", "FILE", "Translate the contract to C with wasm2c and compile it with $CC into "
+                       "the shared library FILE, which runs in place of the wasm file", [](const char* arg) { compile_file = arg; });
+      parser.AddArgument("filename", wabt::OptionParser::ArgumentCount::One,
+                         [](const char* arg) { wasm_file = arg; });
+      parser.Parse(argc, argv);
+   }
+
+   int compile() {
+      std::vector<uint8_t> code;
+      if (wabt::Failed(wabt::ReadFile(wasm_file, &code)))
+         return 1;
+      try {
+         compile_native(code, compile_file);
+      } catch (const std::exception& e) {
+         std::cerr << "eosio-run: " << e.what() << "\n";
+         return 1;
+      }
+      return 0;
+   }
+
+   int run_suite() {
+      try {
+         if (contracts_dir.empty()) {
+            const auto slash = wasm_file.find_last_of('/');
+            contracts_dir = slash == std::string::npos ? "." : wasm_file.substr(0, slash);
+         }
+         cost_suite suite(wasm_file, contracts_dir);
+         const auto results = suite.run();
+         if (update_baseline) {
+            if (baseline_file.empty())
+               throw std::invalid_argument("--update-baseline needs --baseline");
+            write_baseline(results, baseline_file);
+         }
+         const std::string baseline = update_baseline ? std::string() : baseline_file;
+         return write_report(results, baseline, std::stod(tolerance), allow_missing, std::cout) ? 0 : 1;
+      } catch (const std::exception& e) {
+         std::cerr << "eosio-run: " << e.what() << "\n";
+         return 1;
+      }
+   }
+}
+
+int main( int argc, char** argv ) {
+   parse_options(argc, argv);
+   if (suite_mode)
+      return run_suite();
+   if (!compile_file.empty())
+      return compile();
+
+   apply_context ctx;
+   action act;
+   try {
+      act.account = string_to_name(receiver);
+      act.name    = string_to_name(action_name);
+      act.data    = from_hex(data_hex);
+      for (const auto& auth : auths)
+         act.authorization.push_back(string_to_permission_level(auth));
+      ctx.time_us = time_us.empty() ? std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch()).count()
+                                    : std::stoull(time_us);
+   } catch (const std::exception& e) {
+      std::cerr << "eosio-run: " << e.what() << "\n";
+      return 1;
+   }
+
+   ctx.accounts.insert(act.account);
+   for (const auto& auth : act.authorization)
+      ctx.accounts.insert(auth.actor);
+   for (const auto& account : accounts)
+      ctx.accounts.insert(string_to_name(account));
+   ctx.start_action(act.account, act);
+
+   std::unique_ptr<engine> contract;
+   std::unique_ptr<profiler> prof;
+   try {
+      contract = load_contract(wasm_file);
+   } catch (const std::exception& e) {
+      std::cerr << "eosio-run: " << e.what() << "\n";
+      return 1;
+   }
+   auto* interp = dynamic_cast<interpreter*>(contract.get());
+   if (!profile_file.empty() || !profile_host_file.empty()) {
+      if (!interp) {
+         std::cerr << "eosio-run: profiling needs the wasm file of the contract\n";
+         return 1;
+      }
+      prof = std::make_unique<profiler>(interp->code());
+   }
+
+   bool success = true;
+   std::string error;
+   try {
+      if (prof)
+         interp->apply(ctx, prof.get());
+      else
+         contract->apply(ctx);
+   } catch (const action_failure& e) {
+      success = false;
+      error   = e.what();
+   }
+
+   std::cout << ctx.console;
+   if (!ctx.console.empty() && ctx.console.back() != '\n')
+      std::cout << "\n";
+   for (uint64_t recipient : ctx.notified)
+      std::cout << "notified: " << name_to_string(recipient) << "\n";
+   for (const auto& inline_act : ctx.inline_actions)
+      std::cout << "inline action: " << inline_act.to_string() << "\n";
+   for (const auto& inline_act : ctx.context_free_inline_actions)
+      std::cout << "context free inline action: " << inline_act.to_string() << "\n";
+
+   if (prof) {
+      if (!write_profile(profile_file, [&](std::ostream& os) { prof->write_folded_instructions(os); }) ||
+          !write_profile(profile_host_file, [&](std::ostream& os) { prof->write_folded_host_time(os); }))
+         return 1;
+      std::cout << "profile: ";
+      prof->write_summary(std::cout);
+   }
+
+   if (!success) {
+      std::cout << "error: " << error << "\n";
+      return 1;
+   }
+   std::cout << "success\n";
+   return 0;
+}
@@ -0,0 +1,236 @@
+#include "interpreter.hpp"
+#include "intrinsics.hpp"
+#include "profiler.hpp"
+
+#include <src/binary-reader-interp.h>
+#include <src/binary-reader.h>
+#include <src/cast.h>
+#include <src/error-handler.h>
+#include <src/interp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <optional>
+
+namespace eosio { namespace cdt {
+
+   namespace {
+      using namespace wabt;
+      using namespace wabt::interp;
+
+      struct session;
+
+      // what a host function of the environment calls into
+      struct host_binding {
+         session*           s;
+         const std::string* name;
+         const intrinsic*   fn;
+         uint32_t           func_index;
+         uint64_t           calls = 0;
+      };
+
+      struct session {
+         apply_context&             ctx;
+         profiler*                  prof;
+         Environment                env;
+         Index                      memory_index = kInvalidIndex;
+         std::deque<host_binding>   bindings;
+         std::optional<std::string> error;  ///< why the contract failed, if an intrinsic failed it
+         bool                       exited = false;
+
+         session( apply_context& ctx, profiler* prof ) : ctx(ctx), prof(prof) {}
+
+         void bind_memory() {
+            if (memory_index == kInvalidIndex) {
+               ctx.memory = wasm_memory{};
+            } else {
+               auto& data = env.GetMemory(memory_index)->data;
+               ctx.memory = wasm_memory{data.data(), data.size()};
+            }
+         }
+      };
+
+      Type to_wabt_type( value_type type ) {
+         switch (type) {
+            case value_type::i32: return Type::I32;
+            case value_type::i64: return Type::I64;
+            case value_type::f32: return Type::F32;
+            case value_type::f64: return Type::F64;
+         }
+         return Type::Void;
+      }
+
+      bool signature_matches( const intrinsic& fn, const FuncSignature& sig ) {
+         auto same = [](const std::vector<value_type>& ours, const std::vector<Type>& theirs) {
+            if (ours.size() != theirs.size())
+               return false;
+            for (size_t i = 0; i < ours.size(); i++)
+               if (to_wabt_type(ours[i]) != theirs[i])
+                  return false;
+            return true;
+         };
+         return same(fn.params, sig.param_types) && same(fn.results, sig.result_types);
+      }
+
+      // only the traps a contract compiled with wasm2c can tell apart, so both engines fail with the same message
+      std::string trap_to_string( interp::Result result ) {
+         switch (result) {
+            case interp::Result::TrapValueStackExhausted:
+               return ResultToString(interp::Result::TrapCallStackExhausted);
+            case interp::Result::TrapUndefinedTableIndex:
+            case interp::Result::TrapUninitializedTableElement:
+            case interp::Result::TrapIndirectCallSignatureMismatch:
+               return "invalid indirect call";
+            default:
+               return ResultToString(result);
+         }
+      }
+
+      interp::Result call_intrinsic( const HostFunc*, const FuncSignature* sig, Index num_args, TypedValue* args,
+                                     Index num_results, TypedValue* out_results, void* user_data ) {
+         auto& binding = *static_cast<host_binding*>(user_data);
+         session& s = *binding.s;
+         binding.calls++;
+         if (!binding.fn->implemented()) {
+            s.error = "intrinsic " + *binding.name + " is not supported by eosio-run";
+            return interp::Result::TrapHostTrapped;
+         }
+
+         // ImportFunc bounds the parameters of every import
+         uint64_t raw_args[max_intrinsic_params];
+         for (Index i = 0; i < num_args; i++) {
+            switch (args[i].type) {
+               case Type::I32: raw_args[i] = args[i].value.i32; break;
+               case Type::I64: raw_args[i] = args[i].value.i64; break;
+               case Type::F32: raw_args[i] = args[i].value.f32_bits; break;
+               default:        raw_args[i] = args[i].value.f64_bits; break;
+            }
+         }
+
+         // wabt is built without exceptions, they must not leave this function
+         const auto start = std::chrono::steady_clock::now();
+         auto result = interp::Result::Ok;
+         uint64_t ret = 0;
+         try {
+            s.bind_memory();
+            ret = binding.fn->call(s.ctx, raw_args);
+         } catch (const action_failure& e) {
+            s.error = e.what();
+            result = interp::Result::TrapHostTrapped;
+         } catch (const action_exit&) {
+            s.exited = true;
+            result = interp::Result::TrapHostTrapped;
+         }
+         if (s.prof)
+            s.prof->host_call(binding.func_index, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                     std::chrono::steady_clock::now() - start).count());
+         if (result != interp::Result::Ok)
+            return result;
+
+         if (num_results) {
+            out_results[0].type = sig->result_types[0];
+            switch (out_results[0].type) {
+               case Type::I32: out_results[0].value.i32 = uint32_t(ret); break;
+               case Type::I64: out_results[0].value.i64 = ret; break;
+               case Type::F32: out_results[0].value.f32_bits = uint32_t(ret); break;
+               default:        out_results[0].value.f64_bits = ret; break;
+            }
+         }
+         return interp::Result::Ok;
+      }
+
+      class import_delegate : public HostImportDelegate {
+         public:
+            explicit import_delegate( session& s ) : _session(s) {}
+
+            wabt::Result ImportFunc( FuncImport* import, Func* func, FuncSignature* sig,
+                                     const ErrorCallback& callback ) override {
+               const auto& table = intrinsics();
+               auto itr = table.find(import->field_name);
+               if (itr == table.end()) {
+                  callback(("unresolvable import env." + import->field_name).c_str());
+                  return wabt::Result::Error;
+               }
+               if (sig->param_types.size() > max_intrinsic_params) {
+                  callback(("import env." + import->field_name + " has too many parameters").c_str());
+                  return wabt::Result::Error;
+               }
+               // the signature of an intrinsic eosio-run does not implement is unknown, calling it traps anyway
+               if (itr->second.implemented() && !signature_matches(itr->second, *sig)) {
+                  callback(("import env." + import->field_name + " has the wrong signature").c_str());
+                  return wabt::Result::Error;
+               }
+               // the environment index of the host function, which the profiler keys functions by
+               _session.bindings.push_back({&_session, &itr->first, &itr->second, _session.env.GetFuncCount() - 1});
+               auto* host = cast<HostFunc>(func);
+               host->callback  = call_intrinsic;
+               host->user_data = &_session.bindings.back();
+               return wabt::Result::Ok;
+            }
+
+            wabt::Result ImportTable( TableImport*, Table*, const ErrorCallback& callback ) override {
+               callback("contracts can only import functions");
+               return wabt::Result::Error;
+            }
+
+            wabt::Result ImportMemory( MemoryImport*, Memory*, const ErrorCallback& callback ) override {
+               callback("contracts can only import functions");
+               return wabt::Result::Error;
+            }
+
+            wabt::Result ImportGlobal( GlobalImport*, Global*, const ErrorCallback& callback ) override {
+               callback("contracts can only import functions");
+               return wabt::Result::Error;
+            }
+
+         private:
+            session& _session;
+      };
+   }
+
+   void interpreter::apply( apply_context& ctx, profiler* prof, apply_stats* stats ) {
+      session s(ctx, prof);
+      s.env.AppendHostModule("env")->import_delegate.reset(new import_delegate(s));
+
+      ErrorHandlerBuffer errors(Location::Type::Binary);
+      const ReadBinaryOptions options(Features{}, nullptr, false, true, false);
+      DefinedModule* module = nullptr;
+      if (Failed(ReadBinaryInterp(&s.env, _code.data(), _code.size(), &options, &errors, &module)))
+         fail("unable to instantiate the contract: " + errors.buffer().substr(0, errors.buffer().find_last_not_of('\n') + 1));
+      s.memory_index = module->memory_index;
+
+      Executor executor(&s.env);
+      if (prof) {
+         prof->start(s.env);
+         executor.set_observer(prof);
+      }
+      ExecResult result = executor.RunStartFunction(module);
+      if (result.result == interp::Result::Ok) {
+         TypedValues apply_args(3, TypedValue(Type::I64));
+         apply_args[0].value.i64 = ctx.receiver;
+         apply_args[1].value.i64 = ctx.act.account;
+         apply_args[2].value.i64 = ctx.act.name;
+         result = executor.RunExportByName(module, "apply", apply_args);
+      }
+      // the memory goes away with the session
+      ctx.memory = wasm_memory{};
+
+      if (stats) {
+         stats->instructions += executor.instruction_count();
+         if (s.memory_index != kInvalidIndex)
+            stats->memory_pages = std::max<uint32_t>(stats->memory_pages,
+                                                     s.env.GetMemory(s.memory_index)->data.size() / WABT_PAGE_SIZE);
+         for (const auto& binding : s.bindings)
+            if (binding.calls)
+               stats->intrinsic_calls[*binding.name] += binding.calls;
+      }
+
+      if (result.result == interp::Result::Ok || s.exited)
+         return;
+      if (s.error)
+         fail(*s.error);
+      fail("wasm trap: " + trap_to_string(result.result));
+   }
+
+}} //ns eosio::cdt
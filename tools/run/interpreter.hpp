@@ -0,0 +1,34 @@
+#pragma once
+#include "engine.hpp"
+
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   class profiler;
+
+   /**
+    * Runs contracts on the wabt interpreter
+    *
+    * Every call to apply() instantiates the module again, so globals and linear memory start out fresh like
+    * they do for each action in nodeos. The contract may only import functions of the "env" module which are
+    * listed in eosio.imports, anything else fails the action when it is instantiated.
+    */
+   class interpreter : public engine {
+      public:
+         explicit interpreter( std::vector<uint8_t> code ) : _code(std::move(code)) {}
+
+         void apply( apply_context& ctx, apply_stats* stats = nullptr ) override { apply(ctx, nullptr, stats); }
+
+         /**
+          * apply() recording the execution in `prof`, profiling slows the interpreter down a little
+          */
+         void apply( apply_context& ctx, profiler* prof, apply_stats* stats = nullptr );
+
+         const std::vector<uint8_t>& code()const { return _code; }
+
+      private:
+         std::vector<uint8_t> _code;
+   };
+
+}} //ns eosio::cdt
@@ -0,0 +1,653 @@
+#include "intrinsics.hpp"
+
+#include <native/crypto.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace eosio { namespace cdt {
+
+   namespace {
+      using native::database;
+
+      class registry {
+         public:
+            template <typename F>
+            void add( const std::string& name, F fn ) { _intrinsics[name] = make_intrinsic(+fn); }
+
+            void unimplemented( std::initializer_list<const char*> names ) {
+               for (const char* name : names)
+                  _intrinsics[name] = intrinsic{};
+            }
+
+            std::map<std::string, intrinsic> release() { return std::move(_intrinsics); }
+
+         private:
+            std::map<std::string, intrinsic> _intrinsics;
+      };
+
+      template <typename T>
+      std::string to_decimal( T value ) {
+         using unsigned_type = std::make_unsigned_t<T>;
+         const bool negative = value < 0;
+         unsigned_type v = negative ? unsigned_type(0) - unsigned_type(value) : unsigned_type(value);
+         char buffer[64];
+         char* pos = buffer + sizeof(buffer);
+         do {
+            *--pos = '0' + char(v % 10);
+            v /= 10;
+         } while (v != 0);
+         if (negative)
+            *--pos = '-';
+         return std::string(pos, buffer + sizeof(buffer) - pos);
+      }
+
+      // nodeos prints floats in scientific notation with digits10 digits after the point
+      template <typename T>
+      std::string to_scientific( T value ) {
+         char buffer[64];
+         const int len = snprintf(buffer, sizeof(buffer), "%.*Le", std::numeric_limits<T>::digits10, (long double)value);
+         return std::string(buffer, len);
+      }
+
+      uint128_t load_u128( const apply_context& ctx, uint32_t ptr ) { return ctx.memory.load<uint128_t>(ptr); }
+      uint128_t make_u128( uint64_t low, uint64_t high ) { return uint128_t(high) << 64 | low; }
+      int128_t  make_i128( uint64_t low, uint64_t high ) { return int128_t(make_u128(low, high)); }
+
+      template <typename Checksum>
+      void hash_into( apply_context& ctx, void (*hash)(const char*, uint32_t, Checksum*), uint32_t data, uint32_t len,
+                      uint32_t out ) {
+         Checksum result;
+         hash(ctx.memory.bytes(data, len), len, &result);
+         memcpy(ctx.memory.bytes(out, sizeof(result.hash)), result.hash, sizeof(result.hash));
+      }
+
+      template <typename Checksum>
+      void assert_hash( apply_context& ctx, void (*hash)(const char*, uint32_t, Checksum*), uint32_t data, uint32_t len,
+                        uint32_t expected ) {
+         Checksum result;
+         hash(ctx.memory.bytes(data, len), len, &result);
+         if (memcmp(result.hash, ctx.memory.bytes(expected, sizeof(result.hash)), sizeof(result.hash)) != 0)
+            fail("hash mismatch");
+      }
+
+      int32_t recover( apply_context& ctx, uint32_t digest, uint32_t sig, uint32_t siglen, char (&pub)[34] ) {
+         capi_checksum256 d;
+         memcpy(d.hash, ctx.memory.bytes(digest, sizeof(d.hash)), sizeof(d.hash));
+         return native::crypto::recover_key(&d, ctx.memory.bytes(sig, siglen), siglen, pub, sizeof(pub));
+      }
+
+      /**
+       * Access to one secondary index type of the context and its keys in contract memory
+       */
+      struct idx64_traits {
+         using key_type = uint64_t;
+         static auto& index( apply_context& ctx ) { return ctx.db.idx64; }
+         static key_type load( const apply_context& ctx, uint32_t ptr ) { return ctx.memory.load<key_type>(ptr); }
+         static void store( const apply_context& ctx, uint32_t ptr, const key_type& key ) { ctx.memory.store(ptr, key); }
+      };
+
+      struct idx128_traits {
+         using key_type = uint128_t;
+         static auto& index( apply_context& ctx ) { return ctx.db.idx128; }
+         static key_type load( const apply_context& ctx, uint32_t ptr ) { return ctx.memory.load<key_type>(ptr); }
+         static void store( const apply_context& ctx, uint32_t ptr, const key_type& key ) { ctx.memory.store(ptr, key); }
+      };
+
+      struct idx_double_traits {
+         using key_type = double;
+         static auto& index( apply_context& ctx ) { return ctx.db.idx_double; }
+         static key_type load( const apply_context& ctx, uint32_t ptr ) { return ctx.memory.load<key_type>(ptr); }
+         static void store( const apply_context& ctx, uint32_t ptr, const key_type& key ) { ctx.memory.store(ptr, key); }
+      };
+
+      struct idx_long_double_traits {
+         using key_type = float128_key;
+         static auto& index( apply_context& ctx ) { return ctx.idx_long_double; }
+         static key_type load( const apply_context& ctx, uint32_t ptr ) {
+            key_type key{ctx.memory.load<uint64_t>(ptr), ctx.memory.load<uint64_t>(ptr + 8)};
+            if (key.is_nan())
+               fail("NaN is not an allowed value for a secondary key");
+            return key;
+         }
+         static void store( const apply_context& ctx, uint32_t ptr, const key_type& key ) {
+            ctx.memory.store(ptr, key.low);
+            ctx.memory.store(ptr + 8, key.high);
+         }
+      };
+
+      // db_idx256_* pass the key as an array of two uint128_t and its length
+      database::idx256_key load_idx256( const apply_context& ctx, uint32_t ptr, uint32_t len ) {
+         if (len != 2)
+            fail("invalid size of secondary key array for idx256: given " + std::to_string(len) + " bytes but expected 2");
+         return {ctx.memory.load<uint128_t>(ptr), ctx.memory.load<uint128_t>(ptr + 16)};
+      }
+
+      void store_idx256( const apply_context& ctx, uint32_t ptr, const database::idx256_key& key ) {
+         ctx.memory.store(ptr, key[0]);
+         ctx.memory.store(ptr + 16, key[1]);
+      }
+
+      template <typename Traits>
+      void add_secondary_index( registry& r, const std::string& prefix ) {
+         r.add(prefix + "_store", [](apply_context& ctx, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, uint32_t secondary) {
+               return Traits::index(ctx).store(ctx.receiver, scope, table, payer, id, Traits::load(ctx, secondary));
+            });
+         r.add(prefix + "_remove", [](apply_context& ctx, int32_t iterator) {
+               Traits::index(ctx).remove(ctx.receiver, iterator);
+            });
+         r.add(prefix + "_update", [](apply_context& ctx, int32_t iterator, uint64_t payer, uint32_t secondary) {
+               Traits::index(ctx).update(ctx.receiver, iterator, payer, Traits::load(ctx, secondary));
+            });
+         r.add(prefix + "_find_primary", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t secondary, uint64_t primary) {
+               typename Traits::key_type key{};
+               const int32_t itr = Traits::index(ctx).find_primary(code, scope, table, key, primary);
+               if (itr >= 0)
+                  Traits::store(ctx, secondary, key);
+               return itr;
+            });
+         r.add(prefix + "_find_secondary", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t secondary, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = Traits::index(ctx).find_secondary(code, scope, table, Traits::load(ctx, secondary), pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add(prefix + "_lowerbound", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t secondary, uint32_t primary) {
+               auto key = Traits::load(ctx, secondary);
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = Traits::index(ctx).lowerbound(code, scope, table, key, pk);
+               Traits::store(ctx, secondary, key);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add(prefix + "_upperbound", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t secondary, uint32_t primary) {
+               auto key = Traits::load(ctx, secondary);
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = Traits::index(ctx).upperbound(code, scope, table, key, pk);
+               Traits::store(ctx, secondary, key);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add(prefix + "_end", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table) {
+               return Traits::index(ctx).end(code, scope, table);
+            });
+         r.add(prefix + "_next", [](apply_context& ctx, int32_t iterator, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = Traits::index(ctx).next(iterator, pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add(prefix + "_previous", [](apply_context& ctx, int32_t iterator, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = Traits::index(ctx).previous(iterator, pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+      }
+
+      void add_database( registry& r ) {
+         r.add("db_store_i64", [](apply_context& ctx, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, uint32_t data, uint32_t len) {
+               return ctx.db.store_i64(ctx.receiver, scope, table, payer, id, ctx.memory.bytes(data, len), len);
+            });
+         r.add("db_update_i64", [](apply_context& ctx, int32_t iterator, uint64_t payer, uint32_t data, uint32_t len) {
+               ctx.db.update_i64(ctx.receiver, iterator, payer, ctx.memory.bytes(data, len), len);
+            });
+         r.add("db_remove_i64", [](apply_context& ctx, int32_t iterator) {
+               ctx.db.remove_i64(ctx.receiver, iterator);
+            });
+         r.add("db_get_i64", [](apply_context& ctx, int32_t iterator, uint32_t data, uint32_t len) {
+               return ctx.db.get_i64(iterator, ctx.memory.bytes(data, len), len);
+            });
+         r.add("db_next_i64", [](apply_context& ctx, int32_t iterator, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.next_i64(iterator, pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add("db_previous_i64", [](apply_context& ctx, int32_t iterator, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.previous_i64(iterator, pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add("db_find_i64", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+               return ctx.db.find_i64(code, scope, table, id);
+            });
+         r.add("db_lowerbound_i64", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+               return ctx.db.lowerbound_i64(code, scope, table, id);
+            });
+         r.add("db_upperbound_i64", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+               return ctx.db.upperbound_i64(code, scope, table, id);
+            });
+         r.add("db_end_i64", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table) {
+               return ctx.db.end_i64(code, scope, table);
+            });
+
+         add_secondary_index<idx64_traits>(r, "db_idx64");
+         add_secondary_index<idx128_traits>(r, "db_idx128");
+         add_secondary_index<idx_double_traits>(r, "db_idx_double");
+         add_secondary_index<idx_long_double_traits>(r, "db_idx_long_double");
+
+         r.add("db_idx256_store", [](apply_context& ctx, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, uint32_t data, uint32_t len) {
+               return ctx.db.idx256.store(ctx.receiver, scope, table, payer, id, load_idx256(ctx, data, len));
+            });
+         r.add("db_idx256_remove", [](apply_context& ctx, int32_t iterator) {
+               ctx.db.idx256.remove(ctx.receiver, iterator);
+            });
+         r.add("db_idx256_update", [](apply_context& ctx, int32_t iterator, uint64_t payer, uint32_t data, uint32_t len) {
+               ctx.db.idx256.update(ctx.receiver, iterator, payer, load_idx256(ctx, data, len));
+            });
+         r.add("db_idx256_find_primary", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t data, uint32_t len, uint64_t primary) {
+               load_idx256(ctx, data, len);
+               database::idx256_key key{};
+               const int32_t itr = ctx.db.idx256.find_primary(code, scope, table, key, primary);
+               if (itr >= 0)
+                  store_idx256(ctx, data, key);
+               return itr;
+            });
+         r.add("db_idx256_find_secondary", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t data, uint32_t len, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.idx256.find_secondary(code, scope, table, load_idx256(ctx, data, len), pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add("db_idx256_lowerbound", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t data, uint32_t len, uint32_t primary) {
+               auto key = load_idx256(ctx, data, len);
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.idx256.lowerbound(code, scope, table, key, pk);
+               store_idx256(ctx, data, key);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add("db_idx256_upperbound", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table, uint32_t data, uint32_t len, uint32_t primary) {
+               auto key = load_idx256(ctx, data, len);
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.idx256.upperbound(code, scope, table, key, pk);
+               store_idx256(ctx, data, key);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add("db_idx256_end", [](apply_context& ctx, uint64_t code, uint64_t scope, uint64_t table) {
+               return ctx.db.idx256.end(code, scope, table);
+            });
+         r.add("db_idx256_next", [](apply_context& ctx, int32_t iterator, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.idx256.next(iterator, pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+         r.add("db_idx256_previous", [](apply_context& ctx, int32_t iterator, uint32_t primary) {
+               uint64_t pk = ctx.memory.load<uint64_t>(primary);
+               const int32_t itr = ctx.db.idx256.previous(iterator, pk);
+               ctx.memory.store(primary, pk);
+               return itr;
+            });
+      }
+
+      void add_action_and_system( registry& r ) {
+         r.add("read_action_data", [](apply_context& ctx, uint32_t data, uint32_t len) {
+               const uint32_t size = ctx.act.data.size();
+               if (len == 0)
+                  return int32_t(size);
+               const uint32_t copy_size = std::min(len, size);
+               memcpy(ctx.memory.bytes(data, copy_size), ctx.act.data.data(), copy_size);
+               return int32_t(copy_size);
+            });
+         r.add("action_data_size", [](apply_context& ctx) { return int32_t(ctx.act.data.size()); });
+         r.add("current_receiver", [](apply_context& ctx) { return ctx.receiver; });
+         r.add("is_inline", [](apply_context& ctx) { return int32_t(ctx.depth > 0); });
+         r.add("require_auth", [](apply_context& ctx, uint64_t account) { ctx.require_auth(account); });
+         r.add("require_auth2", [](apply_context& ctx, uint64_t account, uint64_t permission) {
+               ctx.require_auth(account, permission);
+            });
+         r.add("has_auth", [](apply_context& ctx, uint64_t account) { return int32_t(ctx.has_auth(account)); });
+         r.add("require_recipient", [](apply_context& ctx, uint64_t recipient) { ctx.require_recipient(recipient); });
+         r.add("is_account", [](apply_context& ctx, uint64_t account) { return int32_t(ctx.is_account(account)); });
+         r.add("send_inline", [](apply_context& ctx, uint32_t data, uint32_t len) {
+               ctx.inline_actions.push_back(action::unpack(ctx.memory.bytes(data, len), len));
+            });
+         r.add("send_context_free_inline", [](apply_context& ctx, uint32_t data, uint32_t len) {
+               ctx.context_free_inline_actions.push_back(action::unpack(ctx.memory.bytes(data, len), len));
+            });
+         r.add("current_time", [](apply_context& ctx) { return ctx.time_us; });
+         r.add("publication_time", [](apply_context& ctx) { return ctx.time_us; });
+
+         r.add("eosio_assert", [](apply_context& ctx, uint32_t test, uint32_t msg) {
+               if (!test)
+                  fail(std::string("assertion failure with message: ") + ctx.memory.c_str(msg));
+            });
+         r.add("eosio_assert_message", [](apply_context& ctx, uint32_t test, uint32_t msg, uint32_t len) {
+               if (!test)
+                  fail("assertion failure with message: " + std::string(ctx.memory.bytes(msg, len), len));
+            });
+         r.add("eosio_assert_code", [](apply_context& ctx, uint32_t test, uint64_t code) {
+               if (!test)
+                  fail("assertion failure with error code: " + std::to_string(code));
+            });
+         r.add("eosio_exit", [](apply_context& ctx, int32_t code) { throw action_exit{}; });
+         r.add("abort", [](apply_context& ctx) { fail("abort() called"); });
+
+         r.unimplemented({"activate_feature", "is_feature_active", "get_resource_limits", "set_resource_limits",
+                          "set_minimum_resource_security", "set_proposed_producers", "get_blockchain_parameters_packed",
+                          "set_blockchain_parameters_packed", "is_privileged", "set_privileged", "update_blackwhitelist",
+                          "get_active_producers", "check_permission_authorization", "check_transaction_authorization",
+                          "cancel_deferred", "send_deferred", "expiration", "get_account_creation_time", "get_action",
+                          "get_action_sequence", "get_context_free_data", "get_permission_last_used",
+                          "get_transaction_id", "producer_random_seed", "random_seed", "read_transaction",
+                          "tapos_block_num", "tapos_block_prefix", "transaction_size"});
+      }
+
+      void add_print( registry& r ) {
+         r.add("prints", [](apply_context& ctx, uint32_t str) {
+               const char* s = ctx.memory.c_str(str);
+               ctx.print(s, strlen(s));
+            });
+         r.add("prints_l", [](apply_context& ctx, uint32_t str, uint32_t len) { ctx.print(ctx.memory.bytes(str, len), len); });
+         r.add("printi", [](apply_context& ctx, int64_t value) { ctx.console += to_decimal(value); });
+         r.add("printui", [](apply_context& ctx, uint64_t value) { ctx.console += to_decimal(value); });
+         r.add("printi128", [](apply_context& ctx, uint32_t value) {
+               ctx.console += to_decimal(int128_t(load_u128(ctx, value)));
+            });
+         r.add("printui128", [](apply_context& ctx, uint32_t value) { ctx.console += to_decimal(load_u128(ctx, value)); });
+         r.add("printsf", [](apply_context& ctx, float value) { ctx.console += to_scientific(value); });
+         r.add("printdf", [](apply_context& ctx, double value) { ctx.console += to_scientific(value); });
+#ifdef __SIZEOF_FLOAT128__
+         r.add("printqf", [](apply_context& ctx, uint32_t value) {
+               ctx.console += to_scientific<long double>(ctx.memory.load<__float128>(value));
+            });
+#else
+         r.unimplemented({"printqf"});
+#endif
+         r.add("printn", [](apply_context& ctx, uint64_t name) { ctx.console += name_to_string(name); });
+         r.add("printhex", [](apply_context& ctx, uint32_t data, uint32_t len) {
+               static const char* digits = "0123456789abcdef";
+               const char* bytes = ctx.memory.bytes(data, len);
+               for (uint32_t i = 0; i < len; i++) {
+                  ctx.console += digits[uint8_t(bytes[i]) >> 4];
+                  ctx.console += digits[uint8_t(bytes[i]) & 0xf];
+               }
+            });
+      }
+
+      void add_memory( registry& r ) {
+         r.add("memcpy", [](apply_context& ctx, uint32_t dest, uint32_t src, uint32_t len) {
+               if ((dest > src ? dest - src : src - dest) < len)
+                  fail("memcpy can only accept non-aliasing pointers");
+               memcpy(ctx.memory.bytes(dest, len), ctx.memory.bytes(src, len), len);
+               return dest;
+            });
+         r.add("memmove", [](apply_context& ctx, uint32_t dest, uint32_t src, uint32_t len) {
+               memmove(ctx.memory.bytes(dest, len), ctx.memory.bytes(src, len), len);
+               return dest;
+            });
+         r.add("memcmp", [](apply_context& ctx, uint32_t dest, uint32_t src, uint32_t len) {
+               const int ret = memcmp(ctx.memory.bytes(dest, len), ctx.memory.bytes(src, len), len);
+               return int32_t(ret < 0 ? -1 : ret > 0 ? 1 : 0);
+            });
+         r.add("memset", [](apply_context& ctx, uint32_t dest, int32_t value, uint32_t len) {
+               memset(ctx.memory.bytes(dest, len), value, len);
+               return dest;
+            });
+      }
+
+      void add_crypto( registry& r ) {
+         using namespace native;
+         r.add("sha1", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               hash_into(ctx, crypto::sha1, data, len, hash);
+            });
+         r.add("sha256", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               hash_into(ctx, crypto::sha256, data, len, hash);
+            });
+         r.add("sha512", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               hash_into(ctx, crypto::sha512, data, len, hash);
+            });
+         r.add("ripemd160", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               hash_into(ctx, crypto::ripemd160, data, len, hash);
+            });
+         r.add("assert_sha1", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               assert_hash(ctx, crypto::sha1, data, len, hash);
+            });
+         r.add("assert_sha256", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               assert_hash(ctx, crypto::sha256, data, len, hash);
+            });
+         r.add("assert_sha512", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               assert_hash(ctx, crypto::sha512, data, len, hash);
+            });
+         r.add("assert_ripemd160", [](apply_context& ctx, uint32_t data, uint32_t len, uint32_t hash) {
+               assert_hash(ctx, crypto::ripemd160, data, len, hash);
+            });
+         r.add("recover_key", [](apply_context& ctx, uint32_t digest, uint32_t sig, uint32_t siglen, uint32_t pub, uint32_t publen) {
+               char recovered[34];
+               const int32_t size = recover(ctx, digest, sig, siglen, recovered);
+               const uint32_t copy_size = std::min(publen, uint32_t(size));
+               memcpy(ctx.memory.bytes(pub, copy_size), recovered, copy_size);
+               return size;
+            });
+         r.add("assert_recover_key", [](apply_context& ctx, uint32_t digest, uint32_t sig, uint32_t siglen, uint32_t pub, uint32_t publen) {
+               char recovered[34];
+               recover(ctx, digest, sig, siglen, recovered);
+               if (publen != sizeof(recovered) || memcmp(recovered, ctx.memory.bytes(pub, publen), publen) != 0)
+                  fail("Error expected key different than recovered key");
+            });
+      }
+
+      template <typename Int, typename Float>
+      Int truncate( Float value, const char* op ) {
+         if (std::isnan(value))
+            fail(std::string("Error, ") + op + " unrepresentable");
+         // the bounds are exact powers of two, representable in every float type
+         const Float upper = std::is_signed<Int>::value ? -Float(std::numeric_limits<Int>::min()) : Float(std::numeric_limits<Int>::max()) + 1;
+         const Float lower = std::is_signed<Int>::value ? Float(std::numeric_limits<Int>::min()) : Float(-1);
+         if (value >= upper || (std::is_signed<Int>::value ? value < lower : value <= lower))
+            fail(std::string("Error, ") + op + " overflow");
+         return Int(value);
+      }
+
+      // wasm min and max: NaN if either operand is, and -0 < +0
+      template <typename Float>
+      Float wasm_min( Float a, Float b ) {
+         if (std::isnan(a) || std::isnan(b))
+            return std::numeric_limits<Float>::quiet_NaN();
+         if (a == 0 && b == 0)
+            return std::signbit(a) ? a : b;
+         return a < b ? a : b;
+      }
+
+      template <typename Float>
+      Float wasm_max( Float a, Float b ) {
+         if (std::isnan(a) || std::isnan(b))
+            return std::numeric_limits<Float>::quiet_NaN();
+         if (a == 0 && b == 0)
+            return std::signbit(a) ? b : a;
+         return a > b ? a : b;
+      }
+
+#define ADD_FLOAT_INTRINSICS(F, T) \
+      r.add("_eosio_" #F "_add", [](apply_context&, T a, T b) { return T(a + b); }); \
+      r.add("_eosio_" #F "_sub", [](apply_context&, T a, T b) { return T(a - b); }); \
+      r.add("_eosio_" #F "_mul", [](apply_context&, T a, T b) { return T(a * b); }); \
+      r.add("_eosio_" #F "_div", [](apply_context&, T a, T b) { return T(a / b); }); \
+      r.add("_eosio_" #F "_min", [](apply_context&, T a, T b) { return wasm_min(a, b); }); \
+      r.add("_eosio_" #F "_max", [](apply_context&, T a, T b) { return wasm_max(a, b); }); \
+      r.add("_eosio_" #F "_copysign", [](apply_context&, T a, T b) { return T(std::copysign(a, b)); }); \
+      r.add("_eosio_" #F "_abs", [](apply_context&, T a) { return T(std::fabs(a)); }); \
+      r.add("_eosio_" #F "_neg", [](apply_context&, T a) { return T(-a); }); \
+      r.add("_eosio_" #F "_sqrt", [](apply_context&, T a) { return T(std::sqrt(a)); }); \
+      r.add("_eosio_" #F "_ceil", [](apply_context&, T a) { return T(std::ceil(a)); }); \
+      r.add("_eosio_" #F "_floor", [](apply_context&, T a) { return T(std::floor(a)); }); \
+      r.add("_eosio_" #F "_trunc", [](apply_context&, T a) { return T(std::trunc(a)); }); \
+      r.add("_eosio_" #F "_nearest", [](apply_context&, T a) { return T(std::nearbyint(a)); }); \
+      r.add("_eosio_" #F "_eq", [](apply_context&, T a, T b) { return int32_t(a == b); }); \
+      r.add("_eosio_" #F "_ne", [](apply_context&, T a, T b) { return int32_t(a != b); }); \
+      r.add("_eosio_" #F "_lt", [](apply_context&, T a, T b) { return int32_t(a < b); }); \
+      r.add("_eosio_" #F "_le", [](apply_context&, T a, T b) { return int32_t(a <= b); }); \
+      r.add("_eosio_" #F "_gt", [](apply_context&, T a, T b) { return int32_t(a > b); }); \
+      r.add("_eosio_" #F "_ge", [](apply_context&, T a, T b) { return int32_t(a >= b); }); \
+      r.add("_eosio_" #F "_trunc_i32s", [](apply_context&, T a) { return truncate<int32_t>(a, #F ".convert_s/i32"); }); \
+      r.add("_eosio_" #F "_trunc_i32u", [](apply_context&, T a) { return truncate<uint32_t>(a, #F ".convert_u/i32"); }); \
+      r.add("_eosio_" #F "_trunc_i64s", [](apply_context&, T a) { return truncate<int64_t>(a, #F ".convert_s/i64"); }); \
+      r.add("_eosio_" #F "_trunc_i64u", [](apply_context&, T a) { return truncate<uint64_t>(a, #F ".convert_u/i64"); }); \
+      r.add("_eosio_i32_to_" #F, [](apply_context&, int32_t a) { return T(a); }); \
+      r.add("_eosio_i64_to_" #F, [](apply_context&, int64_t a) { return T(a); }); \
+      r.add("_eosio_ui32_to_" #F, [](apply_context&, uint32_t a) { return T(a); }); \
+      r.add("_eosio_ui64_to_" #F, [](apply_context&, uint64_t a) { return T(a); });
+
+      // the softfloat intrinsics eosio-cpp compiles float operations into
+      void add_softfloat( registry& r ) {
+         ADD_FLOAT_INTRINSICS(f32, float)
+         ADD_FLOAT_INTRINSICS(f64, double)
+         r.add("_eosio_f32_promote", [](apply_context&, float a) { return double(a); });
+         r.add("_eosio_f64_demote", [](apply_context&, double a) { return float(a); });
+      }
+
+#undef ADD_FLOAT_INTRINSICS
+
+      // 128 bit values are returned through a pointer to memory, the first argument
+      void add_compiler_builtins( registry& r ) {
+         r.add("__ashlti3", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high, uint32_t shift) {
+               ctx.memory.store(ret, shift >= 128 ? uint128_t(0) : make_u128(low, high) << shift);
+            });
+         r.add("__lshlti3", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high, uint32_t shift) {
+               ctx.memory.store(ret, shift >= 128 ? uint128_t(0) : make_u128(low, high) << shift);
+            });
+         r.add("__ashrti3", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high, uint32_t shift) {
+               const int128_t value = make_i128(low, high);
+               ctx.memory.store(ret, shift >= 128 ? (value < 0 ? int128_t(-1) : int128_t(0)) : value >> shift);
+            });
+         r.add("__lshrti3", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high, uint32_t shift) {
+               ctx.memory.store(ret, shift >= 128 ? uint128_t(0) : make_u128(low, high) >> shift);
+            });
+         r.add("__divti3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               const int128_t lhs = make_i128(la, ha);
+               const int128_t rhs = make_i128(lb, hb);
+               if (rhs == 0)
+                  fail("divide by zero");
+               // the only overflow, wraps around like the wasm code would
+               ctx.memory.store(ret, rhs == -1 ? int128_t(uint128_t(0) - uint128_t(lhs)) : lhs / rhs);
+            });
+         r.add("__udivti3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               const uint128_t rhs = make_u128(lb, hb);
+               if (rhs == 0)
+                  fail("divide by zero");
+               ctx.memory.store(ret, make_u128(la, ha) / rhs);
+            });
+         r.add("__modti3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               const int128_t lhs = make_i128(la, ha);
+               const int128_t rhs = make_i128(lb, hb);
+               if (rhs == 0)
+                  fail("divide by zero");
+               ctx.memory.store(ret, rhs == -1 ? int128_t(0) : lhs % rhs);
+            });
+         r.add("__umodti3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               const uint128_t rhs = make_u128(lb, hb);
+               if (rhs == 0)
+                  fail("divide by zero");
+               ctx.memory.store(ret, make_u128(la, ha) % rhs);
+            });
+         r.add("__multi3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               ctx.memory.store(ret, make_u128(la, ha) * make_u128(lb, hb));
+            });
+         r.add("__floattidf", [](apply_context&, uint64_t low, uint64_t high) { return double(make_i128(low, high)); });
+         r.add("__floatuntidf", [](apply_context&, uint64_t low, uint64_t high) { return double(make_u128(low, high)); });
+         r.add("__floatsidf", [](apply_context&, int32_t a) { return double(a); });
+         r.add("__fixsfti", [](apply_context& ctx, uint32_t ret, float a) { ctx.memory.store(ret, int128_t(a)); });
+         r.add("__fixdfti", [](apply_context& ctx, uint32_t ret, double a) { ctx.memory.store(ret, int128_t(a)); });
+         r.add("__fixunssfti", [](apply_context& ctx, uint32_t ret, float a) { ctx.memory.store(ret, uint128_t(a)); });
+         r.add("__fixunsdfti", [](apply_context& ctx, uint32_t ret, double a) { ctx.memory.store(ret, uint128_t(a)); });
+      }
+
+#ifdef __SIZEOF_FLOAT128__
+      __float128 make_f128( uint64_t low, uint64_t high ) {
+         const uint64_t words[2] = {low, high};
+         __float128 value;
+         memcpy(&value, words, sizeof(value));
+         return value;
+      }
+
+      // compiler-rt comparisons return `nan` for unordered operands, else -1, 0 or 1
+      int32_t compare_f128( uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb, int32_t nan ) {
+         const __float128 a = make_f128(la, ha);
+         const __float128 b = make_f128(lb, hb);
+         if (a != a || b != b)
+            return nan;
+         return a < b ? -1 : a == b ? 0 : 1;
+      }
+
+      // long double is binary128 in wasm, its operations are calls to compiler-rt
+      void add_float128_builtins( registry& r ) {
+         r.add("__addtf3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               ctx.memory.store(ret, make_f128(la, ha) + make_f128(lb, hb));
+            });
+         r.add("__subtf3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               ctx.memory.store(ret, make_f128(la, ha) - make_f128(lb, hb));
+            });
+         r.add("__multf3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               ctx.memory.store(ret, make_f128(la, ha) * make_f128(lb, hb));
+            });
+         r.add("__divtf3", [](apply_context& ctx, uint32_t ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               ctx.memory.store(ret, make_f128(la, ha) / make_f128(lb, hb));
+            });
+         r.add("__negtf2", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high) {
+               ctx.memory.store(ret, low);
+               ctx.memory.store(ret + 8, high ^ (uint64_t(1) << 63));
+            });
+         r.add("__eqtf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, 1); });
+         r.add("__netf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, 1); });
+         r.add("__getf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, -1); });
+         r.add("__gttf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, 0); });
+         r.add("__letf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, 1); });
+         r.add("__lttf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, 0); });
+         r.add("__cmptf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) { return compare_f128(la, ha, lb, hb, 1); });
+         r.add("__unordtf2", [](apply_context&, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+               const __float128 a = make_f128(la, ha);
+               const __float128 b = make_f128(lb, hb);
+               return int32_t(a != a || b != b);
+            });
+         r.add("__floatsitf", [](apply_context& ctx, uint32_t ret, int32_t a) { ctx.memory.store(ret, __float128(a)); });
+         r.add("__floatunsitf", [](apply_context& ctx, uint32_t ret, uint32_t a) { ctx.memory.store(ret, __float128(a)); });
+         r.add("__floatditf", [](apply_context& ctx, uint32_t ret, int64_t a) { ctx.memory.store(ret, __float128(a)); });
+         r.add("__floatunditf", [](apply_context& ctx, uint32_t ret, uint64_t a) { ctx.memory.store(ret, __float128(a)); });
+         r.add("__extendsftf2", [](apply_context& ctx, uint32_t ret, float a) { ctx.memory.store(ret, __float128(a)); });
+         r.add("__extenddftf2", [](apply_context& ctx, uint32_t ret, double a) { ctx.memory.store(ret, __float128(a)); });
+         r.add("__fixtfti", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high) {
+               ctx.memory.store(ret, int128_t(make_f128(low, high)));
+            });
+         r.add("__fixunstfti", [](apply_context& ctx, uint32_t ret, uint64_t low, uint64_t high) {
+               ctx.memory.store(ret, uint128_t(make_f128(low, high)));
+            });
+         r.add("__fixtfdi", [](apply_context&, uint64_t low, uint64_t high) { return int64_t(make_f128(low, high)); });
+         r.add("__fixtfsi", [](apply_context&, uint64_t low, uint64_t high) { return int32_t(make_f128(low, high)); });
+         r.add("__fixunstfdi", [](apply_context&, uint64_t low, uint64_t high) { return uint64_t(make_f128(low, high)); });
+         r.add("__fixunstfsi", [](apply_context&, uint64_t low, uint64_t high) { return uint32_t(make_f128(low, high)); });
+         r.add("__trunctfdf2", [](apply_context&, uint64_t low, uint64_t high) { return double(make_f128(low, high)); });
+         r.add("__trunctfsf2", [](apply_context&, uint64_t low, uint64_t high) { return float(make_f128(low, high)); });
+      }
+#else
+      void add_float128_builtins( registry& r ) {
+         r.unimplemented({"__addtf3", "__subtf3", "__multf3", "__divtf3", "__negtf2", "__eqtf2", "__netf2", "__getf2",
+                          "__gttf2", "__letf2", "__lttf2", "__cmptf2", "__unordtf2", "__floatsitf", "__floatunsitf",
+                          "__floatditf", "__floatunditf", "__extendsftf2", "__extenddftf2", "__fixtfti", "__fixunstfti",
+                          "__fixtfdi", "__fixtfsi", "__fixunstfdi", "__fixunstfsi", "__trunctfdf2", "__trunctfsf2"});
+      }
+#endif
+   }
+
+   const std::map<std::string, intrinsic>& intrinsics() {
+      static const std::map<std::string, intrinsic> table = [] {
+         registry r;
+         add_database(r);
+         add_action_and_system(r);
+         add_print(r);
+         add_memory(r);
+         add_crypto(r);
+         add_softfloat(r);
+         add_compiler_builtins(r);
+         add_float128_builtins(r);
+         return r.release();
+      }();
+      return table;
+   }
+
+}} //ns eosio::cdt
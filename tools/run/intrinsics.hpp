@@ -0,0 +1,106 @@
+#pragma once
+#include "apply_context.hpp"
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   enum class value_type : uint8_t { i32, i64, f32, f64 };
+
+   /// engines pass the arguments of an intrinsic in a buffer of this many values, imports with more are rejected
+   constexpr size_t max_intrinsic_params = 16;
+
+   /**
+    * A host function a contract can import from the "env" module
+    *
+    * Arguments and the result are passed as raw wasm values, integers zero extended and floats as their bits,
+    * so an engine only has to convert between its own value representation and uint64_t.
+    */
+   struct intrinsic {
+      std::vector<value_type> params;
+      std::vector<value_type> results;
+      /// empty for the intrinsics nodeos has and eosio-run does not, which trap when called
+      std::function<uint64_t(apply_context&, const uint64_t*)> call;
+
+      bool implemented()const { return bool(call); }
+   };
+
+   /**
+    * Every intrinsic of eosio.imports, by import name
+    */
+   const std::map<std::string, intrinsic>& intrinsics();
+
+   template <typename T>
+   struct wasm_type_of;
+   template <> struct wasm_type_of<int32_t>  { static constexpr value_type value = value_type::i32; };
+   template <> struct wasm_type_of<uint32_t> { static constexpr value_type value = value_type::i32; };
+   template <> struct wasm_type_of<int64_t>  { static constexpr value_type value = value_type::i64; };
+   template <> struct wasm_type_of<uint64_t> { static constexpr value_type value = value_type::i64; };
+   template <> struct wasm_type_of<float>    { static constexpr value_type value = value_type::f32; };
+   template <> struct wasm_type_of<double>   { static constexpr value_type value = value_type::f64; };
+
+   template <typename T>
+   T from_raw( uint64_t raw ) {
+      if constexpr (std::is_same<T, float>::value) {
+         const uint32_t bits = uint32_t(raw);
+         float f;
+         memcpy(&f, &bits, sizeof(f));
+         return f;
+      } else if constexpr (std::is_same<T, double>::value) {
+         double d;
+         memcpy(&d, &raw, sizeof(d));
+         return d;
+      } else {
+         return T(raw);
+      }
+   }
+
+   template <typename T>
+   uint64_t to_raw( T value ) {
+      if constexpr (std::is_same<T, float>::value) {
+         uint32_t bits;
+         memcpy(&bits, &value, sizeof(bits));
+         return bits;
+      } else if constexpr (std::is_same<T, double>::value) {
+         uint64_t bits;
+         memcpy(&bits, &value, sizeof(bits));
+         return bits;
+      } else {
+         return std::make_unsigned_t<T>(value);
+      }
+   }
+
+   template <typename R, typename... Args, size_t... I>
+   uint64_t invoke_intrinsic( R (*fn)(apply_context&, Args...), apply_context& ctx, const uint64_t* args,
+                              std::index_sequence<I...> ) {
+      if constexpr (std::is_void<R>::value) {
+         fn(ctx, from_raw<Args>(args[I])...);
+         return 0;
+      } else {
+         return to_raw(fn(ctx, from_raw<Args>(args[I])...));
+      }
+   }
+
+   /**
+    * Describe `fn` as an intrinsic, its wasm signature follows from the C++ one
+    */
+   template <typename R, typename... Args>
+   intrinsic make_intrinsic( R (*fn)(apply_context&, Args...) ) {
+      static_assert(sizeof...(Args) <= max_intrinsic_params, "intrinsic has too many parameters");
+      intrinsic i;
+      i.params = {wasm_type_of<Args>::value...};
+      if constexpr (!std::is_void<R>::value)
+         i.results = {wasm_type_of<R>::value};
+      i.call = [fn](apply_context& ctx, const uint64_t* args) {
+         return invoke_intrinsic(fn, ctx, args, std::index_sequence_for<Args...>{});
+      };
+      return i;
+   }
+
+}} //ns eosio::cdt
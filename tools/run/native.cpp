@@ -0,0 +1,451 @@
+#include "native.hpp"
+#include "intrinsics.hpp"
+#include "wasm_rt_source.hpp"
+
+#include <src/binary-reader-ir.h>
+#include <src/binary-reader.h>
+#include <src/c-writer.h>
+#include <src/cast.h>
+#include <src/error-handler.h>
+#include <src/generate-names.h>
+#include <src/apply-names.h>
+#include <src/ir.h>
+#include <src/stream.h>
+#include <src/validator.h>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+// The runtime wasm2c expects from the embedder, wasm-rt-impl.c of wabt without its memory leaks. Libraries built by
+// compile_native() resolve these against eosio-run when they are loaded.
+namespace {
+   struct func_type {
+      std::vector<wasm_rt_type_t> params;
+      std::vector<wasm_rt_type_t> results;
+
+      bool operator==( const func_type& other )const { return params == other.params && results == other.results; }
+   };
+
+   std::vector<func_type> func_types;
+   jmp_buf                trap_jump;
+   wasm_rt_trap_t         trap_code = WASM_RT_TRAP_NONE;
+
+   const uint32_t page_size = 65536;
+}
+
+extern "C" {
+   uint32_t wasm_rt_call_stack_depth;
+
+   void wasm_rt_trap( wasm_rt_trap_t code ) {
+      trap_code = code;
+      longjmp(trap_jump, 1);
+   }
+
+   uint32_t wasm_rt_register_func_type( uint32_t params, uint32_t results, ... ) {
+      func_type type;
+      va_list args;
+      va_start(args, results);
+      for (uint32_t i = 0; i < params; i++)
+         type.params.push_back(wasm_rt_type_t(va_arg(args, int)));
+      for (uint32_t i = 0; i < results; i++)
+         type.results.push_back(wasm_rt_type_t(va_arg(args, int)));
+      va_end(args);
+      for (size_t i = 0; i < func_types.size(); i++)
+         if (func_types[i] == type)
+            return i + 1;
+      func_types.push_back(std::move(type));
+      return func_types.size();
+   }
+
+   // init() allocates the memory and the table again for every action, what the last action left is dropped
+   void wasm_rt_allocate_memory( wasm_rt_memory_t* memory, uint32_t initial_pages, uint32_t max_pages ) {
+      free(memory->data);
+      memory->pages     = initial_pages;
+      memory->max_pages = max_pages;
+      memory->size      = initial_pages * page_size;
+      memory->data      = static_cast<uint8_t*>(calloc(memory->size, 1));
+   }
+
+   uint32_t wasm_rt_grow_memory( wasm_rt_memory_t* memory, uint32_t delta ) {
+      const uint32_t old_pages = memory->pages;
+      const uint64_t new_pages = uint64_t(old_pages) + delta;
+      if (new_pages > memory->max_pages)
+         return uint32_t(-1);
+      auto* data = static_cast<uint8_t*>(realloc(memory->data, new_pages * page_size));
+      if (!data)
+         return uint32_t(-1);
+      memset(data + memory->size, 0, uint64_t(delta) * page_size);
+      memory->data  = data;
+      memory->pages = new_pages;
+      memory->size  = new_pages * page_size;
+      return old_pages;
+   }
+
+   void wasm_rt_allocate_table( wasm_rt_table_t* table, uint32_t elements, uint32_t max_elements ) {
+      free(table->data);
+      table->size     = elements;
+      table->max_size = max_elements;
+      table->data     = static_cast<wasm_rt_elem_t*>(calloc(elements, sizeof(wasm_rt_elem_t)));
+   }
+}
+
+namespace eosio { namespace cdt {
+
+   namespace {
+      using namespace wabt;
+
+      // traps of the intrinsics, next to the ones of wasm2c
+      const wasm_rt_trap_t trap_host = wasm_rt_trap_t(WASM_RT_TRAP_EXHAUSTION + 1);
+
+      struct native_session {
+         apply_context&                                               ctx;
+         const std::vector<std::pair<std::string, const intrinsic*>>& imports;
+         native_contract::memory_fn                                   memory;
+         std::vector<uint64_t>                                        calls;
+         std::optional<std::string>                                   error;
+         bool                                                         exited = false;
+      };
+
+      uint64_t call_intrinsic( void* host, uint32_t import, const uint64_t* args ) {
+         auto& s = *static_cast<native_session*>(host);
+         s.calls[import]++;
+         const auto& binding = s.imports[import];
+         bool trapped = false;
+         uint64_t ret = 0;
+         // nothing with a destructor may be alive when wasm_rt_trap() jumps out of here
+         try {
+            if (!binding.second->implemented())
+               fail("intrinsic " + binding.first + " is not supported by eosio-run");
+            wasm_rt_memory_t* memory = s.memory();
+            s.ctx.memory = memory ? wasm_memory{reinterpret_cast<char*>(memory->data), memory->size} : wasm_memory{};
+            ret = binding.second->call(s.ctx, args);
+         } catch (const action_failure& e) {
+            s.error = e.what();
+            trapped = true;
+         } catch (const action_exit&) {
+            s.exited = true;
+            trapped = true;
+         }
+         if (trapped)
+            wasm_rt_trap(trap_host);
+         return ret;
+      }
+
+      // the C frames of the contract are left by longjmp, only trivial state may live in this frame
+      wasm_rt_trap_t run_apply( native_contract::apply_fn apply, native_session& s, uint64_t receiver, uint64_t code,
+                                uint64_t action ) {
+         wasm_rt_call_stack_depth = 0;
+         if (setjmp(trap_jump))
+            return trap_code;
+         apply(call_intrinsic, &s, receiver, code, action);
+         return WASM_RT_TRAP_NONE;
+      }
+
+      const char* trap_to_string( wasm_rt_trap_t trap ) {
+         switch (trap) {
+            case WASM_RT_TRAP_OOB:                return "out of bounds memory access";
+            case WASM_RT_TRAP_INT_OVERFLOW:       return "integer overflow";
+            case WASM_RT_TRAP_DIV_BY_ZERO:        return "integer divide by zero";
+            case WASM_RT_TRAP_INVALID_CONVERSION: return "invalid conversion to integer";
+            case WASM_RT_TRAP_UNREACHABLE:        return "unreachable executed";
+            case WASM_RT_TRAP_CALL_INDIRECT:      return "invalid indirect call";
+            case WASM_RT_TRAP_EXHAUSTION:         return "call stack exhausted";
+            default:                              return "host function trapped";
+         }
+      }
+
+      // the symbol names of c-writer.cc
+      std::string mangle_name( const std::string& name ) {
+         std::string mangled = "Z_";
+         for (char c : name) {
+            if ((isalnum(c) && c != 'Z') || c == '_') {
+               mangled += c;
+            } else {
+               char hex[4];
+               snprintf(hex, sizeof(hex), "Z%02X", uint8_t(c));
+               mangled += hex;
+            }
+         }
+         return mangled;
+      }
+
+      char mangle_type( Type type ) {
+         switch (type) {
+            case Type::I32: return 'i';
+            case Type::I64: return 'j';
+            case Type::F32: return 'f';
+            default:        return 'd';
+         }
+      }
+
+      std::string mangle_func_name( const std::string& name, const FuncSignature& sig ) {
+         std::string types;
+         for (const TypeVector* v : {&sig.result_types, &sig.param_types}) {
+            for (Type type : *v)
+               types += mangle_type(type);
+            if (v->empty())
+               types += 'v';
+         }
+         return mangle_name(name) + mangle_name(types);
+      }
+
+      const char* c_type( Type type ) {
+         switch (type) {
+            case Type::I32: return "u32";
+            case Type::I64: return "u64";
+            case Type::F32: return "f32";
+            default:        return "f64";
+         }
+      }
+
+      bool signature_matches( const intrinsic& fn, const FuncSignature& sig ) {
+         static const Type types[] = {Type::I32, Type::I64, Type::F32, Type::F64};
+         auto same = [](const std::vector<value_type>& ours, const TypeVector& theirs) {
+            if (ours.size() != theirs.size())
+               return false;
+            for (size_t i = 0; i < ours.size(); i++)
+               if (types[size_t(ours[i])] != theirs[i])
+                  return false;
+            return true;
+         };
+         return same(fn.params, sig.param_types) && same(fn.results, sig.result_types);
+      }
+
+      /*
+       * The glue between the C code of the contract and native_contract: every import is a function forwarding
+       * its arguments as raw values to the host, and the library exports the list of imports and the entry point.
+       */
+      std::string write_glue( const Module& module, const std::string& header, const std::string& memory ) {
+         std::ostringstream imports, thunks;
+         uint32_t count = 0;
+         for (const Import* import : module.imports) {
+            const auto* func_import = dyn_cast<FuncImport>(import);
+            if (!func_import)
+               continue;
+            const FuncSignature& sig = func_import->func.decl.sig;
+            const std::string result = sig.result_types.empty() ? "void" : c_type(sig.result_types[0]);
+            std::string params;
+            for (size_t i = 0; i < sig.param_types.size(); i++)
+               params += std::string(i ? ", " : "") + c_type(sig.param_types[i]) + " a" + std::to_string(i);
+
+            thunks << "static " << result << " import_" << count << "(" << (params.empty() ? "void" : params) << ") {\n";
+            // floats travel as their bits, like the interpreter passes them
+            thunks << "   uint64_t args[" << std::max<size_t>(sig.param_types.size(), 1) << "] = {0};\n";
+            for (size_t i = 0; i < sig.param_types.size(); i++) {
+               switch (sig.param_types[i]) {
+                  case Type::F32: thunks << "   { u32 bits; memcpy(&bits, &a" << i << ", 4); args[" << i << "] = bits; }\n"; break;
+                  case Type::F64: thunks << "   memcpy(&args[" << i << "], &a" << i << ", 8);\n"; break;
+                  default:        thunks << "   args[" << i << "] = a" << i << ";\n"; break;
+               }
+            }
+            thunks << "   " << (sig.result_types.empty() ? "" : "uint64_t ret = ") << "host_call(host, " << count
+                   << ", args);\n";
+            if (!sig.result_types.empty()) {
+               switch (sig.result_types[0]) {
+                  case Type::F32: thunks << "   { u32 bits = (u32)ret; f32 value; memcpy(&value, &bits, 4); return value; }\n"; break;
+                  case Type::F64: thunks << "   { f64 value; memcpy(&value, &ret, 8); return value; }\n"; break;
+                  default:        thunks << "   return (" << result << ")ret;\n"; break;
+               }
+            }
+            thunks << "}\n";
+            thunks << result << " (*" << mangle_name(func_import->module_name)
+                   << mangle_func_name(func_import->field_name, sig) << ")(";
+            for (size_t i = 0; i < sig.param_types.size(); i++)
+               thunks << (i ? ", " : "") << c_type(sig.param_types[i]);
+            thunks << (sig.param_types.empty() ? "void" : "") << ") = import_" << count << ";\n\n";
+
+            imports << "   \"" << func_import->field_name << "\",\n";
+            count++;
+         }
+
+         std::ostringstream glue;
+         glue << "#include <string.h>\n"
+              << "#include \"" << header << "\"\n\n"
+              << "#define EXPORT __attribute__((visibility(\"default\")))\n\n"
+              << "typedef uint64_t (*host_call_fn)(void* host, uint32_t import, const uint64_t* args);\n"
+              << "static host_call_fn host_call;\n"
+              << "static void* host;\n\n"
+              << thunks.str()
+              << "EXPORT const char* const eosio_native_imports[] = {\n" << imports.str() << "   0\n};\n\n"
+              << "EXPORT wasm_rt_memory_t* eosio_native_memory(void) {\n"
+              << "   return " << (memory.empty() ? "0" : memory) << ";\n}\n\n"
+              << "EXPORT void eosio_native_apply(host_call_fn call, void* h, u64 receiver, u64 code, u64 action) {\n"
+              << "   host_call = call;\n"
+              << "   host = h;\n"
+              << "   init();\n"
+              << "   " << mangle_name("apply") << mangle_name("vjjj") << "(receiver, code, action);\n"
+              << "}\n";
+         return glue.str();
+      }
+
+      void write_file( const std::string& path, const std::string& content ) {
+         std::ofstream out(path);
+         out << content;
+         if (!out)
+            throw std::runtime_error("unable to write " + path);
+      }
+
+      std::string quote( const std::string& arg ) {
+         std::string quoted = "'";
+         for (char c : arg)
+            quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+         return quoted + "'";
+      }
+
+      // a directory for the generated sources, removed with everything in it when this goes away
+      struct temp_dir {
+         std::string              path;
+         std::vector<std::string> files;
+
+         temp_dir() {
+            const char* tmp = getenv("TMPDIR");
+            std::string pattern = std::string(tmp && *tmp ? tmp : "/tmp") + "/eosio-run.XXXXXX";
+            if (!mkdtemp(&pattern[0]))
+               throw std::runtime_error("unable to create a temporary directory");
+            path = pattern;
+         }
+         ~temp_dir() {
+            for (const auto& file : files)
+               unlink(file.c_str());
+            rmdir(path.c_str());
+         }
+         std::string file( const std::string& name ) {
+            files.push_back(path + "/" + name);
+            return files.back();
+         }
+      };
+   }
+
+   void compile_native( const std::vector<uint8_t>& code, const std::string& output ) {
+      Module module;
+      ErrorHandlerBuffer errors(Location::Type::Binary);
+      const ReadBinaryOptions options(Features{}, nullptr, true, true, true);
+      const ValidateOptions validate_options;
+      if (Failed(ReadBinaryIr("contract", code.data(), code.size(), &options, &errors, &module)) ||
+          Failed(ValidateModule(nullptr, &module, &errors, &validate_options)))
+         throw std::runtime_error("unable to read the contract: " +
+                                  errors.buffer().substr(0, errors.buffer().find_last_not_of('\n') + 1));
+
+      for (const Import* import : module.imports) {
+         const auto* func_import = dyn_cast<FuncImport>(import);
+         const auto& table = intrinsics();
+         auto itr = func_import && import->module_name == "env" ? table.find(import->field_name) : table.end();
+         if (itr == table.end())
+            throw std::runtime_error("unresolvable import " + import->module_name + "." + import->field_name);
+         if (itr->second.implemented() && !signature_matches(itr->second, func_import->func.decl.sig))
+            throw std::runtime_error("import env." + import->field_name + " has the wrong signature");
+      }
+
+      const Export* apply = module.GetExport("apply");
+      if (!apply || apply->kind != ExternalKind::Func || module.GetFunc(apply->var)->decl.sig.param_types !=
+                                                           TypeVector(3, Type::I64) ||
+          !module.GetFunc(apply->var)->decl.sig.result_types.empty())
+         throw std::runtime_error("the contract does not export apply(i64, i64, i64)");
+
+      // the host reaches the memory through an export, contracts linked without one get it added
+      std::string memory;
+      if (!module.memories.empty()) {
+         const Export* memory_export = nullptr;
+         for (const Export* e : module.exports)
+            if (e->kind == ExternalKind::Memory)
+               memory_export = e;
+         if (!memory_export) {
+            auto field = MakeUnique<ExportModuleField>();
+            field->export_.name = "eosio_native_memory";
+            field->export_.kind = ExternalKind::Memory;
+            field->export_.var  = Var(0);
+            memory_export = &field->export_;
+            module.AppendField(std::move(field));
+         }
+         memory = mangle_name(memory_export->name);
+      }
+
+      if (Failed(GenerateNames(&module)) || Failed(ApplyNames(&module)))
+         throw std::runtime_error("unable to name the functions of the contract");
+
+      temp_dir dir;
+      const std::string source = dir.file("contract.c");
+      const std::string header = dir.file("contract.h");
+      const std::string glue   = dir.file("glue.c");
+      write_file(dir.file("wasm-rt.h"), wasm_rt_source);
+      {
+         FileStream c_stream(source);
+         FileStream h_stream(header);
+         const WriteCOptions write_options;
+         if (Failed(WriteC(&c_stream, &h_stream, "contract.h", &module, &write_options)))
+            throw std::runtime_error("wasm2c was unable to translate the contract");
+      }
+      write_file(glue, write_glue(module, "contract.h", memory));
+
+      const char* cc = getenv("CC");
+      std::string command = quote(cc && *cc ? cc : "cc") + " -O2 -fPIC -shared -fvisibility=hidden -w";
+#ifdef __APPLE__
+      command += " -undefined dynamic_lookup";
+#endif
+      command += " -o " + quote(output) + " " + quote(source) + " " + quote(glue);
+      if (std::system(command.c_str()) != 0)
+         throw std::runtime_error("unable to compile the contract: " + command);
+   }
+
+   native_contract::native_contract( const std::string& library ) {
+      // RTLD_LOCAL keeps the symbols of libraries for different contracts apart, a path without a slash would be
+      // looked up in the library search path
+      const std::string path = library.find('/') == std::string::npos ? "./" + library : library;
+      _handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+      if (!_handle)
+         throw std::runtime_error("unable to load " + library + ": " + dlerror());
+      _apply       = reinterpret_cast<apply_fn>(dlsym(_handle, "eosio_native_apply"));
+      _memory      = reinterpret_cast<memory_fn>(dlsym(_handle, "eosio_native_memory"));
+      auto imports = static_cast<const char* const*>(dlsym(_handle, "eosio_native_imports"));
+      if (!_apply || !_memory || !imports) {
+         dlclose(_handle);
+         throw std::runtime_error(library + " is neither a wasm module nor a contract compiled by eosio-run");
+      }
+
+      // the names were checked when the library was built, against the intrinsics it was built with
+      const auto& table = intrinsics();
+      for (; *imports; ++imports) {
+         auto itr = table.find(*imports);
+         if (itr == table.end()) {
+            dlclose(_handle);
+            throw std::runtime_error(library + " imports the unknown intrinsic " + *imports);
+         }
+         _imports.emplace_back(itr->first, &itr->second);
+      }
+   }
+
+   native_contract::~native_contract() {
+      dlclose(_handle);
+   }
+
+   void native_contract::apply( apply_context& ctx, apply_stats* stats ) {
+      native_session s{ctx, _imports, _memory, std::vector<uint64_t>(_imports.size())};
+      const wasm_rt_trap_t trap = run_apply(_apply, s, ctx.receiver, ctx.act.account, ctx.act.name);
+      ctx.memory = wasm_memory{};
+
+      if (stats) {
+         if (wasm_rt_memory_t* memory = _memory())
+            stats->memory_pages = std::max(stats->memory_pages, memory->pages);
+         for (size_t i = 0; i < _imports.size(); i++)
+            if (s.calls[i])
+               stats->intrinsic_calls[_imports[i].first] += s.calls[i];
+      }
+
+      if (trap == WASM_RT_TRAP_NONE || s.exited)
+         return;
+      if (s.error)
+         fail(*s.error);
+      fail(std::string("wasm trap: ") + trap_to_string(trap));
+   }
+
+}} //ns eosio::cdt
@@ -0,0 +1,52 @@
+#pragma once
+#include "engine.hpp"
+
+#include <wasm2c/wasm-rt.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   struct intrinsic;
+
+   /**
+    * Translate the contract in `code` to C with wasm2c and build it into the shared library `output`
+    *
+    * The C compiler is $CC, or cc. The library does not contain the intrinsics, it calls back into the ones of
+    * the program loading it with native_contract. Throws std::runtime_error if the contract imports something
+    * eosio-run does not provide or the compiler fails.
+    */
+   void compile_native( const std::vector<uint8_t>& code, const std::string& output );
+
+   /**
+    * Runs a contract built by compile_native() at the speed of native code, for long simulation and fuzzing runs
+    *
+    * Behaves like the interpreter: each apply() starts from fresh globals and memory, traps and failing
+    * intrinsics fail the action. Native code counts no instructions, the stats only get the memory and the
+    * intrinsic calls.
+    */
+   class native_contract : public engine {
+      public:
+         explicit native_contract( const std::string& library );
+         ~native_contract();
+
+         native_contract( const native_contract& ) = delete;
+         native_contract& operator=( const native_contract& ) = delete;
+
+         void apply( apply_context& ctx, apply_stats* stats = nullptr ) override;
+
+         // the entry points of the library, see the glue code written by compile_native()
+         using host_call_fn = uint64_t (*)( void* host, uint32_t import, const uint64_t* args );
+         using apply_fn     = void (*)( host_call_fn call, void* host, uint64_t receiver, uint64_t code, uint64_t action );
+         using memory_fn    = wasm_rt_memory_t* (*)();
+
+      private:
+         void*                                                 _handle = nullptr;
+         apply_fn                                              _apply  = nullptr;
+         memory_fn                                             _memory = nullptr;
+         std::vector<std::pair<std::string, const intrinsic*>> _imports;
+   };
+
+}} //ns eosio::cdt
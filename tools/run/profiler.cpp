@@ -0,0 +1,201 @@
+#include "profiler.hpp"
+
+#include <src/binary-reader-nop.h>
+#include <src/binary-reader.h>
+#include <src/cast.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace eosio { namespace cdt {
+
+   namespace {
+      using namespace wabt;
+      using namespace wabt::interp;
+
+      class name_reader : public BinaryReaderNop {
+         public:
+            explicit name_reader( std::vector<std::string>& names ) : _names(names) {}
+
+            wabt::Result OnFunctionName( Index function_index, string_view function_name ) override {
+               if (function_index >= _names.size())
+                  _names.resize(function_index + 1);
+               _names[function_index] = function_name.to_string();
+               // ';' separates the frames of a folded stack
+               std::replace(_names[function_index].begin(), _names[function_index].end(), ';', ':');
+               return wabt::Result::Ok;
+            }
+
+         private:
+            std::vector<std::string>& _names;
+      };
+
+      struct function_stats {
+         uint64_t calls = 0;
+         uint64_t self  = 0;
+         uint64_t total = 0;
+         uint64_t host_ns = 0;
+      };
+   }
+
+   profiler::profiler( const std::vector<uint8_t>& code ) : _nodes(1) {
+      name_reader reader(_module_names);
+      const ReadBinaryOptions options(Features{}, nullptr, true, false, false);
+      // a module without a usable name section just has no names
+      ReadBinary(code.data(), code.size(), &reader, &options);
+   }
+
+   void profiler::start( Environment& env ) {
+      const auto* module = cast<DefinedModule>(env.GetLastModule());
+      const Index count = env.GetFuncCount();
+      // the name section uses the function indices of the module, everything else those of the environment
+      _names.assign(count, std::string());
+      for (Index i = 0; i < module->func_indexes.size() && i < _module_names.size(); i++)
+         _names[module->func_indexes[i]] = _module_names[i];
+      // without a name section exported functions are still known by their export name
+      for (const auto& e : module->exports)
+         if (e.kind == ExternalKind::Func && e.index < count && _names[e.index].empty())
+            _names[e.index] = e.name;
+      _is_host.assign(count, false);
+      for (Index i = 0; i < count; i++) {
+         Func* func = env.GetFunc(i);
+         if (auto* host = dyn_cast<HostFunc>(func)) {
+            _is_host[i] = true;
+            if (_names[i].empty())
+               _names[i] = host->field_name;
+         } else {
+            _offsets[cast<DefinedFunc>(func)->offset] = i;
+            if (_names[i].empty())
+               _names[i] = "func[" + std::to_string(i) + "]";
+         }
+      }
+   }
+
+   uint32_t profiler::child( uint32_t parent, uint32_t func ) {
+      auto itr = _nodes[parent].children.find(func);
+      if (itr != _nodes[parent].children.end())
+         return itr->second;
+      const uint32_t n = _nodes.size();
+      _nodes.push_back({func, parent});
+      _nodes[parent].children.emplace(func, n);
+      return n;
+   }
+
+   void profiler::charge( uint64_t instructions ) {
+      // instructions before the entry function belong to an earlier run of the thread
+      if (_current != 0)
+         _nodes[_current].instructions += instructions - _last;
+      _last = instructions;
+   }
+
+   void profiler::OnCall( IstreamOffset func_offset, uint64_t instructions ) {
+      charge(instructions);
+      _current = child(_current, _offsets.at(func_offset));
+      _nodes[_current].calls++;
+   }
+
+   void profiler::OnReturn( uint64_t instructions ) {
+      charge(instructions);
+      _current = _nodes[_current].parent;
+   }
+
+   void profiler::OnTrap( uint64_t instructions ) {
+      charge(instructions);
+      _current = 0;
+   }
+
+   void profiler::host_call( uint32_t func_index, uint64_t ns ) {
+      auto& n = _nodes[child(_current, func_index)];
+      n.calls++;
+      n.host_ns += ns;
+   }
+
+   uint64_t profiler::instructions()const {
+      uint64_t total = 0;
+      for (const auto& n : _nodes)
+         total += n.instructions;
+      return total;
+   }
+
+   uint64_t profiler::host_calls()const {
+      uint64_t total = 0;
+      for (size_t i = 1; i < _nodes.size(); i++)
+         if (_is_host[_nodes[i].func])
+            total += _nodes[i].calls;
+      return total;
+   }
+
+   uint64_t profiler::host_ns()const {
+      uint64_t total = 0;
+      for (const auto& n : _nodes)
+         total += n.host_ns;
+      return total;
+   }
+
+   std::string profiler::stack_of( uint32_t n )const {
+      std::vector<uint32_t> frames;
+      for (; n != 0; n = _nodes[n].parent)
+         frames.push_back(_nodes[n].func);
+      std::string stack;
+      for (auto itr = frames.rbegin(); itr != frames.rend(); ++itr)
+         stack += (stack.empty() ? "" : ";") + _names[*itr];
+      return stack;
+   }
+
+   template <typename Weight>
+   void profiler::write_folded( std::ostream& os, Weight weight )const {
+      for (uint32_t n = 1; n < _nodes.size(); n++)
+         if (const uint64_t w = weight(_nodes[n]))
+            os << stack_of(n) << ' ' << w << '\n';
+   }
+
+   void profiler::write_folded_instructions( std::ostream& os )const {
+      write_folded(os, [](const node& n) { return n.instructions; });
+   }
+
+   void profiler::write_folded_host_time( std::ostream& os )const {
+      write_folded(os, [](const node& n) { return n.host_ns; });
+   }
+
+   void profiler::write_summary( std::ostream& os )const {
+      std::map<uint32_t, function_stats> stats;
+      // inclusive counts of the nodes below, recursive calls are only counted at the outermost frame
+      std::vector<uint64_t> total(_nodes.size());
+      for (uint32_t n = _nodes.size() - 1; n > 0; n--) {
+         total[n] += _nodes[n].instructions;
+         total[_nodes[n].parent] += total[n];
+      }
+      for (uint32_t n = 1; n < _nodes.size(); n++) {
+         const node& nd = _nodes[n];
+         auto& s = stats[nd.func];
+         s.calls   += nd.calls;
+         s.self    += nd.instructions;
+         s.host_ns += nd.host_ns;
+         bool recursive = false;
+         for (uint32_t p = nd.parent; p != 0 && !recursive; p = _nodes[p].parent)
+            recursive = _nodes[p].func == nd.func;
+         if (!recursive)
+            s.total += total[n];
+      }
+
+      std::vector<std::pair<uint32_t, function_stats>> rows(stats.begin(), stats.end());
+      std::stable_sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+            return std::make_pair(a.second.self, a.second.host_ns) > std::make_pair(b.second.self, b.second.host_ns);
+         });
+
+      char line[256];
+      snprintf(line, sizeof(line), "%llu instructions, %llu host calls taking %llu us\n",
+               (unsigned long long)instructions(), (unsigned long long)host_calls(),
+               (unsigned long long)host_ns() / 1000);
+      os << line;
+      snprintf(line, sizeof(line), "%14s %14s %10s %10s  %s\n", "self", "total", "calls", "host us", "function");
+      os << line;
+      for (const auto& row : rows) {
+         const auto& s = row.second;
+         snprintf(line, sizeof(line), "%14llu %14llu %10llu %10.1f  ", (unsigned long long)s.self,
+                  (unsigned long long)s.total, (unsigned long long)s.calls, s.host_ns / 1000.0);
+         os << line << _names[row.first] << '\n';
+      }
+   }
+
+}} //ns eosio::cdt
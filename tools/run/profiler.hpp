@@ -0,0 +1,85 @@
+#pragma once
+#include <src/interp.h>
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   /**
+    * Counts the instructions an action executes and the time it spends in host calls, per call stack
+    *
+    * Functions are named after the name section of the contract, which eosio-ld keeps when linking with
+    * -fkeep-names. Without it they show up as func[N], imports by their field name. Counts are instructions of
+    * wabt's interpreter, which follow the wasm instructions closely and are deterministic, unlike the time.
+    */
+   class profiler : public wabt::interp::ThreadObserver {
+      public:
+         /**
+          * Read the function names of `code`, the module about to be profiled
+          */
+         explicit profiler( const std::vector<uint8_t>& code );
+
+         /**
+          * Map the functions of the instantiated module, called by the interpreter before running it
+          */
+         void start( wabt::interp::Environment& env );
+
+         void OnCall( wabt::interp::IstreamOffset func_offset, uint64_t instructions ) override;
+         void OnReturn( uint64_t instructions ) override;
+         void OnTrap( uint64_t instructions ) override;
+
+         /**
+          * Record a call of imported function `func_index` taking `ns` nanoseconds
+          */
+         void host_call( uint32_t func_index, uint64_t ns );
+
+         uint64_t instructions()const;
+         uint64_t host_calls()const;
+         uint64_t host_ns()const;
+
+         /**
+          * Write the executed instructions as folded stacks, the input format of flamegraph.pl
+          */
+         void write_folded_instructions( std::ostream& os )const;
+
+         /**
+          * Write the nanoseconds spent in host calls as folded stacks, the host function being the last frame
+          */
+         void write_folded_host_time( std::ostream& os )const;
+
+         /**
+          * Write a table of the functions by instructions executed in them and the host calls they made
+          */
+         void write_summary( std::ostream& os )const;
+
+      private:
+         // a node of the call tree, node 0 is the root above the entry functions
+         struct node {
+            uint32_t                     func         = 0;
+            uint32_t                     parent       = 0;
+            uint64_t                     calls        = 0;
+            uint64_t                     instructions = 0; ///< executed in the function itself
+            uint64_t                     host_ns      = 0; ///< for host functions, time spent in them
+            std::map<uint32_t, uint32_t> children;         ///< by function index
+         };
+
+         uint32_t child( uint32_t parent, uint32_t func );
+         void charge( uint64_t instructions );
+         std::string stack_of( uint32_t n )const;
+         template <typename Weight>
+         void write_folded( std::ostream& os, Weight weight )const;
+
+         std::vector<std::string>                        _module_names; ///< from the name section, by module function index
+         std::vector<std::string>                        _names;        ///< by environment function index
+         std::map<wabt::interp::IstreamOffset, uint32_t> _offsets;
+         std::vector<bool>                               _is_host;
+         std::vector<node>                               _nodes;
+         uint32_t                                        _current = 0;
+         uint64_t                                        _last    = 0;
+   };
+
+}} //ns eosio::cdt
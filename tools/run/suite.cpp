@@ -0,0 +1,236 @@
+#include "suite.hpp"
+
+#include <jsoncons/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace eosio { namespace cdt {
+
+   namespace {
+      using jsoncons::ojson;
+
+      // max_inline_action_depth of the default chain configuration
+      const uint32_t max_inline_depth = 4;
+
+      ojson read_json( const std::string& file ) {
+         std::ifstream in(file);
+         if (!in)
+            throw std::runtime_error("unable to read " + file);
+         try {
+            return ojson::parse(in);
+         } catch (const std::exception& e) {
+            throw std::runtime_error(file + ": " + e.what());
+         }
+      }
+
+      std::string format_stats( const apply_stats& stats ) {
+         char line[128];
+         snprintf(line, sizeof(line), "%llu instructions, %u pages, %llu intrinsic calls",
+                  (unsigned long long)stats.instructions, stats.memory_pages,
+                  (unsigned long long)stats.total_intrinsic_calls());
+         return line;
+      }
+
+      // the intrinsics whose call counts differ, `name before -> after`
+      std::string intrinsic_changes( const std::map<std::string, uint64_t>& before,
+                                     const std::map<std::string, uint64_t>& after ) {
+         std::map<std::string, std::pair<uint64_t, uint64_t>> counts;
+         for (const auto& calls : before)
+            counts[calls.first].first = calls.second;
+         for (const auto& calls : after)
+            counts[calls.first].second = calls.second;
+         std::string changes;
+         for (const auto& count : counts)
+            if (count.second.first != count.second.second)
+               changes += (changes.empty() ? "" : ", ") + count.first + " " + std::to_string(count.second.first) +
+                          " -> " + std::to_string(count.second.second);
+         return changes;
+      }
+   }
+
+   cost_suite::cost_suite( const std::string& file, const std::string& contracts_dir ) {
+      const ojson suite = read_json(file);
+      try {
+         if (suite.has_key("contracts")) {
+            for (const auto& contract : suite["contracts"].object_range()) {
+               std::string path = contract.value().as<std::string>();
+               if (path.empty() || path[0] != '/')
+                  path = contracts_dir + "/" + path;
+               const uint64_t account = string_to_name(std::string(contract.key()));
+               _contracts[account] = load_contract(path);
+               _ctx.accounts.insert(account);
+            }
+         }
+         if (suite.has_key("accounts"))
+            for (const auto& account : suite["accounts"].array_range())
+               _ctx.accounts.insert(string_to_name(account.as<std::string>()));
+         _ctx.time_us = suite.get_with_default<uint64_t>("time", uint64_t(0));
+
+         for (const auto& a : suite["actions"].array_range()) {
+            scripted_action sa;
+            sa.act.account = string_to_name(a["account"].as<std::string>());
+            sa.act.name    = string_to_name(a["action"].as<std::string>());
+            if (a.has_key("authorization"))
+               for (const auto& auth : a["authorization"].array_range())
+                  sa.act.authorization.push_back(string_to_permission_level(auth.as<std::string>()));
+            sa.act.data = from_hex(a.get_with_default<std::string>("data", ""));
+            if (a.has_key("expect"))
+               sa.expect = a["expect"].as<std::string>();
+            for (const auto& auth : sa.act.authorization)
+               _ctx.accounts.insert(auth.actor);
+            sa.name = a.get_with_default<std::string>("name", std::to_string(_actions.size()) + " " +
+                                                                name_to_string(sa.act.account) + "::" +
+                                                                name_to_string(sa.act.name));
+            _actions.push_back(std::move(sa));
+         }
+      } catch (const std::exception& e) {
+         throw std::runtime_error(file + ": " + e.what());
+      }
+   }
+
+   void cost_suite::run_action( const action& act, uint32_t depth, apply_stats& stats ) {
+      if (depth > max_inline_depth)
+         fail("max inline action depth per transaction reached");
+
+      // the receiver and everything it notified, notified contracts can notify further accounts
+      std::vector<uint64_t> receivers{act.account};
+      std::vector<action>   inline_actions;
+      for (size_t i = 0; i < receivers.size(); i++) {
+         auto contract = _contracts.find(receivers[i]);
+         if (contract == _contracts.end())
+            continue;
+         _ctx.start_action(receivers[i], act, depth);
+         contract->second->apply(_ctx, &stats);
+         for (uint64_t recipient : _ctx.notified)
+            if (std::find(receivers.begin(), receivers.end(), recipient) == receivers.end())
+               receivers.push_back(recipient);
+         inline_actions.insert(inline_actions.end(), _ctx.context_free_inline_actions.begin(),
+                               _ctx.context_free_inline_actions.end());
+         inline_actions.insert(inline_actions.end(), _ctx.inline_actions.begin(), _ctx.inline_actions.end());
+      }
+      for (const auto& inline_act : inline_actions)
+         run_action(inline_act, depth + 1, stats);
+   }
+
+   void cost_suite::run_transaction( const action& act, apply_stats& stats ) {
+      const auto rev = _ctx.db.snapshot();
+      _ctx.idx_long_double.enable_undo(true);
+      try {
+         run_action(act, 0, stats);
+      } catch (const action_failure&) {
+         _ctx.db.restore(rev);
+         _ctx.db.release(rev);
+         _ctx.idx_long_double.undo(0);
+         _ctx.idx_long_double.enable_undo(false);
+         throw;
+      }
+      _ctx.db.release(rev);
+      _ctx.idx_long_double.enable_undo(false);
+   }
+
+   std::vector<case_result> cost_suite::run() {
+      std::vector<case_result> results;
+      for (const auto& sa : _actions) {
+         case_result result;
+         result.name = sa.name;
+         try {
+            run_transaction(sa.act, result.stats);
+         } catch (const action_failure& e) {
+            result.error = e.what();
+         }
+         if (sa.expect)
+            result.passed = result.error && result.error->find(*sa.expect) != std::string::npos;
+         else
+            result.passed = !result.error;
+         results.push_back(std::move(result));
+      }
+      return results;
+   }
+
+   bool write_report( const std::vector<case_result>& results, const std::string& baseline_file, double tolerance,
+                      bool allow_missing, std::ostream& os ) {
+      const ojson baseline = baseline_file.empty() ? ojson() : read_json(baseline_file);
+      bool success = true;
+      bool improved = false;
+      bool missing = false;
+      for (const auto& result : results) {
+         os << result.name << ": " << format_stats(result.stats) << "\n";
+         if (!result.passed) {
+            os << "   FAILED: " << (result.error ? "error: " + *result.error : std::string("expected an error")) << "\n";
+            success = false;
+            continue;
+         }
+         if (baseline_file.empty())
+            continue;
+         if (!baseline.has_key(result.name)) {
+            os << (allow_missing ? "   not in the baseline\n" : "   FAILED: not in the baseline\n");
+            success = success && allow_missing;
+            missing = true;
+            continue;
+         }
+
+         const ojson& b = baseline[result.name];
+         apply_stats expected;
+         expected.instructions = b.get_with_default<uint64_t>("instructions", uint64_t(0));
+         expected.memory_pages = b.get_with_default<uint32_t>("memory_pages", uint32_t(0));
+         if (b.has_key("intrinsic_calls"))
+            for (const auto& calls : b["intrinsic_calls"].object_range())
+               expected.intrinsic_calls[std::string(calls.key())] = calls.value().as<uint64_t>();
+
+         const auto& actual = result.stats;
+         const double change = expected.instructions ?
+            100.0 * (double(actual.instructions) - double(expected.instructions)) / double(expected.instructions) : 0;
+         char line[128];
+         snprintf(line, sizeof(line), "instructions %llu -> %llu (%+.2f%%)", (unsigned long long)expected.instructions,
+                  (unsigned long long)actual.instructions, change);
+         if (actual.instructions > expected.instructions && (change > tolerance || !expected.instructions)) {
+            os << "   REGRESSION: " << line << "\n";
+            success = false;
+         } else if (actual.instructions < expected.instructions) {
+            os << "   improved: " << line << "\n";
+            improved = true;
+         }
+         if (actual.memory_pages != expected.memory_pages) {
+            const bool worse = actual.memory_pages > expected.memory_pages;
+            os << (worse ? "   REGRESSION: " : "   improved: ") << "memory pages " << expected.memory_pages
+               << " -> " << actual.memory_pages << "\n";
+            success = success && !worse;
+            improved = improved || !worse;
+         }
+         const std::string changes = intrinsic_changes(expected.intrinsic_calls, actual.intrinsic_calls);
+         if (!changes.empty()) {
+            const bool worse = actual.total_intrinsic_calls() > expected.total_intrinsic_calls();
+            os << (worse ? "   REGRESSION: " : "   changed: ") << "intrinsic calls " << changes << "\n";
+            success = success && !worse;
+            improved = improved || !worse;
+         }
+      }
+      if (improved)
+         os << "costs went down, record them with --update-baseline\n";
+      if (missing)
+         os << "record the actions missing from the baseline with --update-baseline\n";
+      return success;
+   }
+
+   void write_baseline( const std::vector<case_result>& results, const std::string& file ) {
+      ojson baseline;
+      for (const auto& result : results) {
+         ojson costs;
+         costs["instructions"] = result.stats.instructions;
+         costs["memory_pages"] = result.stats.memory_pages;
+         ojson calls;
+         for (const auto& count : result.stats.intrinsic_calls)
+            calls[count.first] = count.second;
+         costs["intrinsic_calls"] = std::move(calls);
+         baseline[result.name] = std::move(costs);
+      }
+      std::ofstream os(file);
+      os << jsoncons::pretty_print(baseline) << "\n";
+      if (!os)
+         throw std::runtime_error("unable to write " + file);
+   }
+
+}} //ns eosio::cdt
@@ -0,0 +1,83 @@
+#pragma once
+#include "engine.hpp"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   /**
+    * What one scripted action cost, over the receiver, the accounts it notified and the inline actions it sent
+    */
+   struct case_result {
+      std::string                name;
+      apply_stats                stats;
+      std::optional<std::string> error;  ///< why the transaction failed, if it did
+      bool                       passed = false; ///< failed exactly when the suite expected it to
+   };
+
+   /**
+    * A script of actions run one after the other against compiled contracts, sharing one chain state
+    *
+    * The suite file is JSON:
+    * @code
+    * {
+    *    "contracts": { "hello": "hello.wasm" },
+    *    "accounts": [ "alice" ],
+    *    "time": 1546300800000000,
+    *    "actions": [
+    *       { "name": "hi alice", "account": "hello", "action": "hi", "authorization": ["alice@active"],
+    *         "data": "0000000000855c34" },
+    *       { "account": "hello", "action": "hi", "data": "0000000000855c34", "expect": "missing authority" }
+    *    ]
+    * }
+    * @endcode
+    * Each action runs as a transaction of its own: the receiver, then the accounts it notified, then its inline
+    * actions depth first, like nodeos does. A failing transaction leaves the chain state untouched, `expect`
+    * marks an action that must fail with an error containing the given text.
+    */
+   class cost_suite {
+      public:
+         /**
+          * Read the suite in `file`, contract paths are relative to `contracts_dir`, throws std::runtime_error
+          * if the suite or one of its contracts can not be read
+          */
+         cost_suite( const std::string& file, const std::string& contracts_dir );
+
+         std::vector<case_result> run();
+
+      private:
+         struct scripted_action {
+            std::string                name;
+            action                     act;
+            std::optional<std::string> expect;
+         };
+
+         void run_transaction( const action& act, apply_stats& stats );
+         void run_action( const action& act, uint32_t depth, apply_stats& stats );
+
+         std::map<uint64_t, std::unique_ptr<engine>> _contracts;
+         std::vector<scripted_action>                 _actions;
+         apply_context                                _ctx;
+   };
+
+   /**
+    * Print the cost of every case to `os`, compared against the baseline in `baseline_file` unless it is empty
+    *
+    * A case regresses when it executes more than `tolerance` percent more instructions than the baseline, grows
+    * the memory or makes more intrinsic calls. Returns false on a regression, a case that did not pass or, unless
+    * `allow_missing` is set, a case missing from the baseline.
+    */
+   bool write_report( const std::vector<case_result>& results, const std::string& baseline_file, double tolerance,
+                      bool allow_missing, std::ostream& os );
+
+   /**
+    * Write the results as the new baseline to `file`
+    */
+   void write_baseline( const std::vector<case_result>& results, const std::string& file );
+
+}} //ns eosio::cdt